@@ -43,17 +43,43 @@ class animation_hook : public wf::custom_data_t
         }
     }
 
-    /* Update animation right before each frame */
-    wf::effect_hook_t update_animation_hook = [=] ()
+    /**
+     * Add the area covered by the view (and its unmapped snapshot) to @damage, in output-local coordinates.
+     */
+    void collect_view_damage(wf::regionf_t& damage)
+    {
+        damage |= view->get_transformed_node()->get_bounding_box();
+        if (unmapped_contents)
+        {
+            damage |= unmapped_contents->get_bounding_box();
+        }
+    }
+
+    /* Update animation right before each frame, together with all other animations on the output */
+    wf::animation_tick_t update_animation_hook = [=] (const wf::animation_frame_t& frame)
     {
-        damage_whole_view();
+        // The old and new areas of all animated views are damaged together after the tick.
+        auto damage = [&]
+        {
+            if (frame.damage)
+            {
+                collect_view_damage(*frame.damage);
+            } else
+            {
+                damage_whole_view();
+            }
+        };
+
+        damage();
         bool result = animation->step();
-        damage_whole_view();
+        damage();
 
         if (!result)
         {
             stop_hook(false);
         }
+
+        return result;
     };
 
     /**
@@ -64,13 +90,12 @@ class animation_hook : public wf::custom_data_t
     {
         if (current_output)
         {
-            current_output->render->rem_effect(&update_animation_hook);
+            current_output->render->rem_animation(&update_animation_hook);
         }
 
         if (new_output)
         {
-            new_output->render->add_effect(&update_animation_hook,
-                wf::OUTPUT_EFFECT_PRE);
+            new_output->render->add_animation(&update_animation_hook);
         }
 
         current_output = new_output;
@@ -12,11 +12,6 @@
 #include <wayfire/core.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
-static wf::option_wrapper_t<int> fire_particles{"animate/fire_particles"};
-static wf::option_wrapper_t<double> fire_particle_size{"animate/fire_particle_size"};
-static wf::option_wrapper_t<bool> random_fire_color{"animate/random_fire_color"};
-static wf::option_wrapper_t<wf::color_t> fire_color{"animate/fire_color"};
-
 // generate a random float between s and e
 static float random(float s, float e)
 {
@@ -25,15 +20,13 @@ static float random(float s, float e)
     return (s * r + (1 - r) * e);
 }
 
-static int particle_count_for_width(int width)
-{
-    int particles = fire_particles;
-
-    return particles * std::min(width / 400.0, 3.5);
-}
-
 class fire_node_t : public wf::scene::floating_inner_node_t
 {
+    wf::option_wrapper_t<int> fire_particles{"animate/fire_particles"};
+    wf::option_wrapper_t<double> fire_particle_size{"animate/fire_particle_size"};
+    wf::option_wrapper_t<bool> random_fire_color{"animate/random_fire_color"};
+    wf::option_wrapper_t<wf::color_t> fire_color{"animate/fire_color"};
+
   public:
     std::unique_ptr<ParticleSystem> ps;
     fire_node_t() : floating_inner_node_t(false)
@@ -46,7 +39,14 @@ class fire_node_t : public wf::scene::floating_inner_node_t
         });
     }
 
-    static void init_particle_with_node(Particle& p,
+    int particle_count_for_width(int width)
+    {
+        int particles = fire_particles;
+
+        return particles * std::min(width / 400.0, 3.5);
+    }
+
+    void init_particle_with_node(Particle& p,
         wf::geometry_t bounding_box, double progress)
     {
         p.life = 1;
@@ -265,7 +265,7 @@ bool FireAnimation::step()
     }
 
     transformer->ps->update();
-    transformer->ps->resize(particle_count_for_width(
+    transformer->ps->resize(transformer->particle_count_for_width(
         transformer->get_children_bounding_box().width));
     return this->progression.running() || transformer->ps->statistic();
 }
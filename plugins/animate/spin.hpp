@@ -29,9 +29,6 @@
 #include <wayfire/view-transform.hpp>
 #include <wayfire/output.hpp>
 
-
-wf::option_wrapper_t<int> spin_rotations{"animate/spin_rotations"};
-
 namespace wf
 {
 namespace spin
@@ -48,6 +45,7 @@ class spin_animation : public animate::animation_base_t
     wayfire_view view;
     animate::animation_type type;
     wf::spin::spin_animation_t progression;
+    wf::option_wrapper_t<int> spin_rotations{"animate/spin_rotations"};
 
   public:
 
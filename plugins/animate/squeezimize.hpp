@@ -383,6 +383,12 @@ class squeezimize_transformer : public wf::scene::view_2d_transformer_t
         return this->animation_geometry;
     }
 
+    wf::regionf_t get_opaque_region() const override
+    {
+        // The view is distorted, we do not know which parts remain opaque.
+        return {};
+    }
+
     void gen_render_instances(std::vector<render_instance_uptr>& instances,
         damage_callback push_damage, wf::output_t *shown_on) override
     {
@@ -6,38 +6,66 @@
 #include <wayfire/opengl.hpp>
 #include <wayfire/render-manager.hpp>
 #include <wayfire/util/duration.hpp>
+#include <algorithm>
 
 /* animates wake from suspend/startup by fading in the whole output */
 class wf_system_fade
 {
-    wf::animation::simple_animation_t progression;
+    wf::animation_description_t duration;
+    // Predicted presentation time of the first frame of the fade, or -1 before the first tick.
+    int64_t start_nsec = -1;
+    // The opacity of the black overlay in the frame being rendered.
+    double alpha = 1.0;
+    bool done    = false;
 
     wf::output_t *output;
 
-    wf::effect_hook_t damage_hook, render_hook;
+    wf::animation_tick_t tick_hook;
+    wf::effect_hook_t render_hook;
 
   public:
     wf_system_fade(wf::output_t *out, wf::animation_description_t dur) :
-        progression(wf::create_option<wf::animation_description_t>(dur)), output(out)
+        duration(dur), output(out)
     {
-        damage_hook = [=] ()
-        { output->render->damage_whole(); };
+        tick_hook = [=] (const wf::animation_frame_t& frame)
+        {
+            return tick(frame);
+        };
 
         render_hook = [=] ()
         { render(); };
 
-        output->render->add_effect(&damage_hook, wf::OUTPUT_EFFECT_PRE);
+        output->render->add_animation(&tick_hook);
         output->render->add_effect(&render_hook, wf::OUTPUT_EFFECT_OVERLAY);
-        output->render->set_redraw_always();
-        this->progression.animate(1, 0);
+    }
+
+    /**
+     * Compute the opacity for the frame from its predicted presentation time, so that the fade advances
+     * evenly even if frames start late.
+     */
+    bool tick(const wf::animation_frame_t& frame)
+    {
+        if (start_nsec < 0)
+        {
+            start_nsec = frame.presentation_time_nsec;
+        }
+
+        const double length_nsec = std::max(1, duration.length_ms) * 1'000'000.0;
+        const double t = std::clamp((frame.presentation_time_nsec - start_nsec) / length_nsec, 0.0, 1.0);
+        alpha = 1.0 - (duration.easing ? duration.easing(t) : t);
+        done  = (t >= 1.0);
+
+        output->render->damage_whole();
+        // The last frame is still rendered (fully transparent), after which the fade removes itself.
+        return !done;
     }
 
     void render()
     {
-        wf::color_t color{0, 0, 0, this->progression};
+        wf::color_t color{0, 0, 0, alpha};
         auto fb = output->render->get_target_framebuffer();
         output->render->get_current_pass()->add_rect(color, fb, fb.geometry, fb.geometry);
-        if (!progression.running())
+        if (done)
         {
             finish();
         }
@@ -45,9 +73,8 @@ class wf_system_fade
 
     void finish()
     {
-        output->render->rem_effect(&damage_hook);
+        output->render->rem_animation(&tick_hook);
         output->render->rem_effect(&render_hook);
-        output->render->set_redraw_always(false);
 
         delete this;
     }
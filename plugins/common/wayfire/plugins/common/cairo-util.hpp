@@ -3,6 +3,11 @@
 #include "wayfire/core.hpp"
 #include "wayfire/geometry.hpp"
 #include <string>
+#include <list>
+#include <map>
+#include <tuple>
+#include <vector>
+#include <functional>
 #include <wayfire/config/types.hpp>
 #include <cairo.h>
 #include <pango/pango.h>
@@ -67,6 +72,13 @@ struct owned_texture_t
         this->texture = wf::texture_t::from_texture(new_tex);
     }
 
+    // Shares an existing texture, for ex. one from raster_cache_t.
+    owned_texture_t(std::shared_ptr<wf::texture_t> texture, wf::dimensions_t size)
+    {
+        this->texture = texture;
+        this->size    = size;
+    }
+
     owned_texture_t(cairo_surface_t *surface)
     {
         int width  = cairo_image_surface_get_width(surface);
@@ -102,6 +114,123 @@ struct owned_texture_t
     wf::dimensions_t size = {0, 0};
 };
 
+/**
+ * The parameters which fully determine the contents of a rasterized text or icon.
+ */
+struct raster_key_t
+{
+    /** What is being rasterized, for ex. "decoration-title" or "decoration-button". */
+    std::string kind;
+    std::string text;
+    std::string font;
+    wf::dimensions_t size = {0, 0};
+    double scale = 1.0;
+    wf::color_t color = {0, 0, 0, 0};
+    /** Any other parameters which affect the result. */
+    std::vector<double> extra;
+
+    bool operator <(const raster_key_t& other) const
+    {
+        return std::tie(kind, text, font, size.width, size.height, scale,
+            color.r, color.g, color.b, color.a, extra) <
+               std::tie(other.kind, other.text, other.font, other.size.width, other.size.height, other.scale,
+            other.color.r, other.color.g, other.color.b, other.color.a, other.extra);
+    }
+};
+
+/**
+ * A cache of textures rasterized with cairo (text, decoration buttons, etc.), shared between plugins via
+ * wf::shared_data::ref_ptr_t<raster_cache_t>.
+ *
+ * Many views show the same title or the same icons, and titles often change back and forth between a few
+ * values (for ex. a terminal running a command). With the cache, each of them is rasterized and uploaded
+ * to the GPU only once. The least recently used entries are dropped when the cache grows beyond its limits.
+ * Textures which are still in use stay alive after being dropped.
+ */
+class raster_cache_t
+{
+  public:
+    struct entry_t
+    {
+        std::shared_ptr<wf::texture_t> texture;
+        /** The size of the texture in pixels. */
+        wf::dimensions_t size = {0, 0};
+        /** Additional size information reported by the rasterizer, for ex. the size of the uncropped text. */
+        wf::dimensions_t logical_size = {0, 0};
+    };
+
+    /**
+     * A function which draws the contents for a key. It returns a new surface, whose ownership is passed to
+     * the cache, and may set the logical size of the result (by default, the size of the surface).
+     */
+    using rasterizer_t = std::function<cairo_surface_t*(wf::dimensions_t& logical_size)>;
+
+    static constexpr size_t max_entries = 512;
+    static constexpr size_t max_bytes   = 32 * 1024 * 1024;
+
+    /**
+     * Get the texture for the given key, calling @rasterize and uploading the result only on a cache miss.
+     */
+    entry_t get(const raster_key_t& key, const rasterizer_t& rasterize)
+    {
+        auto it = index.find(key);
+        if (it != index.end())
+        {
+            lru.splice(lru.begin(), lru, it->second);
+            return it->second->second;
+        }
+
+        entry_t entry;
+        entry.logical_size = {-1, -1};
+        cairo_surface_t *surface = rasterize(entry.logical_size);
+        entry.size = {cairo_image_surface_get_width(surface), cairo_image_surface_get_height(surface)};
+        if (entry.logical_size.width < 0)
+        {
+            entry.logical_size = entry.size;
+        }
+
+        cairo_surface_flush(surface);
+        owned_texture_t uploaded{surface};
+        cairo_surface_destroy(surface);
+        entry.texture = uploaded.get_texture();
+
+        lru.emplace_front(key, entry);
+        index[key]  = lru.begin();
+        used_bytes += entry_bytes(entry);
+        evict();
+
+        return entry;
+    }
+
+    void clear()
+    {
+        index.clear();
+        lru.clear();
+        used_bytes = 0;
+    }
+
+  private:
+    std::list<std::pair<raster_key_t, entry_t>> lru;
+    std::map<raster_key_t, decltype(lru)::iterator> index;
+    size_t used_bytes = 0;
+
+    static size_t entry_bytes(const entry_t& entry)
+    {
+        return 4ul * entry.size.width * entry.size.height;
+    }
+
+    void evict()
+    {
+        // Always keep the most recent entry, even if it alone exceeds the budget.
+        while ((lru.size() > 1) && ((lru.size() > max_entries) || (used_bytes > max_bytes)))
+        {
+            used_bytes -= entry_bytes(lru.back().second);
+            index.erase(lru.back().first);
+            lru.pop_back();
+        }
+    }
+};
+
 /**
  * Simple wrapper around rendering text with Cairo. This object can be
  * kept around to avoid reallocation of the cairo surface and OpenGL
@@ -151,113 +280,55 @@ struct cairo_text_t
      *
      * @param text         text to render
      * @param par          parameters for rendering
+     * @param cache        optional cache to take the result from, if the same
+     *                     text was already rendered with the same parameters
      *
      * @return The size needed to render in scaled coordinates. If this is larger
      *   than the size of tex, it means the result was cropped (due to the constraint
      *   given in par.max_size). If it is smaller, than the result is centered along
      *   that dimension.
      */
-    wf::dimensions_t render_text(const std::string& text, const params& par)
+    wf::dimensions_t render_text(const std::string& text, const params& par,
+        raster_cache_t *cache = nullptr)
     {
-        if (!cr)
-        {
-            /* create with default size */
-            cairo_create_surface();
-        }
-
-        PangoFontDescription *font_desc;
-        PangoLayout *layout;
-        PangoRectangle extents;
-        /* TODO: font properties could be made parameters! */
-        font_desc = pango_font_description_from_string("sans-serif bold");
-        pango_font_description_set_absolute_size(font_desc,
-            par.font_size * par.output_scale * PANGO_SCALE);
-        layout = pango_cairo_create_layout(cr);
-        pango_layout_set_font_description(layout, font_desc);
-        pango_layout_set_text(layout, text.c_str(), text.size());
-        pango_layout_get_extents(layout, NULL, &extents);
-
-        double xpad = par.bg_rect ? 10.0 * par.output_scale : 0.0;
-        double ypad = par.bg_rect ?
-            0.2 * ((float)extents.height / PANGO_SCALE) : 0.0;
-        int w = (int)((float)extents.width / PANGO_SCALE + 2 * xpad);
-        int h = (int)((float)extents.height / PANGO_SCALE + 2 * ypad);
-        wf::dimensions_t ret = {w, h};
-        if (par.max_size.width && (w > par.max_size.width * par.output_scale))
-        {
-            w = (int)std::floor(par.max_size.width * par.output_scale);
-        }
-
-        if (par.max_size.height && (h > par.max_size.height * par.output_scale))
+        if (!cache)
         {
-            h = (int)std::floor(par.max_size.height * par.output_scale);
+            auto ret = draw_text(text, par);
+            this->tex = owned_texture_t{surface};
+            return ret;
         }
 
-        if ((w != surface_size.width) || (h != surface_size.height))
+        raster_key_t key;
+        key.kind = "cairo-text";
+        key.text = text;
+        key.font = "sans-serif bold";
+        /* without exact_size, the result depends on the size of the current surface */
+        key.size  = par.exact_size ? wf::dimensions_t{0, 0} : surface_size;
+        key.scale = par.output_scale;
+        key.color = par.text_color;
+        key.extra = {
+            (double)par.font_size,
+            par.bg_color.r, par.bg_color.g, par.bg_color.b, par.bg_color.a,
+            (double)par.max_size.width, (double)par.max_size.height,
+            (double)par.bg_rect, (double)par.rounded_rect, (double)par.exact_size,
+        };
+
+        auto entry = cache->get(key, [&] (wf::dimensions_t& logical_size)
         {
-            if (par.exact_size || (w > surface_size.width) || (h > surface_size.height))
-            {
-                cairo_create_surface({w, h});
-            }
-        }
-
-        cairo_set_operator(cr, CAIRO_OPERATOR_CLEAR);
-        cairo_paint(cr);
-
-        int x = (surface_size.width - w) / 2;
-        int y = (surface_size.height - h) / 2;
+            logical_size = draw_text(text, par);
+            /* the cache drops its reference once the texture is uploaded */
+            return cairo_surface_reference(surface);
+        });
 
-        if (par.bg_rect)
+        if (entry.size != surface_size)
         {
-            int min_r = (int)(20 * par.output_scale);
-            int r     = par.rounded_rect ? (h > min_r ? min_r : (h - 2) / 2) : 0;
-
-            cairo_move_to(cr, x + r, y);
-            cairo_line_to(cr, x + w - r, y);
-            if (par.rounded_rect)
-            {
-                cairo_curve_to(cr, x + w, y, x + w, y, x + w, y + r);
-            }
-
-            cairo_line_to(cr, x + w, y + h - r);
-            if (par.rounded_rect)
-            {
-                cairo_curve_to(cr, x + w, y + h, x + w, y + h, x + w - r, y + h);
-            }
-
-            cairo_line_to(cr, x + r, y + h);
-            if (par.rounded_rect)
-            {
-                cairo_curve_to(cr, x, y + h, x, y + h, x, y + h - r);
-            }
-
-            cairo_line_to(cr, x, y + r);
-            if (par.rounded_rect)
-            {
-                cairo_curve_to(cr, x, y, x, y, x + r, y);
-            }
-
-            cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
-            cairo_set_source_rgba(cr, par.bg_color.r, par.bg_color.g,
-                par.bg_color.b, par.bg_color.a);
-            cairo_fill(cr);
+            /* the surface is recreated with the right size on the next cache miss */
+            cairo_free();
+            surface_size = entry.size;
         }
 
-        x += xpad;
-        y += ypad;
-
-        cairo_set_operator(cr, par.bg_rect ? CAIRO_OPERATOR_OVER : CAIRO_OPERATOR_SOURCE);
-        cairo_move_to(cr, x - (float)extents.x / PANGO_SCALE, y);
-        cairo_set_source_rgba(cr, par.text_color.r, par.text_color.g,
-            par.text_color.b, par.text_color.a);
-
-        pango_cairo_show_layout(cr, layout);
-        pango_font_description_free(font_desc);
-        g_object_unref(layout);
-
-        cairo_surface_flush(surface);
-        this->tex = owned_texture_t{surface};
-        return ret;
+        this->tex = owned_texture_t{entry.texture, entry.size};
+        return entry.logical_size;
     }
 
     cairo_text_t() = default;
@@ -361,6 +432,115 @@ struct cairo_text_t
         cr = cairo_create(surface);
     }
 
+    /* Draw the text on the cairo surface, see render_text() */
+    wf::dimensions_t draw_text(const std::string& text, const params& par)
+    {
+        if (!cr)
+        {
+            /* create with default size, or with the size of the last cached result */
+            if ((surface_size.width > 0) && (surface_size.height > 0))
+            {
+                cairo_create_surface(surface_size);
+            } else
+            {
+                cairo_create_surface();
+            }
+        }
+
+        PangoFontDescription *font_desc;
+        PangoLayout *layout;
+        PangoRectangle extents;
+        /* TODO: font properties could be made parameters! */
+        font_desc = pango_font_description_from_string("sans-serif bold");
+        pango_font_description_set_absolute_size(font_desc,
+            par.font_size * par.output_scale * PANGO_SCALE);
+        layout = pango_cairo_create_layout(cr);
+        pango_layout_set_font_description(layout, font_desc);
+        pango_layout_set_text(layout, text.c_str(), text.size());
+        pango_layout_get_extents(layout, NULL, &extents);
+
+        double xpad = par.bg_rect ? 10.0 * par.output_scale : 0.0;
+        double ypad = par.bg_rect ?
+            0.2 * ((float)extents.height / PANGO_SCALE) : 0.0;
+        int w = (int)((float)extents.width / PANGO_SCALE + 2 * xpad);
+        int h = (int)((float)extents.height / PANGO_SCALE + 2 * ypad);
+        wf::dimensions_t ret = {w, h};
+        if (par.max_size.width && (w > par.max_size.width * par.output_scale))
+        {
+            w = (int)std::floor(par.max_size.width * par.output_scale);
+        }
+
+        if (par.max_size.height && (h > par.max_size.height * par.output_scale))
+        {
+            h = (int)std::floor(par.max_size.height * par.output_scale);
+        }
+
+        if ((w != surface_size.width) || (h != surface_size.height))
+        {
+            if (par.exact_size || (w > surface_size.width) || (h > surface_size.height))
+            {
+                cairo_create_surface({w, h});
+            }
+        }
+
+        cairo_set_operator(cr, CAIRO_OPERATOR_CLEAR);
+        cairo_paint(cr);
+
+        int x = (surface_size.width - w) / 2;
+        int y = (surface_size.height - h) / 2;
+
+        if (par.bg_rect)
+        {
+            int min_r = (int)(20 * par.output_scale);
+            int r     = par.rounded_rect ? (h > min_r ? min_r : (h - 2) / 2) : 0;
+
+            cairo_move_to(cr, x + r, y);
+            cairo_line_to(cr, x + w - r, y);
+            if (par.rounded_rect)
+            {
+                cairo_curve_to(cr, x + w, y, x + w, y, x + w, y + r);
+            }
+
+            cairo_line_to(cr, x + w, y + h - r);
+            if (par.rounded_rect)
+            {
+                cairo_curve_to(cr, x + w, y + h, x + w, y + h, x + w - r, y + h);
+            }
+
+            cairo_line_to(cr, x + r, y + h);
+            if (par.rounded_rect)
+            {
+                cairo_curve_to(cr, x, y + h, x, y + h, x, y + h - r);
+            }
+
+            cairo_line_to(cr, x, y + r);
+            if (par.rounded_rect)
+            {
+                cairo_curve_to(cr, x, y, x, y, x + r, y);
+            }
+
+            cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+            cairo_set_source_rgba(cr, par.bg_color.r, par.bg_color.g,
+                par.bg_color.b, par.bg_color.a);
+            cairo_fill(cr);
+        }
+
+        x += xpad;
+        y += ypad;
+
+        cairo_set_operator(cr, par.bg_rect ? CAIRO_OPERATOR_OVER : CAIRO_OPERATOR_SOURCE);
+        cairo_move_to(cr, x - (float)extents.x / PANGO_SCALE, y);
+        cairo_set_source_rgba(cr, par.text_color.r, par.text_color.g,
+            par.text_color.b, par.text_color.a);
+
+        pango_cairo_show_layout(cr, layout);
+        pango_font_description_free(font_desc);
+        g_object_unref(layout);
+
+        cairo_surface_flush(surface);
+        return ret;
+    }
+
     owned_texture_t tex;
 };
 }
@@ -2,6 +2,7 @@
 #include "wayfire/scene.hpp"
 #include <wayfire/scene-render.hpp>
 #include <wayfire/plugins/common/cairo-util.hpp>
+#include <wayfire/plugins/common/shared-core-data.hpp>
 
 class simple_text_node_t : public wf::scene::node_t
 {
@@ -52,11 +53,12 @@ class simple_text_node_t : public wf::scene::node_t
     void set_text(std::string text)
     {
         wf::scene::damage_node(this->shared_from_this(), get_bounding_box());
-        cr_text.render_text(text, params);
+        cr_text.render_text(text, params, raster_cache.get());
         wf::scene::damage_node(this->shared_from_this(), get_bounding_box());
     }
 
   private:
+    wf::shared_data::ref_ptr_t<wf::raster_cache_t> raster_cache;
     wf::cairo_text_t::params params;
     std::optional<wf::dimensions_t> size;
     wf::pointf_t position;
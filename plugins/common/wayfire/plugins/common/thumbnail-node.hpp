@@ -0,0 +1,202 @@
+#pragma once
+
+#include <wayfire/view-transform.hpp>
+#include <wayfire/util.hpp>
+#include <algorithm>
+
+namespace wf
+{
+/**
+ * A transformer node which renders a view as a downscaled, rate-limited thumbnail.
+ *
+ * Plugins like scale and switcher show many views at once, most of them scaled down and not in focus. Without
+ * this node, every commit of every view causes the view to be re-rendered at full resolution and then scaled
+ * down by the plugin's transformer. The thumbnail node instead:
+ *
+ * - renders its children into a buffer of (roughly) the displayed size, see set_display_scale(). The scale is
+ *   rounded up to a power of two, so that animations do not reallocate the buffer every frame and so that
+ *   the final sampling never shrinks the buffer by more than a factor of two (i.e. bilinear filtering is
+ *   enough, the buffer acts as a single level of a mipmap chain).
+ * - limits how often the buffer is refreshed, see set_max_refresh_rate(). Damage which arrives in between is
+ *   collected and applied at the next allowed refresh. Until then, and for idle views, the last snapshot is
+ *   reused as is.
+ *
+ * The node does not transform its children, so it should be added below the plugin's own transformer (with a
+ * smaller z order). view_2d_transformer_t and view_3d_transformer_t draw the thumbnail directly, without an
+ * additional intermediate buffer.
+ */
+class thumbnail_node_t : public wf::scene::transformer_base_node_t
+{
+  public:
+    thumbnail_node_t() : transformer_base_node_t(false)
+    {}
+
+    std::string stringify() const override
+    {
+        return "thumbnail";
+    }
+
+    wf::geometry_t get_bounding_box() override
+    {
+        return get_children_bounding_box();
+    }
+
+    /**
+     * Set the scale at which the thumbnail is displayed, relative to the view's normal size.
+     */
+    void set_display_scale(float scale)
+    {
+        float quantized = 1.0f;
+        while ((quantized > min_display_scale) && (quantized / 2 >= scale))
+        {
+            quantized /= 2;
+        }
+
+        this->buffer_scale_hint = quantized;
+    }
+
+    /**
+     * Set the maximal number of times per second the thumbnail is refreshed. 0 means no limit.
+     */
+    void set_max_refresh_rate(int hz)
+    {
+        this->max_refresh_rate = std::max(hz, 0);
+    }
+
+    /**
+     * Get the minimal time between two refreshes of the thumbnail in milliseconds, or 0 if not limited.
+     */
+    int64_t get_refresh_interval() const
+    {
+        return max_refresh_rate > 0 ? 1000 / max_refresh_rate : 0;
+    }
+
+    void gen_render_instances(std::vector<wf::scene::render_instance_uptr>& instances,
+        wf::scene::damage_callback push_damage, wf::output_t *shown_on) override;
+
+    // The time of the last refresh of the thumbnail, see get_current_time().
+    int64_t last_refresh = 0;
+
+  private:
+    static constexpr float min_display_scale = 0.125f;
+
+    int max_refresh_rate = 0;
+};
+
+class thumbnail_render_instance_t : public wf::scene::transformer_render_instance_t<thumbnail_node_t>
+{
+    wf::scene::damage_callback push_damage_parent;
+    // Damage which was not yet propagated to the parent because of the refresh rate limit.
+    wf::regionf_t pending_damage;
+    wf::wl_timer<false> refresh_timer;
+
+    int64_t time_until_refresh() const
+    {
+        return self->last_refresh + self->get_refresh_interval() - wf::get_current_time();
+    }
+
+    void flush_damage()
+    {
+        auto damage = std::move(pending_damage);
+        pending_damage.clear();
+        push_damage_parent(damage);
+    }
+
+    void throttle_damage(const wf::regionf_t& damage)
+    {
+        if (self->get_refresh_interval() == 0)
+        {
+            push_damage_parent(damage);
+            return;
+        }
+
+        pending_damage |= damage;
+        if (refresh_timer.is_connected())
+        {
+            return;
+        }
+
+        const int64_t wait = time_until_refresh();
+        if (wait <= 0)
+        {
+            flush_damage();
+        } else
+        {
+            refresh_timer.set_timeout(wait, [=] () { flush_damage(); });
+        }
+    }
+
+    bool can_reuse_snapshot(float scale)
+    {
+        if (!self->inner_content.get_buffer())
+        {
+            return false;
+        }
+
+        // The same size as transformer_base_node_t::get_updated_contents() would allocate.
+        auto bbox = self->get_children_bounding_box();
+        const float buffer_scale = scale * std::clamp(self->buffer_scale_hint, 0.01f, 1.0f);
+        const auto wanted = wf::auxilliary_buffer_t::get_allocation_size(wf::dimensions(bbox), buffer_scale);
+
+        if (self->inner_content.get_size() != wanted)
+        {
+            return false;
+        }
+
+        return self->cached_damage.empty() || (time_until_refresh() > 0);
+    }
+
+  public:
+    thumbnail_render_instance_t(thumbnail_node_t *self, wf::scene::damage_callback push_damage,
+        wf::output_t *shown_on) : transformer_render_instance_t(self, push_damage, shown_on)
+    {
+        this->push_damage_parent = push_damage;
+        // Damage from the children is routed through _push_damage, see regen_instances().
+        this->_push_damage = [=] (const wf::regionf_t& damage) { throttle_damage(damage); };
+    }
+
+    /**
+     * Get the current thumbnail, refreshing it only if the refresh rate allows it.
+     */
+    std::shared_ptr<wf::texture_t> get_thumbnail(float scale)
+    {
+        if (self->buffer_scale_hint >= 1.0f)
+        {
+            // Full-size thumbnail, nothing to save.
+            return get_texture(scale);
+        }
+
+        if (can_reuse_snapshot(scale))
+        {
+            return wf::texture_t::from_aux(self->inner_content);
+        }
+
+        self->last_refresh = wf::get_current_time();
+        return self->get_updated_contents(self->get_children_bounding_box(), scale, children, _shown_on);
+    }
+
+    std::shared_ptr<wf::texture_t> get_fused_texture(float scale, glm::mat4& transform,
+        glm::vec4& color, wf::geometry_t& bbox) override
+    {
+        // The thumbnail does not transform its children, so the parent can draw it directly.
+        bbox = self->get_children_bounding_box();
+        return get_thumbnail(scale);
+    }
+
+    void render(const wf::scene::render_instruction_t& data) override
+    {
+        auto tex = get_thumbnail(data.target.scale);
+        data.pass->add_texture(tex, data.target, self->get_bounding_box(), data.damage);
+    }
+};
+
+inline void thumbnail_node_t::gen_render_instances(std::vector<wf::scene::render_instance_uptr>& instances,
+    wf::scene::damage_callback push_damage, wf::output_t *shown_on)
+{
+    auto uptr = std::make_unique<thumbnail_render_instance_t>(this, push_damage, shown_on);
+    if (uptr->has_instances())
+    {
+        instances.push_back(std::move(uptr));
+    }
+}
+}
@@ -11,6 +11,7 @@
 #include "wayfire/scene.hpp"
 #include "wayfire/signal-provider.hpp"
 #include "wayfire/output.hpp"
+#include "wayfire/util.hpp"
 
 namespace wf
 {
@@ -111,6 +112,30 @@ class workspace_wall_t : public wf::signal::provider_t
      */
     void set_ws_dim(const wf::point_t& ws, float value);
 
+    /**
+     * Keep low-resolution snapshots of all workspaces up to date while the wall is not rendered, so that
+     * start_output_renderer() can show them right away instead of rendering every workspace from scratch.
+     * The snapshots are refreshed from the damage accumulated since the last refresh a few times per
+     * second.
+     *
+     * @param max_bytes The memory budget for the snapshots of all workspaces together. Their resolution is
+     *   chosen so that they fit in it. 0 (the default) disables background caching.
+     */
+    void set_background_cache_budget(size_t max_bytes);
+
+    /**
+     * Compute the scale of background snapshots relative to the full workspace resolution, so that the
+     * snapshots of all workspaces fit in @budget bytes.
+     *
+     * @param screen_size The logical size of a workspace.
+     * @param output_scale The scale of the output.
+     * @param grid_size The size of the workspace grid.
+     * @param bytes_per_pixel The memory used per pixel by the snapshot buffers.
+     * @return The scale, or 0 if the snapshots would be too blurry to be useful or @budget is 0.
+     */
+    static float compute_background_cache_scale(size_t budget, wf::dimensions_t screen_size,
+        float output_scale, wf::dimensions_t grid_size, size_t bytes_per_pixel);
+
   protected:
     wf::output_t *output;
 
@@ -127,6 +152,26 @@ class workspace_wall_t : public wf::signal::provider_t
 
   protected:
     class workspace_wall_node_t;
+    // The node is kept while the wall is not rendered if background caching is enabled.
     std::shared_ptr<workspace_wall_node_t> render_node;
+    bool render_node_active = false;
+
+    static constexpr int background_refresh_interval = 250;
+    size_t background_cache_budget = 0;
+    std::vector<scene::render_instance_uptr> background_instances;
+    wf::wl_timer<false> background_refresh;
+    wf::signal::connection_t<scene::root_node_update_signal> on_root_node_updated;
+
+    /**
+     * Get the scale of the background snapshots relative to the full workspace resolution, or 0 if
+     * background caching is disabled.
+     */
+    float get_background_cache_scale() const;
+    /**
+     * Get the hints used for allocating the workspace buffers.
+     */
+    wf::buffer_allocation_hints_t get_buffer_hints() const;
+    void start_background_cache();
+    void schedule_background_refresh();
 };
 }
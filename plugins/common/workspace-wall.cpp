@@ -8,6 +8,7 @@
 #include "wayfire/core.hpp"
 
 #include <glm/gtc/matrix_transform.hpp>
+#include <cmath>
 
 namespace wf
 {
@@ -54,6 +55,12 @@ class workspace_wall_t::workspace_wall_node_t : public scene::node_t
                     {
                         // Store the damage because we'll have to update the buffers
                         self->aux_buffer_damage[i][j] |= damage;
+                        if (!self->wall->render_node_active)
+                        {
+                            // Only keeping the background snapshots warm.
+                            self->wall->schedule_background_refresh();
+                            return;
+                        }
 
                         wf::regionf_t our_damage;
                         for (auto& rect : damage)
@@ -112,8 +119,15 @@ class workspace_wall_t::workspace_wall_node_t : public scene::node_t
             // Avoid keeping a low resolution if we are going up in the scale (for example, expo exit
             // animation) and we're close to the 1.0 scale. Otherwise, we risk popping artifacts as we
             // suddenly switch from low to high resolution.
+            //
+            // Snapshots kept warm in the background are an exception: they are reused even when they are
+            // magnified up to 2x (typically at the start of the expo animation), since re-rendering all of
+            // them at that moment is exactly the stutter they exist to avoid. At full size, the workspace
+            // is always rendered in full resolution.
+            const float max_magnification = self->aux_buffer_warm[i][j] ? 2.0 : 1.1;
             const bool rescale_magnification = (render_scale > 0.5) &&
-                (render_scale > current_scale * 1.1);
+                ((render_scale > current_scale * max_magnification) ||
+                    (self->aux_buffer_warm[i][j] && (render_scale >= 1.0)));
 
             // In general, it is worth changing the buffer scale if we have a lot of damage to the old
             // buffer, so that for ex. a full re-scale is actually cheaper than repaiting the old buffer.
@@ -124,22 +138,53 @@ class workspace_wall_t::workspace_wall_node_t : public scene::node_t
 
             if ((repaint_cost_current_scale > repaint_rescale_cost) || rescale_magnification)
             {
-                self->aux_buffer_current_scale[i][j] = render_scale;
-                const auto full_size   = self->aux_buffers[i][j].get_size();
-                const int scaled_width = std::clamp(std::ceil(render_scale * full_size.width),
-                    1.0f, 1.0f * full_size.width);
-                const int scaled_height = std::clamp(std::ceil(render_scale * full_size.height),
-                    1.0f, 1.0f * full_size.height);
-
-                self->aux_buffer_current_subbox[i][j] =
-                    wf::geometry_t{0.0, 0.0, (double)scaled_width, (double)scaled_height};
-                self->aux_buffer_damage[i][j] |= self->workspaces[i][j]->get_bounding_box();
+                self->set_buffer_scale(i, j, render_scale);
                 return true;
             }
 
             return false;
         }
 
+        void render_workspace(int i, int j, const wf::regionf_t& damage)
+        {
+            wf::render_target_t aux{self->aux_buffers[i][j]};
+            aux.subbuffer = self->aux_buffer_current_subbox[i][j];
+            aux.geometry  = self->workspaces[i][j]->get_bounding_box();
+            aux.scale     = self->wall->output->handle->scale;
+
+            render_pass_params_t params;
+            params.instances = &instances[i][j];
+            params.damage    = damage;
+            params.reference_output = self->wall->output;
+            params.target = aux;
+            params.flags  = RPASS_EMIT_SIGNALS;
+            wf::render_pass_t::run(params);
+
+            self->aux_buffer_damage[i][j] ^= damage;
+        }
+
+        /**
+         * Repaint the accumulated damage of all workspaces, regardless of the viewport.
+         * Used to keep the snapshots warm while the wall is not shown.
+         */
+        void refresh_all_workspaces()
+        {
+            for (int i = 0; i < (int)self->workspaces.size(); i++)
+            {
+                for (int j = 0; j < (int)self->workspaces[i].size(); j++)
+                {
+                    wf::regionf_t damage = self->aux_buffer_damage[i][j] &
+                        self->workspaces[i][j]->get_bounding_box();
+                    if (!damage.empty())
+                    {
+                        render_workspace(i, j, damage);
+                    }
+
+                    self->aux_buffer_warm[i][j] = true;
+                }
+            }
+        }
+
         void schedule_instructions(
             std::vector<scene::render_instruction_t>& instructions,
             const wf::render_target_t& target, wf::regionf_t& damage) override
@@ -160,20 +205,7 @@ class workspace_wall_t::workspace_wall_node_t : public scene::node_t
 
                     if (!visible_damage.empty())
                     {
-                        wf::render_target_t aux{self->aux_buffers[i][j]};
-                        aux.subbuffer = self->aux_buffer_current_subbox[i][j];
-                        aux.geometry  = self->workspaces[i][j]->get_bounding_box();
-                        aux.scale     = self->wall->output->handle->scale;
-
-                        render_pass_params_t params;
-                        params.instances = &instances[i][j];
-                        params.damage    = visible_damage;
-                        params.reference_output = self->wall->output;
-                        params.target = aux;
-                        params.flags  = RPASS_EMIT_SIGNALS;
-                        wf::render_pass_t::run(params);
-
-                        self->aux_buffer_damage[i][j] ^= visible_damage;
+                        render_workspace(i, j, visible_damage);
                     }
                 }
             }
@@ -245,10 +277,16 @@ class workspace_wall_t::workspace_wall_node_t : public scene::node_t
   public:
     std::map<std::pair<int, int>, float> render_colors;
 
-    workspace_wall_node_t(workspace_wall_t *wall) : node_t(false)
+    /**
+     * @param initial_scale The scale (relative to the full workspace resolution) at which the buffers are
+     *   allocated initially. Buffers are reallocated in full resolution once they are needed.
+     */
+    workspace_wall_node_t(workspace_wall_t *wall, float initial_scale) : node_t(false)
     {
         this->wall  = wall;
         auto [w, h] = wall->output->wset()->get_workspace_grid_size();
+        grid_size   = {w, h};
+        output_scale = wall->output->handle->scale;
         workspaces.resize(w);
         for (int i = 0; i < w; i++)
         {
@@ -258,16 +296,79 @@ class workspace_wall_t::workspace_wall_node_t : public scene::node_t
                     wall->output, wf::point_t{i, j});
                 workspaces[i].push_back(node);
 
-                auto bbox = workspaces[i][j]->get_bounding_box();
-
-                aux_buffers[i][j].allocate(wf::dimensions(bbox), wall->output->handle->scale,
-                    wf::buffer_allocation_hints_t{
-                        .needs_alpha = false,
-                        .hdr_linear  = wall->output && wall->output->is_hdr(),
-                    });
-                aux_buffer_damage[i][j] |= bbox;
-                aux_buffer_current_scale[i][j]  = 1.0;
+                allocate_buffer(i, j, initial_scale);
+                aux_buffer_current_scale[i][j]  = initial_scale;
                 aux_buffer_current_subbox[i][j] = std::nullopt;
+                aux_buffer_warm[i][j] = false;
+            }
+        }
+    }
+
+    /**
+     * Check whether the node still matches the workspace grid and the output's resolution.
+     */
+    bool is_compatible() const
+    {
+        return (wall->output->wset()->get_workspace_grid_size() == grid_size) &&
+               (wall->output->handle->scale == output_scale) && !workspaces.empty() &&
+               (wf::dimensions(workspaces[0][0]->get_bounding_box()) ==
+                   wf::dimensions(wall->output->get_relative_geometry()));
+    }
+
+    /**
+     * Set the scale at which the workspace (i, j) is rendered, reallocating its buffer if it is too small.
+     */
+    void set_buffer_scale(int i, int j, float scale)
+    {
+        if (scale > aux_buffer_alloc_scale[i][j])
+        {
+            allocate_buffer(i, j, 1.0);
+        }
+
+        aux_buffer_current_scale[i][j] = scale;
+        const auto buffer_size = aux_buffers[i][j].get_size();
+        const float relative_scale = scale / aux_buffer_alloc_scale[i][j];
+        const int scaled_width     = std::clamp(std::ceil(relative_scale * buffer_size.width),
+            1.0f, 1.0f * buffer_size.width);
+        const int scaled_height = std::clamp(std::ceil(relative_scale * buffer_size.height),
+            1.0f, 1.0f * buffer_size.height);
+
+        aux_buffer_current_subbox[i][j] =
+            wf::geometry_t{0.0, 0.0, (double)scaled_width, (double)scaled_height};
+        aux_buffer_damage[i][j] |= workspaces[i][j]->get_bounding_box();
+        aux_buffer_warm[i][j]    = false;
+    }
+
+    /**
+     * Reduce all buffers to at most the given scale, releasing the memory of full-resolution buffers.
+     */
+    void shrink_buffers(float scale)
+    {
+        for (int i = 0; i < (int)workspaces.size(); i++)
+        {
+            for (int j = 0; j < (int)workspaces[i].size(); j++)
+            {
+                if (aux_buffer_alloc_scale[i][j] > scale)
+                {
+                    allocate_buffer(i, j, scale);
+                    aux_buffer_current_scale[i][j]  = scale;
+                    aux_buffer_current_subbox[i][j] = std::nullopt;
+                    aux_buffer_warm[i][j] = false;
+                }
+            }
+        }
+    }
+
+    /**
+     * Mark the contents of all workspaces as outdated.
+     */
+    void damage_all_workspaces()
+    {
+        for (int i = 0; i < (int)workspaces.size(); i++)
+        {
+            for (int j = 0; j < (int)workspaces[i].size(); j++)
+            {
+                aux_buffer_damage[i][j] |= workspaces[i][j]->get_bounding_box();
             }
         }
     }
@@ -295,9 +396,31 @@ class workspace_wall_t::workspace_wall_node_t : public scene::node_t
         return wall->output->get_layout_geometry();
     }
 
+    void refresh_background(std::vector<scene::render_instance_uptr>& instances)
+    {
+        for (auto& instance : instances)
+        {
+            if (auto wwall = dynamic_cast<wwall_render_instance_t*>(instance.get()))
+            {
+                wwall->refresh_all_workspaces();
+            }
+        }
+    }
+
   private:
     workspace_wall_t *wall;
     std::vector<std::vector<std::shared_ptr<workspace_stream_node_t>>> workspaces;
+    wf::dimensions_t grid_size;
+    float output_scale;
+
+    void allocate_buffer(int i, int j, float scale)
+    {
+        auto bbox = workspaces[i][j]->get_bounding_box();
+        aux_buffers[i][j].allocate(wf::dimensions(bbox), wall->output->handle->scale * scale,
+            wall->get_buffer_hints());
+        aux_buffer_alloc_scale[i][j] = scale;
+        aux_buffer_damage[i][j] |= bbox;
+    }
 
     // Buffers keeping the contents of almost-static workspaces
     per_workspace_map_t<wf::auxilliary_buffer_t> aux_buffers;
@@ -307,6 +430,10 @@ class workspace_wall_t::workspace_wall_node_t : public scene::node_t
     per_workspace_map_t<float> aux_buffer_current_scale;
     // Current subbox for the workspace
     per_workspace_map_t<std::optional<wf::geometry_t>> aux_buffer_current_subbox;
+    // Scale at which the buffer was allocated, relative to the full workspace resolution
+    per_workspace_map_t<float> aux_buffer_alloc_scale;
+    // Whether the buffer contains a snapshot refreshed in the background
+    per_workspace_map_t<bool> aux_buffer_warm;
 };
 
 workspace_wall_t::workspace_wall_t(wf::output_t *_output) : output(_output)
@@ -316,6 +443,7 @@ workspace_wall_t::workspace_wall_t(wf::output_t *_output) : output(_output)
 
 workspace_wall_t::~workspace_wall_t()
 {
+    set_background_cache_budget(0);
     stop_output_renderer(false);
 }
 
@@ -332,7 +460,7 @@ void workspace_wall_t::set_gap_size(int size)
 void workspace_wall_t::set_viewport(const wf::geometry_t& viewport_geometry)
 {
     this->viewport = viewport_geometry;
-    if (render_node)
+    if (render_node_active)
     {
         scene::damage_node(
             this->render_node, this->render_node->get_bounding_box());
@@ -353,25 +481,152 @@ void workspace_wall_t::render_wall(
 
 void workspace_wall_t::start_output_renderer()
 {
-    wf::dassert(render_node == nullptr, "Starting workspace-wall twice?");
-    render_node = std::make_shared<workspace_wall_node_t>(this);
+    wf::dassert(!render_node_active, "Starting workspace-wall twice?");
+    background_instances.clear();
+    background_refresh.disconnect();
+    on_root_node_updated.disconnect();
+
+    if (!render_node || !render_node->is_compatible())
+    {
+        render_node = std::make_shared<workspace_wall_node_t>(this, 1.0);
+    }
+
+    render_node_active = true;
     scene::add_front(wf::get_core().scene(), render_node);
 }
 
 void workspace_wall_t::stop_output_renderer(bool reset_viewport)
 {
-    if (!render_node)
+    if (!render_node_active)
     {
         return;
     }
 
     scene::remove_child(render_node);
-    render_node = nullptr;
+    render_node_active = false;
 
     if (reset_viewport)
     {
         set_viewport({0, 0, 0, 0});
     }
+
+    start_background_cache();
+}
+
+void workspace_wall_t::set_background_cache_budget(size_t max_bytes)
+{
+    background_cache_budget = max_bytes;
+    if (render_node_active)
+    {
+        // Applied when the wall stops rendering.
+        return;
+    }
+
+    background_instances.clear();
+    background_refresh.disconnect();
+    on_root_node_updated.disconnect();
+    start_background_cache();
+}
+
+wf::buffer_allocation_hints_t workspace_wall_t::get_buffer_hints() const
+{
+    return wf::buffer_allocation_hints_t{
+        .needs_alpha = false,
+        .hdr_linear  = output && output->is_hdr(),
+    };
+}
+
+float workspace_wall_t::compute_background_cache_scale(size_t budget, wf::dimensions_t screen_size,
+    float output_scale, wf::dimensions_t grid_size, size_t bytes_per_pixel)
+{
+    // Do not keep snapshots at a higher resolution than they are usually displayed at, and do not bother
+    // with snapshots which are too blurry to be useful.
+    constexpr float max_scale = 0.5;
+    constexpr float min_scale = 0.1;
+
+    const double full_bytes = (double)bytes_per_pixel * screen_size.width * screen_size.height *
+        output_scale * output_scale * grid_size.width * grid_size.height;
+    if ((budget == 0) || (full_bytes <= 0))
+    {
+        return 0.0;
+    }
+
+    const float scale = std::min((double)max_scale, std::sqrt(budget / full_bytes));
+    return scale >= min_scale ? scale : 0.0;
+}
+
+float workspace_wall_t::get_background_cache_scale() const
+{
+    return compute_background_cache_scale(background_cache_budget, output->get_screen_size(),
+        output->handle->scale, output->wset()->get_workspace_grid_size(),
+        get_buffer_hints().get_bytes_per_pixel());
+}
+
+void workspace_wall_t::start_background_cache()
+{
+    const float scale = get_background_cache_scale();
+    if (scale <= 0.0)
+    {
+        render_node = nullptr;
+        return;
+    }
+
+    if (!render_node || !render_node->is_compatible())
+    {
+        render_node = std::make_shared<workspace_wall_node_t>(this, scale);
+    } else
+    {
+        render_node->shrink_buffers(scale);
+    }
+
+    background_instances.clear();
+    render_node->gen_render_instances(background_instances, [] (auto) {}, output);
+
+    // The render instances of the workspace streams are not regenerated automatically, since they are not
+    // part of the scenegraph.
+    on_root_node_updated.set_callback([=] (scene::root_node_update_signal *ev)
+    {
+        if (!(ev->flags & (scene::update_flag::CHILDREN_LIST | scene::update_flag::ENABLED)))
+        {
+            return;
+        }
+
+        background_instances.clear();
+        render_node->gen_render_instances(background_instances, [] (auto) {}, output);
+        render_node->damage_all_workspaces();
+        schedule_background_refresh();
+    });
+    wf::get_core().scene()->connect(&on_root_node_updated);
+
+    schedule_background_refresh();
+}
+
+void workspace_wall_t::schedule_background_refresh()
+{
+    if (render_node_active || background_refresh.is_connected())
+    {
+        return;
+    }
+
+    background_refresh.set_timeout(background_refresh_interval, [=] ()
+    {
+        if (!render_node || render_node_active)
+        {
+            return;
+        }
+
+        if (!render_node->is_compatible())
+        {
+            // The workspace grid or the output changed, start over.
+            render_node = nullptr;
+            background_instances.clear();
+            on_root_node_updated.disconnect();
+            start_background_cache();
+            return;
+        }
+
+        render_node->refresh_background(background_instances);
+    });
 }
 
 wf::geometry_t workspace_wall_t::get_workspace_rectangle(
@@ -396,7 +651,7 @@ wf::geometry_t workspace_wall_t::get_wall_rectangle() const
 void workspace_wall_t::set_ws_dim(const wf::point_t& ws, float value)
 {
     render_colors[{ws.x, ws.y}] = value;
-    if (render_node)
+    if (render_node_active)
     {
         scene::damage_node(render_node, render_node->get_bounding_box());
     }
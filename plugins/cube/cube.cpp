@@ -216,7 +216,7 @@ class wayfire_cube : public wf::per_output_plugin_instance_t, public wf::pointer
             background = std::make_unique<wf_cube_background_skydome>(output);
         } else if (last_background_mode == "cubemap")
         {
-            background = std::make_unique<wf_cube_background_cubemap>();
+            background = std::make_unique<wf_cube_background_cubemap>(output);
         } else
         {
             LOGE("cube: Unrecognized background mode %s. Using default \"simple\"",
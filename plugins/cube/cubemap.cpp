@@ -3,24 +3,29 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <config.h>
 #include <wayfire/core.hpp>
-#include <wayfire/img.hpp>
+#include <wayfire/render-manager.hpp>
 
 #include "cubemap-shaders.tpp"
 
-wf_cube_background_cubemap::wf_cube_background_cubemap()
+wf_cube_background_cubemap::wf_cube_background_cubemap(wf::output_t *output)
 {
+    this->output = output;
     create_program();
     reload_texture();
 }
 
 wf_cube_background_cubemap::~wf_cube_background_cubemap()
 {
+    loader.cancel();
     wf::gles::run_in_context([&]
     {
         program.free_resources();
-        GL_CALL(glDeleteTextures(1, &tex));
-        GL_CALL(glDeleteBuffers(1, &vbo_cube_vertices));
-        GL_CALL(glDeleteBuffers(1, &ibo_cube_indices));
+        if (tex != (uint32_t)-1)
+        {
+            GL_CALL(glDeleteTextures(1, &tex));
+            GL_CALL(glDeleteBuffers(1, &vbo_cube_vertices));
+            GL_CALL(glDeleteBuffers(1, &ibo_cube_indices));
+        }
     });
 }
 
@@ -41,30 +46,29 @@ void wf_cube_background_cubemap::reload_texture()
     }
 
     last_background_image = background_image;
-
-    wf::gles::run_in_context([&]
+    loader.load(last_background_image, GL_TEXTURE_CUBE_MAP, {0, 0}, [=] (GLuint new_tex)
     {
-        if (tex == (uint32_t)-1)
+        wf::gles::run_in_context([&]
         {
-            GL_CALL(glGenTextures(1, &tex));
+            if (tex != (uint32_t)-1)
+            {
+                GL_CALL(glDeleteTextures(1, &tex));
+                GL_CALL(glDeleteBuffers(1, &vbo_cube_vertices));
+                GL_CALL(glDeleteBuffers(1, &ibo_cube_indices));
+                tex = -1;
+            }
+
+            if (!new_tex)
+            {
+                LOGE("Failed to load cubemap background image from \"", last_background_image, "\".");
+                return;
+            }
+
+            tex = new_tex;
             GL_CALL(glGenBuffers(1, &vbo_cube_vertices));
             GL_CALL(glGenBuffers(1, &ibo_cube_indices));
-        }
 
-        GL_CALL(glBindTexture(GL_TEXTURE_CUBE_MAP, tex));
-        if (!image_io::load_from_file(last_background_image, GL_TEXTURE_CUBE_MAP))
-        {
-            LOGE("Failed to load cubemap background image from \"%s\".",
-                last_background_image.c_str());
-
-            GL_CALL(glDeleteTextures(1, &tex));
-            GL_CALL(glDeleteBuffers(1, &vbo_cube_vertices));
-            GL_CALL(glDeleteBuffers(1, &ibo_cube_indices));
-            tex = -1;
-        }
-
-        if (tex != (uint32_t)-1)
-        {
+            GL_CALL(glBindTexture(GL_TEXTURE_CUBE_MAP, tex));
             GL_CALL(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER,
                 GL_LINEAR));
             GL_CALL(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER,
@@ -75,9 +79,10 @@ void wf_cube_background_cubemap::reload_texture()
                 GL_CLAMP_TO_EDGE));
             GL_CALL(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R,
                 GL_CLAMP_TO_EDGE));
-        }
+            GL_CALL(glBindTexture(GL_TEXTURE_CUBE_MAP, 0));
+        });
 
-        GL_CALL(glBindTexture(GL_TEXTURE_CUBE_MAP, 0));
+        output->render->damage_whole();
     });
 }
 
@@ -86,6 +91,13 @@ void wf_cube_background_cubemap::render_frame(const wf::render_target_t& fb,
 {
     reload_texture();
 
+    if ((tex == (uint32_t)-1) && loader.is_loading())
+    {
+        // Placeholder until the first image has been decoded and uploaded.
+        OpenGL::clear(placeholder_color, GL_COLOR_BUFFER_BIT);
+        return;
+    }
+
     if (tex == (uint32_t)-1)
     {
         GL_CALL(glClearColor(TEX_ERROR_FLAG_COLOR));
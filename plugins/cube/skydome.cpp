@@ -3,6 +3,7 @@
 #include <wayfire/img.hpp>
 
 #include <wayfire/output.hpp>
+#include <wayfire/render-manager.hpp>
 #include <wayfire/workspace-set.hpp>
 
 
@@ -21,6 +22,7 @@ wf_cube_background_skydome::wf_cube_background_skydome(wf::output_t *output)
 
 wf_cube_background_skydome::~wf_cube_background_skydome()
 {
+    loader.cancel();
     wf::gles::run_in_context([&]
     {
         program.free_resources();
@@ -47,28 +49,37 @@ void wf_cube_background_skydome::reload_texture()
     }
 
     last_background_image = background_image;
-    if (tex == (uint32_t)-1)
+
+    // Roughly a quarter of the dome is visible at a time, anything more detailed is wasted.
+    auto size = output->get_screen_size();
+    wf::dimensions_t max_size = {(int)(4 * size.width), (int)(2 * size.height)};
+    loader.load(last_background_image, GL_TEXTURE_2D, max_size, [=] (GLuint new_tex)
     {
-        GL_CALL(glGenTextures(1, &tex));
-    }
+        wf::gles::run_in_context([&]
+        {
+            if (tex != (GLuint) - 1)
+            {
+                GL_CALL(glDeleteTextures(1, &tex));
+                tex = -1;
+            }
 
-    GL_CALL(glBindTexture(GL_TEXTURE_2D, tex));
+            if (!new_tex)
+            {
+                LOGE("Failed to load skydome image from \"", last_background_image, "\".");
+                return;
+            }
 
-    if (image_io::load_from_file(last_background_image, GL_TEXTURE_2D))
-    {
-        GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
-        GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
-        GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
-        GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
-    } else
-    {
-        LOGE("Failed to load skydome image from \"%s\".",
-            last_background_image.c_str());
-        GL_CALL(glDeleteTextures(1, &tex));
-        tex = -1;
-    }
+            tex = new_tex;
+            GL_CALL(glBindTexture(GL_TEXTURE_2D, tex));
+            GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+            GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
+            GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+            GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+            GL_CALL(glBindTexture(GL_TEXTURE_2D, 0));
+        });
 
-    GL_CALL(glBindTexture(GL_TEXTURE_2D, 0));
+        output->render->damage_whole();
+    });
 }
 
 void wf_cube_background_skydome::fill_vertices()
@@ -132,6 +143,13 @@ void wf_cube_background_skydome::render_frame(const wf::render_target_t& fb,
     fill_vertices();
     reload_texture();
 
+    if ((tex == (uint32_t)-1) && loader.is_loading())
+    {
+        // Placeholder until the first image has been decoded and uploaded.
+        OpenGL::clear(placeholder_color, GL_COLOR_BUFFER_BIT);
+        return;
+    }
+
     if (tex == (uint32_t)-1)
     {
         GL_CALL(glClearColor(TEX_ERROR_FLAG_COLOR));
@@ -3,6 +3,7 @@
 
 #include "cube-background.hpp"
 #include "wayfire/output.hpp"
+#include <wayfire/img.hpp>
 #include <vector>
 
 class wf_cube_background_skydome : public wf_cube_background_base
@@ -23,6 +24,7 @@ class wf_cube_background_skydome : public wf_cube_background_base
 
     OpenGL::program_t program;
     GLuint tex = -1;
+    image_io::async_texture_loader_t loader;
 
     std::vector<GLfloat> vertices;
     std::vector<GLfloat> coords;
@@ -32,6 +34,7 @@ class wf_cube_background_skydome : public wf_cube_background_base
     int last_mirror = -1;
     wf::option_wrapper_t<std::string> background_image{"cube/skydome_texture"};
     wf::option_wrapper_t<bool> mirror_opt{"cube/skydome_mirror"};
+    wf::option_wrapper_t<wf::color_t> placeholder_color{"cube/background"};
 };
 
 #endif /* end of include guard: WF_CUBE_BACKGROUND_SKYDOME */
@@ -87,9 +87,7 @@ void button_t::update_texture()
         .hover_progress = hover,
     };
 
-    auto surface = theme.get_button_surface(type, state);
-    this->button_texture = owned_texture_t{surface};
-    cairo_surface_destroy(surface);
+    this->button_texture = theme.get_button_texture(type, state);
 }
 
 void button_t::add_idle_damage()
@@ -28,7 +28,7 @@
 #include <cairo.h>
 
 class simple_decoration_node_t : public wf::scene::node_t, public wf::pointer_interaction_t,
-    public wf::touch_interaction_t
+    public wf::touch_interaction_t, public wf::scene::opaque_region_node_t
 {
     std::weak_ptr<wf::toplevel_view_interface_t> _view;
     wf::signal::connection_t<wf::view_title_changed_signal> title_set =
@@ -52,9 +52,8 @@ class simple_decoration_node_t : public wf::scene::node_t, public wf::pointer_in
             if ((title_texture.tex.get_size() != target_size) ||
                 (title_texture.current_text != view->get_title()))
             {
-                auto surface = theme.render_text(view->get_title(), target_size.width, target_size.height);
-                title_texture.tex = wf::owned_texture_t{surface};
-                cairo_surface_destroy(surface);
+                title_texture.tex = theme.get_text_texture(view->get_title(),
+                    target_size.width, target_size.height);
                 title_texture.current_text = view->get_title();
             }
         }
@@ -157,6 +156,25 @@ class simple_decoration_node_t : public wf::scene::node_t, public wf::pointer_in
         return {};
     }
 
+    wf::regionf_t get_opaque_region() const override
+    {
+        // The background is drawn below the whole view, so if it is opaque, nothing below the view is
+        // visible.
+        bool activated = false;
+        if (auto view = _view.lock())
+        {
+            activated = view->activated;
+        }
+
+        if ((size.width <= 0) || (size.height <= 0) || (theme.get_background_color(activated).a < 1.0))
+        {
+            return {};
+        }
+
+        return wf::geometry_t{(double)-current_thickness, (double)-current_titlebar,
+            (double)size.width, (double)size.height};
+    }
+
     pointer_interaction_t& pointer_interaction() override
     {
         return *this;
@@ -197,6 +215,7 @@ class simple_decoration_node_t : public wf::scene::node_t, public wf::pointer_in
                     .instance = this,
                     .target   = target,
                     .damage   = std::move(our_damage),
+                    .opaque_region = self->get_opaque_region(),
                 });
             }
         }
@@ -1,6 +1,7 @@
 #include "deco-theme.hpp"
 #include <wayfire/core.hpp>
 #include <wayfire/opengl.hpp>
+#include <cmath>
 #include <config.h>
 
 namespace wf
@@ -41,6 +42,12 @@ void decoration_theme_t::set_buttons(button_type_t flags)
     button_flags = flags;
 }
 
+/** @return The background color for active or inactive decorations */
+wf::color_t decoration_theme_t::get_background_color(bool active) const
+{
+    return active ? active_color : inactive_color;
+}
+
 /**
  * Fill the given rectangle with the background color(s).
  *
@@ -52,8 +59,7 @@ void decoration_theme_t::set_buttons(button_type_t flags)
 void decoration_theme_t::render_background(const wf::scene::render_instruction_t& data,
     wf::geometry_t rectangle, bool active) const
 {
-    wf::color_t color = active ? active_color : inactive_color;
-    data.pass->add_rect(color, data.target, rectangle, data.damage);
+    data.pass->add_rect(get_background_color(active), data.target, rectangle, data.damage);
 }
 
 /**
@@ -95,6 +101,24 @@ cairo_surface_t*decoration_theme_t::render_text(std::string text,
     return surface;
 }
 
+wf::owned_texture_t decoration_theme_t::get_text_texture(std::string text,
+    int width, int height) const
+{
+    raster_key_t key;
+    key.kind  = "decoration-title";
+    key.text  = text;
+    key.font  = (std::string)font;
+    key.size  = {width, height};
+    key.color = (wf::color_t)font_color;
+    key.extra = {(double)font_scale};
+
+    auto entry = raster_cache->get(key, [&] (wf::dimensions_t&)
+    {
+        return render_text(text, width, height);
+    });
+    return wf::owned_texture_t{entry.texture, entry.size};
+}
+
 cairo_surface_t*decoration_theme_t::get_button_surface(button_type_t button,
     const button_state_t& state) const
 {
@@ -211,5 +235,24 @@ cairo_surface_t*decoration_theme_t::get_button_surface(button_type_t button,
 
     return button_surface;
 }
+
+wf::owned_texture_t decoration_theme_t::get_button_texture(button_type_t button,
+    const button_state_t& state) const
+{
+    // The hover state is animated, so quantize it to keep the number of distinct textures small.
+    button_state_t quantized = state;
+    quantized.hover_progress = std::round(state.hover_progress * 32.0) / 32.0;
+
+    raster_key_t key;
+    key.kind  = "decoration-button";
+    key.size  = {(int)std::ceil(state.width), (int)std::ceil(state.height)};
+    key.extra = {(double)button, state.width, state.height, state.border, quantized.hover_progress};
+
+    auto entry = raster_cache->get(key, [&] (wf::dimensions_t&)
+    {
+        return get_button_surface(button, quantized);
+    });
+    return wf::owned_texture_t{entry.texture, entry.size};
+}
 }
 }
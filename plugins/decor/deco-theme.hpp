@@ -2,6 +2,7 @@
 #include <wayfire/render-manager.hpp>
 #include <wayfire/scene-render.hpp>
 #include "deco-button.hpp"
+#include <wayfire/plugins/common/shared-core-data.hpp>
 
 namespace wf
 {
@@ -29,6 +30,9 @@ class decoration_theme_t
     void set_buttons(button_type_t flags);
     button_type_t button_flags;
 
+    /** @return The background color for active or inactive decorations */
+    wf::color_t get_background_color(bool active) const;
+
     /**
      * Fill the given rectangle with the background color(s).
      *
@@ -45,6 +49,13 @@ class decoration_theme_t
      */
     cairo_surface_t *render_text(std::string text, int width, int height) const;
 
+    /**
+     * Get a texture with the given text, rendered as in render_text().
+     * Textures are shared between all decorations via a cache, so each distinct
+     * title is rasterized and uploaded only once.
+     */
+    wf::owned_texture_t get_text_texture(std::string text, int width, int height) const;
+
     struct button_state_t
     {
         /** Button width */
@@ -68,6 +79,13 @@ class decoration_theme_t
     cairo_surface_t *get_button_surface(button_type_t button,
         const button_state_t& state) const;
 
+    /**
+     * Get a texture with the icon for the given button, see get_button_surface().
+     * Like get_text_texture(), the result is cached.
+     */
+    wf::owned_texture_t get_button_texture(button_type_t button,
+        const button_state_t& state) const;
+
   private:
     wf::option_wrapper_t<std::string> font{"decoration/font"};
     wf::option_wrapper_t<wf::color_t> font_color{"decoration/font_color"};
@@ -78,6 +96,8 @@ class decoration_theme_t
     wf::option_wrapper_t<int> button_padding{"decoration/button_padding"};
     wf::option_wrapper_t<wf::color_t> active_color{"decoration/active_color"};
     wf::option_wrapper_t<wf::color_t> inactive_color{"decoration/inactive_color"};
+
+    mutable wf::shared_data::ref_ptr_t<wf::raster_cache_t> raster_cache;
 };
 }
 }
@@ -13,7 +13,17 @@
 
 namespace wf::ipc_rules
 {
-static inline wf::json_t output_to_json(wf::output_t *o)
+static inline wf::json_t workspace_to_json(wf::workspace_set_t *wset)
+{
+    wf::json_t response;
+    response["x"] = wset->get_current_workspace().x;
+    response["y"] = wset->get_current_workspace().y;
+    response["grid_width"]  = wset->get_workspace_grid_size().width;
+    response["grid_height"] = wset->get_workspace_grid_size().height;
+    return response;
+}
+
+static inline wf::json_t output_to_json(wf::output_t *o, const wf::ipc::json_fields_t& fields = {})
 {
     if (!o)
     {
@@ -21,15 +31,16 @@ static inline wf::json_t output_to_json(wf::output_t *o)
     }
 
     wf::json_t response;
-    response["id"]   = o->get_id();
-    response["name"] = o->to_string();
-    response["geometry"]   = wf::ipc::geometry_to_json(o->get_layout_geometry());
-    response["workarea"]   = wf::ipc::geometry_to_json(o->workarea->get_workarea());
-    response["wset-index"] = o->wset()->get_index();
-    response["workspace"]["x"] = o->wset()->get_current_workspace().x;
-    response["workspace"]["y"] = o->wset()->get_current_workspace().y;
-    response["workspace"]["grid_width"]  = o->wset()->get_workspace_grid_size().width;
-    response["workspace"]["grid_height"] = o->wset()->get_workspace_grid_size().height;
+    fields.set(response, "id", [&] { return o->get_id(); });
+    fields.set(response, "name", [&] { return o->to_string(); });
+    fields.set(response, "geometry", [&] { return wf::ipc::geometry_to_json(o->get_layout_geometry()); });
+    fields.set(response, "workarea", [&] { return wf::ipc::geometry_to_json(o->workarea->get_workarea()); });
+    fields.set(response, "workarea-reflows-per-second", [&]
+    {
+        return o->workarea->get_reflows_per_second();
+    });
+    fields.set(response, "wset-index", [&] { return o->wset()->get_index(); });
+    fields.set(response, "workspace", [&] { return workspace_to_json(o->wset().get()); });
     return response;
 }
 
@@ -169,68 +180,80 @@ static inline std::string get_view_type(wayfire_view view)
     return "unknown";
 }
 
-static inline wf::json_t view_to_json(wayfire_view view)
+static inline wf::json_t view_to_json(wayfire_view view, const wf::ipc::json_fields_t& fields = {})
 {
     if (!view)
     {
         return wf::json_t::null();
     }
 
-    auto output = view->get_output();
-    wf::json_t description;
-    description["id"]     = view->get_id();
-    description["pid"]    = get_view_pid(view);
-    description["title"]  = view->get_title();
-    description["app-id"] = view->get_app_id();
-    description["base-geometry"] = wf::ipc::geometry_to_json(get_view_base_geometry(view));
+    auto output   = view->get_output();
     auto toplevel = wf::toplevel_cast(view);
-    description["parent"]   = toplevel && toplevel->parent ? (int)toplevel->parent->get_id() : -1;
-    description["geometry"] =
-        wf::ipc::geometry_to_json(toplevel ? toplevel->get_pending_geometry() : view->get_bounding_box());
-    description["bbox"] = wf::ipc::geometry_to_json(view->get_bounding_box());
-    description["output-id"]   = view->get_output() ? view->get_output()->get_id() : -1;
-    description["output-name"] = output ? output->to_string() : "null";
-    description["last-focus-timestamp"] = wf::get_focus_timestamp(view);
-    description["role"]   = role_to_string(view->role);
-    description["mapped"] = view->is_mapped();
-    description["layer"]  = layer_to_string(get_view_layer(view));
-    description["tiled-edges"] = toplevel ? toplevel->pending_tiled_edges() : 0;
-    description["fullscreen"]  = toplevel ? toplevel->pending_fullscreen() : false;
-    description["minimized"]   = toplevel ? toplevel->minimized : false;
-    description["activated"]   = toplevel ? toplevel->activated : false;
-    description["sticky"]     = toplevel ? toplevel->sticky : false;
-    description["wset-index"] = toplevel && toplevel->get_wset() ?
-        static_cast<int64_t>(toplevel->get_wset()->get_index()) :
-        -1;
-    description["min-size"] = wf::ipc::dimensions_to_json(
-        toplevel ? toplevel->toplevel()->get_min_size() : wf::dimensions_t{0, 0});
-    description["max-size"] = wf::ipc::dimensions_to_json(
-        toplevel ? toplevel->toplevel()->get_max_size() : wf::dimensions_t{0, 0});
-    description["focusable"] = view->is_focusable();
-    description["type"] = get_view_type(view);
-    description["always-on-top"] = view->has_data("wm-actions-above");
-
+    wf::json_t description;
+    fields.set(description, "id", [&] { return view->get_id(); });
+    fields.set(description, "pid", [&] { return get_view_pid(view); });
+    fields.set(description, "title", [&] { return view->get_title(); });
+    fields.set(description, "app-id", [&] { return view->get_app_id(); });
+    fields.set(description, "base-geometry", [&]
+    {
+        return wf::ipc::geometry_to_json(get_view_base_geometry(view));
+    });
+    fields.set(description, "parent", [&]
+    {
+        return toplevel && toplevel->parent ? (int)toplevel->parent->get_id() : -1;
+    });
+    fields.set(description, "geometry", [&]
+    {
+        return wf::ipc::geometry_to_json(
+            toplevel ? toplevel->get_pending_geometry() : view->get_bounding_box());
+    });
+    fields.set(description, "bbox", [&] { return wf::ipc::geometry_to_json(view->get_bounding_box()); });
+    fields.set(description, "output-id", [&] { return output ? output->get_id() : -1; });
+    fields.set(description, "output-name", [&] { return output ? output->to_string() : "null"; });
+    fields.set(description, "last-focus-timestamp", [&] { return wf::get_focus_timestamp(view); });
+    fields.set(description, "role", [&] { return role_to_string(view->role); });
+    fields.set(description, "mapped", [&] { return view->is_mapped(); });
+    fields.set(description, "layer", [&] { return layer_to_string(get_view_layer(view)); });
+    fields.set(description, "tiled-edges", [&] { return toplevel ? toplevel->pending_tiled_edges() : 0; });
+    fields.set(description, "fullscreen", [&] { return toplevel ? toplevel->pending_fullscreen() : false; });
+    fields.set(description, "minimized", [&] { return toplevel ? toplevel->minimized : false; });
+    fields.set(description, "activated", [&] { return toplevel ? toplevel->activated : false; });
+    fields.set(description, "sticky", [&] { return toplevel ? toplevel->sticky : false; });
+    fields.set(description, "wset-index", [&]
+    {
+        return toplevel && toplevel->get_wset() ?
+               static_cast<int64_t>(toplevel->get_wset()->get_index()) : -1;
+    });
+    fields.set(description, "min-size", [&]
+    {
+        return wf::ipc::dimensions_to_json(
+            toplevel ? toplevel->toplevel()->get_min_size() : wf::dimensions_t{0, 0});
+    });
+    fields.set(description, "max-size", [&]
+    {
+        return wf::ipc::dimensions_to_json(
+            toplevel ? toplevel->toplevel()->get_max_size() : wf::dimensions_t{0, 0});
+    });
+    fields.set(description, "focusable", [&] { return view->is_focusable(); });
+    fields.set(description, "type", [&] { return get_view_type(view); });
+    fields.set(description, "always-on-top", [&] { return view->has_data("wm-actions-above"); });
     return description;
 }
 
-static inline wf::json_t wset_to_json(wf::workspace_set_t *wset)
+static inline wf::json_t wset_to_json(wf::workspace_set_t *wset, const wf::ipc::json_fields_t& fields = {})
 {
     if (!wset)
     {
         return wf::json_t::null();
     }
 
-    wf::json_t response;
-    response["index"] = wset->get_index();
-    response["name"]  = wset->to_string();
-
     auto output = wset->get_attached_output();
-    response["output-id"]   = output ? (int)output->get_id() : -1;
-    response["output-name"] = output ? output->to_string() : "";
-    response["workspace"]["x"] = wset->get_current_workspace().x;
-    response["workspace"]["y"] = wset->get_current_workspace().y;
-    response["workspace"]["grid_width"]  = wset->get_workspace_grid_size().width;
-    response["workspace"]["grid_height"] = wset->get_workspace_grid_size().height;
+    wf::json_t response;
+    fields.set(response, "index", [&] { return wset->get_index(); });
+    fields.set(response, "name", [&] { return wset->to_string(); });
+    fields.set(response, "output-id", [&] { return output ? (int)output->get_id() : -1; });
+    fields.set(response, "output-name", [&] { return output ? output->to_string() : ""; });
+    fields.set(response, "workspace", [&] { return workspace_to_json(wset); });
     return response;
 }
 
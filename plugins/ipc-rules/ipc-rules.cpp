@@ -16,11 +16,13 @@
 #include "ipc-input-methods.hpp"
 #include "ipc-utility-methods.hpp"
 #include "ipc-events.hpp"
+#include "ipc-state-snapshot.hpp"
 
 class ipc_rules_t : public wf::plugin_interface_t,
     public wf::ipc_rules_input_methods_t,
     public wf::ipc_rules_utility_methods_t,
-    public wf::ipc_rules_events_methods_t
+    public wf::ipc_rules_events_methods_t,
+    public wf::ipc_rules_state_snapshot_t
 {
   public:
     void init() override
@@ -43,6 +45,7 @@ class ipc_rules_t : public wf::plugin_interface_t,
         init_input_methods(method_repository.get());
         init_utility_methods(method_repository.get());
         init_events(method_repository.get());
+        init_state_snapshot(method_repository.get());
     }
 
     void fini() override
@@ -65,14 +68,16 @@ class ipc_rules_t : public wf::plugin_interface_t,
         fini_input_methods(method_repository.get());
         fini_utility_methods(method_repository.get());
         fini_events(method_repository.get());
+        fini_state_snapshot(method_repository.get());
     }
 
-    wf::ipc::method_callback list_views = [=] (wf::json_t)
+    wf::ipc::method_callback list_views = [=] (wf::json_t data)
     {
+        auto fields = wf::ipc::json_fields_t::from_request(data);
         wf::json_t response = wf::json_t::array();
         for (auto& view : wf::get_core().get_all_views())
         {
-            wf::json_t v = wf::ipc_rules::view_to_json(view);
+            wf::json_t v = wf::ipc_rules::view_to_json(view, fields);
             response.append(v);
         }
 
@@ -83,7 +88,7 @@ class ipc_rules_t : public wf::plugin_interface_t,
     {
         auto view     = wf::ipc::json_find_view_or_throw(data);
         auto response = wf::ipc::json_ok();
-        response["info"] = wf::ipc_rules::view_to_json(view);
+        response["info"] = wf::ipc_rules::view_to_json(view, wf::ipc::json_fields_t::from_request(data));
         return response;
     };
 
@@ -239,12 +244,13 @@ class ipc_rules_t : public wf::plugin_interface_t,
         return wf::ipc::json_error("property has unsupported type");
     };
 
-    wf::ipc::method_callback list_outputs = [=] (wf::json_t)
+    wf::ipc::method_callback list_outputs = [=] (wf::json_t data)
     {
+        auto fields = wf::ipc::json_fields_t::from_request(data);
         wf::json_t response = wf::json_t::array();
         for (auto& output : wf::get_core().output_layout->get_outputs())
         {
-            response.append(wf::ipc_rules::output_to_json(output));
+            response.append(wf::ipc_rules::output_to_json(output, fields));
         }
 
         return response;
@@ -259,7 +265,7 @@ class ipc_rules_t : public wf::plugin_interface_t,
             return wf::ipc::json_error("output not found");
         }
 
-        auto response = wf::ipc_rules::output_to_json(wo);
+        auto response = wf::ipc_rules::output_to_json(wo, wf::ipc::json_fields_t::from_request(data));
         return response;
     };
 
@@ -334,12 +340,13 @@ class ipc_rules_t : public wf::plugin_interface_t,
         return wf::ipc::json_ok();
     };
 
-    wf::ipc::method_callback list_wsets = [=] (wf::json_t)
+    wf::ipc::method_callback list_wsets = [=] (wf::json_t data)
     {
+        auto fields = wf::ipc::json_fields_t::from_request(data);
         wf::json_t response = wf::json_t::array();
         for (auto& workspace_set : wf::workspace_set_t::get_all())
         {
-            response.append(wf::ipc_rules::wset_to_json(workspace_set.get()));
+            response.append(wf::ipc_rules::wset_to_json(workspace_set.get(), fields));
         }
 
         return response;
@@ -354,7 +361,7 @@ class ipc_rules_t : public wf::plugin_interface_t,
             return wf::ipc::json_error("workspace set not found");
         }
 
-        auto response = wf::ipc_rules::wset_to_json(ws);
+        auto response = wf::ipc_rules::wset_to_json(ws, wf::ipc::json_fields_t::from_request(data));
         return response;
     };
 
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace wf
+{
+/**
+ * The layout of the state snapshot memfd handed out by window-rules/get-state-snapshot.
+ *
+ * The file starts with the header below, padded to @header_size bytes (currently 64). All fields are in
+ * native byte order. The payload follows the header and is a JSON object with the members "views" (mapped
+ * views, as in window-rules/list-views), "outputs", "wsets", "focused-view" and "focused-output" (ids, -1
+ * if none).
+ *
+ * The payload is protected by a sequence lock. To read a consistent snapshot, a client:
+ * 1. loads @sequence (acquire) and retries later if it is odd (an update is in progress),
+ * 2. copies @payload_size bytes of payload, remapping the file first if @capacity grew beyond its mapping,
+ * 3. loads @sequence again (after an acquire fence) and retries if it changed.
+ *
+ * The file only ever grows, so mappings never become invalid. The descriptor is read-only, so clients can
+ * only create read-only mappings of it.
+ */
+struct ipc_state_snapshot_header_t
+{
+    static constexpr uint32_t MAGIC = 0x53534657; // "WFSS"
+    static constexpr uint32_t FORMAT_VERSION = 1;
+
+    /** Offset 0: always MAGIC. */
+    uint32_t magic;
+    /** Offset 4: FORMAT_VERSION of the compositor which wrote the file. */
+    uint32_t format_version;
+    /** Offset 8: odd while the payload is being written. */
+    std::atomic<uint32_t> sequence;
+    /** Offset 12: offset of the payload from the start of the file, in bytes. */
+    uint32_t header_size;
+    /** Offset 16: space available for the payload, in bytes. */
+    uint64_t capacity;
+    /** Offset 24: size of the current payload, in bytes. */
+    uint64_t payload_size;
+    /** Offset 32: incremented on each published snapshot. */
+    uint64_t generation;
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "The sequence lock must be address-free");
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t));
+static_assert(offsetof(ipc_state_snapshot_header_t, sequence) == 8);
+static_assert(offsetof(ipc_state_snapshot_header_t, capacity) == 16);
+static_assert(offsetof(ipc_state_snapshot_header_t, generation) == 32);
+static_assert(sizeof(ipc_state_snapshot_header_t) == 40);
+}
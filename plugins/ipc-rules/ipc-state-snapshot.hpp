@@ -0,0 +1,432 @@
+#pragma once
+
+#include "ipc-rules-common.hpp"
+#include "ipc-state-snapshot-format.hpp"
+#include "wayfire/output-layout.hpp"
+#include "wayfire/plugins/ipc/ipc-method-repository.hpp"
+#include "wayfire/seat.hpp"
+#include <wayfire/signal-definitions.hpp>
+#include <wayfire/util.hpp>
+#include <wayfire/util/log.hpp>
+#include "plugins/wm-actions/wm-actions-signals.hpp"
+
+#include <cstring>
+#include <map>
+#include <new>
+#include <set>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace wf
+{
+/**
+ * Keeps a snapshot of the compositor state (views, outputs, workspace sets and focus) in a memfd, which
+ * clients obtain with window-rules/get-state-snapshot and can then read at any rate without IPC round-trips.
+ *
+ * Tracking only starts when the first client requests the snapshot. The state is updated incrementally
+ * from the same signals as the IPC events, and written to the memfd at most once per event loop iteration.
+ */
+class ipc_rules_state_snapshot_t
+{
+  public:
+    void init_state_snapshot(ipc::method_repository_t *method_repository)
+    {
+        method_repository->register_method("window-rules/get-state-snapshot", get_state_snapshot);
+    }
+
+    void fini_state_snapshot(ipc::method_repository_t *method_repository)
+    {
+        method_repository->unregister_method("window-rules/get-state-snapshot");
+        idle_publish.disconnect();
+        release_memfd();
+    }
+
+  private:
+    static constexpr size_t HEADER_SIZE = 64;
+    static constexpr size_t INITIAL_CAPACITY = 1 << 20;
+    static_assert(sizeof(ipc_state_snapshot_header_t) <= HEADER_SIZE);
+
+    int memfd = -1;
+    void *memory = nullptr;
+    size_t mapped_size = 0;
+
+    std::map<uint32_t, wf::json_t> views;
+    // Views whose state changed since the last publish, serialized once in publish().
+    std::set<uint32_t> dirty_views;
+    // Outputs and workspace sets are few, so they are serialized anew whenever one of them changes.
+    bool outputs_dirty = true;
+    wf::json_t outputs;
+    wf::json_t wsets;
+    uint32_t focused_view = -1;
+    wf::wl_idle_call idle_publish;
+
+    ipc_state_snapshot_header_t *header()
+    {
+        return static_cast<ipc_state_snapshot_header_t*>(memory);
+    }
+
+    bool start_tracking()
+    {
+        // Clients map the file, so it must never shrink under them. It keeps growing and being written to,
+        // so F_SEAL_GROW and F_SEAL_WRITE cannot be applied; F_SEAL_SEAL keeps anyone else from adding them.
+        memfd = memfd_create("wayfire-state-snapshot", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+        if ((memfd < 0) || !map_memory(HEADER_SIZE + INITIAL_CAPACITY) ||
+            (fcntl(memfd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_SEAL) < 0))
+        {
+            LOGE("Failed to create the IPC state snapshot: ", strerror(errno));
+            release_memfd();
+            return false;
+        }
+
+        auto hdr = new (memory) ipc_state_snapshot_header_t{};
+        hdr->magic = ipc_state_snapshot_header_t::MAGIC;
+        hdr->format_version = ipc_state_snapshot_header_t::FORMAT_VERSION;
+        hdr->header_size    = HEADER_SIZE;
+        hdr->capacity = INITIAL_CAPACITY;
+
+        auto& core = wf::get_core();
+        core.connect(&on_view_mapped);
+        core.connect(&on_view_unmapped);
+        core.connect(&on_view_set_output);
+        core.connect(&on_view_geometry_changed);
+        core.connect(&on_view_moved_to_wset);
+        core.connect(&on_view_tiled);
+        core.connect(&on_view_fullscreen);
+        core.connect(&on_title_changed);
+        core.connect(&on_app_id_changed);
+        core.connect(&on_kbfocus_changed);
+        core.connect(&on_output_gain_focus);
+        core.output_layout->connect(&on_output_added);
+        core.output_layout->connect(&on_output_removed);
+        for (auto wo : core.output_layout->get_outputs())
+        {
+            track_output(wo);
+        }
+
+        for (auto& view : core.get_all_views())
+        {
+            dirty_views.insert(view->get_id());
+        }
+
+        publish();
+        return true;
+    }
+
+    void release_memfd()
+    {
+        if (memory)
+        {
+            munmap(memory, mapped_size);
+            memory = nullptr;
+            mapped_size = 0;
+        }
+
+        if (memfd >= 0)
+        {
+            close(memfd);
+            memfd = -1;
+        }
+    }
+
+    bool map_memory(size_t size)
+    {
+        if (ftruncate(memfd, size) < 0)
+        {
+            return false;
+        }
+
+        void *new_memory = memory ? mremap(memory, mapped_size, size, MREMAP_MAYMOVE) :
+            mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, memfd, 0);
+        if (new_memory == MAP_FAILED)
+        {
+            return false;
+        }
+
+        memory = new_memory;
+        mapped_size = size;
+        return true;
+    }
+
+    void track_output(wf::output_t *output)
+    {
+        output->connect(&on_view_minimized);
+        output->connect(&on_view_sticky);
+        output->connect(&on_view_above);
+        output->connect(&on_view_workspace);
+        output->connect(&on_wset_changed);
+        output->connect(&on_workspace_changed);
+    }
+
+    void schedule_publish()
+    {
+        idle_publish.run_once([=] () { publish(); });
+    }
+
+    void update_view(wayfire_view view)
+    {
+        if (view)
+        {
+            mark_view_dirty(view->get_id());
+        }
+    }
+
+    void mark_view_dirty(uint32_t id)
+    {
+        dirty_views.insert(id);
+        schedule_publish();
+    }
+
+    void serialize_dirty_views()
+    {
+        for (auto& view : wf::get_core().get_all_views())
+        {
+            auto it = dirty_views.find(view->get_id());
+            if (it == dirty_views.end())
+            {
+                continue;
+            }
+
+            dirty_views.erase(it);
+            if (view->is_mapped())
+            {
+                views[view->get_id()] = ipc_rules::view_to_json(view);
+            } else
+            {
+                views.erase(view->get_id());
+            }
+        }
+
+        // The remaining views were destroyed in the meantime.
+        for (auto id : dirty_views)
+        {
+            views.erase(id);
+        }
+
+        dirty_views.clear();
+    }
+
+    void update_outputs()
+    {
+        outputs_dirty = true;
+        schedule_publish();
+    }
+
+    void serialize_outputs()
+    {
+        outputs_dirty = false;
+        outputs = wf::json_t::array();
+        for (auto wo : wf::get_core().output_layout->get_outputs())
+        {
+            outputs.append(ipc_rules::output_to_json(wo));
+        }
+
+        wsets = wf::json_t::array();
+        for (auto& wset : wf::workspace_set_t::get_all())
+        {
+            wsets.append(ipc_rules::wset_to_json(wset.get()));
+        }
+    }
+
+    void publish()
+    {
+        if (outputs_dirty)
+        {
+            serialize_outputs();
+        }
+
+        if (!dirty_views.empty())
+        {
+            serialize_dirty_views();
+        }
+
+        wf::json_t state;
+        state["views"] = wf::json_t::array();
+        for (auto& [id, view] : views)
+        {
+            state["views"].append(view);
+        }
+
+        auto active_output = wf::get_core().seat->get_active_output();
+        state["outputs"] = outputs;
+        state["wsets"]   = wsets;
+        state["focused-view"]   = views.count(focused_view) ? (int64_t)focused_view : -1;
+        state["focused-output"] = active_output ? (int64_t)active_output->get_id() : -1;
+        state.map_serialized([&] (const char *payload, size_t size)
+        {
+            write_payload(payload, size);
+        });
+    }
+
+    void write_payload(const char *payload, size_t size)
+    {
+        size_t capacity = header()->capacity;
+        while (capacity < size)
+        {
+            capacity *= 2;
+        }
+
+        if ((capacity != header()->capacity) && !map_memory(HEADER_SIZE + capacity))
+        {
+            LOGE("Failed to grow the IPC state snapshot to ", capacity, " bytes");
+            return;
+        }
+
+        auto hdr = header();
+        hdr->sequence.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        std::memcpy(static_cast<char*>(memory) + HEADER_SIZE, payload, size);
+        hdr->capacity     = capacity;
+        hdr->payload_size = size;
+        hdr->generation++;
+
+        hdr->sequence.fetch_add(1, std::memory_order_release);
+    }
+
+    wf::ipc::method_callback_full get_state_snapshot =
+        [=] (wf::json_t data, wf::ipc::client_interface_t *client)
+    {
+        if ((memfd < 0) && !start_tracking())
+        {
+            return wf::ipc::json_error("failed to create the state snapshot");
+        }
+
+        // Hand out a read-only file descriptor, so that clients can only create a read-only mapping and
+        // cannot corrupt the snapshot for others.
+        int readonly_fd = open(("/proc/self/fd/" + std::to_string(memfd)).c_str(), O_RDONLY | O_CLOEXEC);
+        if (readonly_fd < 0)
+        {
+            return wf::ipc::json_error("failed to open the state snapshot");
+        }
+
+        if (!client || !client->attach_fd_to_reply(readonly_fd))
+        {
+            close(readonly_fd);
+            return wf::ipc::json_error("client does not support file descriptor passing");
+        }
+
+        auto response = wf::ipc::json_ok();
+        response["format-version"] = ipc_state_snapshot_header_t::FORMAT_VERSION;
+        response["header-size"]    = (uint64_t)HEADER_SIZE;
+        return response;
+    };
+
+    wf::signal::connection_t<wf::view_mapped_signal> on_view_mapped = [=] (wf::view_mapped_signal *ev)
+    {
+        update_view(ev->view);
+    };
+
+    wf::signal::connection_t<wf::view_unmapped_signal> on_view_unmapped = [=] (wf::view_unmapped_signal *ev)
+    {
+        update_view(ev->view);
+    };
+
+    wf::signal::connection_t<wf::view_set_output_signal> on_view_set_output =
+        [=] (wf::view_set_output_signal *ev)
+    {
+        update_view(ev->view);
+    };
+
+    wf::signal::connection_t<wf::view_geometry_changed_signal> on_view_geometry_changed =
+        [=] (wf::view_geometry_changed_signal *ev)
+    {
+        update_view(ev->view);
+    };
+
+    wf::signal::connection_t<wf::view_moved_to_wset_signal> on_view_moved_to_wset =
+        [=] (wf::view_moved_to_wset_signal *ev)
+    {
+        update_view(ev->view);
+    };
+
+    wf::signal::connection_t<wf::view_tiled_signal> on_view_tiled = [=] (wf::view_tiled_signal *ev)
+    {
+        update_view(ev->view);
+    };
+
+    wf::signal::connection_t<wf::view_fullscreen_signal> on_view_fullscreen =
+        [=] (wf::view_fullscreen_signal *ev)
+    {
+        update_view(ev->view);
+    };
+
+    wf::signal::connection_t<wf::view_title_changed_signal> on_title_changed =
+        [=] (wf::view_title_changed_signal *ev)
+    {
+        update_view(ev->view);
+    };
+
+    wf::signal::connection_t<wf::view_app_id_changed_signal> on_app_id_changed =
+        [=] (wf::view_app_id_changed_signal *ev)
+    {
+        update_view(ev->view);
+    };
+
+    wf::signal::connection_t<wf::view_minimized_signal> on_view_minimized =
+        [=] (wf::view_minimized_signal *ev)
+    {
+        update_view(ev->view);
+    };
+
+    wf::signal::connection_t<wf::view_set_sticky_signal> on_view_sticky =
+        [=] (wf::view_set_sticky_signal *ev)
+    {
+        update_view(ev->view);
+    };
+
+    wf::signal::connection_t<wf::wm_actions_above_changed_signal> on_view_above =
+        [=] (wf::wm_actions_above_changed_signal *ev)
+    {
+        update_view(ev->view);
+    };
+
+    wf::signal::connection_t<wf::view_change_workspace_signal> on_view_workspace =
+        [=] (wf::view_change_workspace_signal *ev)
+    {
+        update_view(ev->view);
+    };
+
+    wf::signal::connection_t<wf::keyboard_focus_changed_signal> on_kbfocus_changed =
+        [=] (wf::keyboard_focus_changed_signal *ev)
+    {
+        // The activated state and focus timestamp of both the old and the new view change.
+        auto new_focus = wf::node_to_view(ev->new_focus);
+        mark_view_dirty(focused_view);
+        focused_view = new_focus ? new_focus->get_id() : -1;
+        update_view(new_focus);
+    };
+
+    wf::signal::connection_t<wf::output_gain_focus_signal> on_output_gain_focus =
+        [=] (wf::output_gain_focus_signal *ev)
+    {
+        schedule_publish();
+    };
+
+    wf::signal::connection_t<wf::output_added_signal> on_output_added = [=] (wf::output_added_signal *ev)
+    {
+        track_output(ev->output);
+        update_outputs();
+    };
+
+    wf::signal::connection_t<wf::output_removed_signal> on_output_removed =
+        [=] (wf::output_removed_signal *ev)
+    {
+        // The output is still listed while the signal is emitted, it is gone by the time we publish.
+        update_outputs();
+    };
+
+    wf::signal::connection_t<wf::workspace_set_changed_signal> on_wset_changed =
+        [=] (wf::workspace_set_changed_signal *ev)
+    {
+        update_outputs();
+    };
+
+    wf::signal::connection_t<wf::workspace_changed_signal> on_workspace_changed =
+        [=] (wf::workspace_changed_signal *ev)
+    {
+        update_outputs();
+    };
+};
+}
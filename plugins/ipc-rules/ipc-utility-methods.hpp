@@ -8,6 +8,10 @@
 #include <wayfire/plugin.hpp>
 #include <wayfire/nonstd/wlroots-full.hpp>
 #include <wayfire/output-layout.hpp>
+#include <wayfire/aux-buffer-pool.hpp>
+#include <wayfire/startup-timing.hpp>
+#include <wayfire/matcher.hpp>
+#include <wayfire/render-manager.hpp>
 #include <wayfire/config/compound-option.hpp>
 #include <wayfire/config/config-manager.hpp>
 
@@ -35,6 +39,12 @@ class ipc_rules_utility_methods_t
         method_repository->register_method("wayfire/set-config-options", set_config_options);
         method_repository->register_method("wayfire/get-keyboard-state", get_kb_state);
         method_repository->register_method("wayfire/set-keyboard-state", set_kb_state);
+        method_repository->register_method("wayfire/aux-buffer-pool-stats", get_aux_buffer_pool_stats);
+        method_repository->register_method("wayfire/animation-stats", get_animation_stats);
+        method_repository->register_method("wayfire/repaint-stats", get_repaint_stats);
+        method_repository->register_method("wayfire/occlusion-stats", get_occlusion_stats);
+        method_repository->register_method("wayfire/startup-timing", get_startup_timing);
+        method_repository->register_method("wayfire/matcher-cache-stats", get_matcher_cache_stats);
     }
 
     void fini_utility_methods(ipc::method_repository_t *method_repository)
@@ -47,6 +57,12 @@ class ipc_rules_utility_methods_t
         method_repository->unregister_method("wayfire/set-config-option");
         method_repository->unregister_method("wayfire/get-keyboard-state");
         method_repository->unregister_method("wayfire/set-keyboard-state");
+        method_repository->unregister_method("wayfire/aux-buffer-pool-stats");
+        method_repository->unregister_method("wayfire/animation-stats");
+        method_repository->unregister_method("wayfire/repaint-stats");
+        method_repository->unregister_method("wayfire/occlusion-stats");
+        method_repository->unregister_method("wayfire/startup-timing");
+        method_repository->unregister_method("wayfire/matcher-cache-stats");
     }
 
     wf::ipc::method_callback get_wayfire_configuration_info = [=] (wf::json_t)
@@ -373,5 +389,145 @@ class ipc_rules_utility_methods_t
             keyboard->modifiers.latched, keyboard->modifiers.locked, index);
         return wf::ipc::json_ok();
     };
+
+    wf::ipc::method_callback get_aux_buffer_pool_stats = [=] (const wf::json_t& data) -> json_t
+    {
+        auto stats    = wf::get_core().aux_buffer_pool->get_stats();
+        auto response = wf::ipc::json_ok();
+        response["leased-bytes"]   = (uint64_t)stats.leased_bytes;
+        response["pooled-bytes"]   = (uint64_t)stats.pooled_bytes;
+        response["budget-bytes"]   = (uint64_t)stats.budget_bytes;
+        response["leased-buffers"] = (uint64_t)stats.leased_buffers;
+        response["pooled-buffers"] = (uint64_t)stats.pooled_buffers;
+        response["hits"]      = stats.hits;
+        response["misses"]    = stats.misses;
+        response["evictions"] = stats.evictions;
+        return response;
+    };
+
+    wf::ipc::method_callback get_animation_stats = [=] (const wf::json_t& data) -> json_t
+    {
+        auto response = wf::ipc::json_ok();
+        response["outputs"] = wf::json_t::array();
+        for (auto wo : wf::get_core().output_layout->get_outputs())
+        {
+            auto stats = wo->render->get_animation_stats();
+            wf::json_t output_stats;
+            output_stats["output"]     = wo->to_string();
+            output_stats["output-id"]  = wo->get_id();
+            output_stats["animations"] = (uint64_t)stats.animations;
+            output_stats["last-frame-cost-us"]    = stats.last_frame_cost_us;
+            output_stats["average-frame-cost-us"] = stats.average_frame_cost_us;
+            output_stats["max-frame-cost-us"]     = stats.max_frame_cost_us;
+            response["outputs"].append(output_stats);
+        }
+
+        return response;
+    };
+
+    static std::string repaint_delay_mode_to_string(wf::repaint_delay_mode_t mode)
+    {
+        switch (mode)
+        {
+          case wf::repaint_delay_mode_t::DISABLED:
+            return "disabled";
+
+          case wf::repaint_delay_mode_t::FIXED:
+            return "fixed";
+
+          case wf::repaint_delay_mode_t::LEARNING:
+            return "learning";
+
+          case wf::repaint_delay_mode_t::LEARNED:
+            return "learned";
+        }
+
+        return "unknown";
+    }
+
+    wf::ipc::method_callback get_repaint_stats = [=] (const wf::json_t& data) -> json_t
+    {
+        auto response = wf::ipc::json_ok();
+        response["outputs"] = wf::json_t::array();
+        for (auto wo : wf::get_core().output_layout->get_outputs())
+        {
+            auto stats = wo->render->get_repaint_stats();
+            wf::json_t output_stats;
+            output_stats["output"]         = wo->to_string();
+            output_stats["output-id"]      = wo->get_id();
+            output_stats["refresh-nsec"]   = stats.refresh_nsec;
+            output_stats["delay-ms"]       = stats.delay_ms;
+            output_stats["mode"]           = repaint_delay_mode_to_string(stats.mode);
+            output_stats["active-plugins"] = stats.active_plugins;
+            output_stats["predicted-render-us"] = stats.predicted_render_us;
+            output_stats["profiles"] = wf::json_t::array();
+            for (auto& profile : stats.profiles)
+            {
+                wf::json_t profile_stats;
+                profile_stats["active-plugins"] = profile.active_plugins;
+                profile_stats["samples"] = (uint64_t)profile.samples;
+                profile_stats["last-render-us"] = profile.last_render_us;
+                profile_stats["max-render-us"]  = profile.max_render_us;
+                profile_stats["percentile-render-us"] = profile.percentile_render_us;
+                profile_stats["miss-penalty-us"] = profile.miss_penalty_us;
+                profile_stats["frames"] = profile.frames;
+                profile_stats["missed-frames"] = profile.missed_frames;
+                output_stats["profiles"].append(profile_stats);
+            }
+
+            response["outputs"].append(output_stats);
+        }
+
+        return response;
+    };
+
+    wf::ipc::method_callback get_occlusion_stats = [=] (const wf::json_t& data) -> json_t
+    {
+        auto response = wf::ipc::json_ok();
+        response["outputs"] = wf::json_t::array();
+        for (auto wo : wf::get_core().output_layout->get_outputs())
+        {
+            auto stats = wo->render->get_occlusion_stats();
+            wf::json_t output_stats;
+            output_stats["output"]    = wo->to_string();
+            output_stats["output-id"] = wo->get_id();
+            output_stats["last-frame-culled"] = stats.last_frame_culled;
+            output_stats["total-culled"] = stats.total_culled;
+            output_stats["frames"] = stats.frames;
+            response["outputs"].append(output_stats);
+        }
+
+        return response;
+    };
+
+    wf::ipc::method_callback get_startup_timing = [=] (const wf::json_t& data) -> json_t
+    {
+        auto& timing  = *wf::get_core().startup_timing;
+        auto response = wf::ipc::json_ok();
+        response["time-to-first-frame-us"] = timing.get_time_to_first_frame_us();
+        response["phases"] = wf::json_t::array();
+        for (auto& phase : timing.get_phases())
+        {
+            wf::json_t phase_json;
+            phase_json["name"]     = phase.name;
+            phase_json["start-us"] = phase.start_us;
+            phase_json["duration-us"] = phase.duration_us;
+            response["phases"].append(phase_json);
+        }
+
+        return response;
+    };
+
+    wf::ipc::method_callback get_matcher_cache_stats = [=] (const wf::json_t& data) -> json_t
+    {
+        auto stats    = wf::view_matcher_t::get_cache_stats();
+        auto lookups  = stats.hits + stats.misses;
+        auto response = wf::ipc::json_ok();
+        response["hits"]   = stats.hits;
+        response["misses"] = stats.misses;
+        response["uncacheable"] = stats.uncacheable;
+        response["hit-rate"]    = lookups ? (double)stats.hits / lookups : 0.0;
+        return response;
+    };
 };
 }
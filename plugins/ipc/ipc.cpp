@@ -1,5 +1,6 @@
 #include "ipc.hpp"
 #include "wayfire/plugins/common/shared-core-data.hpp"
+#include "wayfire/plugins/ipc/ipc-msgpack.hpp"
 #include <climits>
 #include <wayfire/util/log.hpp>
 #include <wayfire/core.hpp>
@@ -10,6 +11,7 @@
 #include <sys/ioctl.h>
 #include <unistd.h>
 #include <cstring>
+#include <utility>
 
 /**
  * Handle WL_EVENT_READABLE on the socket.
@@ -27,6 +29,34 @@ wf::ipc::server_t::server_t()
     {
         do_accept_new_client();
     };
+
+    set_ipc_encoding = [=] (const wf::json_t& data, client_interface_t *client)
+    {
+        auto our_client = dynamic_cast<client_t*>(client);
+        if (!our_client)
+        {
+            return wf::ipc::json_error("encoding can only be set for socket clients");
+        }
+
+        if (!data.has_member("encoding") || !data["encoding"].is_string())
+        {
+            return wf::ipc::json_error("missing \"encoding\"");
+        }
+
+        const std::string name = data["encoding"].as_string();
+        if (name == "json")
+        {
+            our_client->set_encoding_after_reply(wire_encoding_t::JSON);
+        } else if (name == "msgpack")
+        {
+            our_client->set_encoding_after_reply(wire_encoding_t::MSGPACK);
+        } else
+        {
+            return wf::ipc::json_error("unsupported encoding " + name);
+        }
+
+        return wf::ipc::json_ok();
+    };
 }
 
 void wf::ipc::server_t::init(std::string socket_path)
@@ -39,6 +69,7 @@ void wf::ipc::server_t::init(std::string socket_path)
     }
 
     listen(fd, 3);
+    method_repository->register_method("wayfire/set-ipc-encoding", set_ipc_encoding);
     source = wl_event_loop_add_fd(wl_display_get_event_loop(wf::get_core().display),
         fd, WL_EVENT_READABLE, wl_loop_handle_ipc_fd_connection, &accept_new_client);
 }
@@ -47,6 +78,7 @@ wf::ipc::server_t::~server_t()
 {
     if (fd != -1)
     {
+        method_repository->unregister_method("wayfire/set-ipc-encoding");
         close(fd);
         unlink(saddr.sun_path);
         wl_event_source_remove(source);
@@ -134,7 +166,8 @@ void wf::ipc::server_t::client_disappeared(client_t *client)
 void wf::ipc::server_t::handle_incoming_message(
     client_t *client, wf::json_t message)
 {
-    client->send_json(method_repository->call_method(message["method"], message["data"], client));
+    client->send_reply(method_repository->call_method(message["method"], message["data"], client));
+    client->apply_next_encoding();
 }
 
 /* --------------------------- Per-client code ------------------------------*/
@@ -253,12 +286,21 @@ void wf::ipc::client_t::handle_fd_incoming(uint32_t event_mask)
         char *str = buffer.data() + HEADER_LEN;
 
         json_t message;
-        auto err = json_t::parse_string(std::string_view{str, len}, message);
+        auto err = (encoding == wire_encoding_t::MSGPACK) ?
+            msgpack::decode(std::string_view{str, len}, message) :
+            json_t::parse_string(std::string_view{str, len}, message);
         if (err.has_value())
         {
             json_t error;
             error["error"] = std::string("Client's message could not be parsed, error: ") + *err;
-            LOGE((std::string)error["error"], ": ", str);
+            if (encoding == wire_encoding_t::MSGPACK)
+            {
+                LOGE((std::string)error["error"]);
+            } else
+            {
+                LOGE((std::string)error["error"], ": ", str);
+            }
+
             this->send_json(error);
             ipc->client_disappeared(this);
             return;
@@ -286,6 +328,11 @@ void wf::ipc::client_t::handle_fd_incoming(uint32_t event_mask)
 
 wf::ipc::client_t::~client_t()
 {
+    if (reply_fd >= 0)
+    {
+        close(reply_fd);
+    }
+
     wl_event_source_remove(source);
     shutdown(fd, SHUT_RDWR);
     close(this->fd);
@@ -308,32 +355,117 @@ static bool write_exact(int fd, const char *buf, ssize_t n)
     return true;
 }
 
-bool wf::ipc::client_t::send_json(wf::json_t json)
+/**
+ * Write the 4-byte message header, passing @pass_fd along with it as SCM_RIGHTS.
+ */
+static bool write_header_with_fd(int fd, uint32_t len, int pass_fd)
+{
+    iovec iov = {.iov_base = &len, .iov_len = sizeof(len)};
+    char control[CMSG_SPACE(sizeof(int))] = {};
+    msghdr msg = {};
+    msg.msg_iov    = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control    = control;
+    msg.msg_controllen = sizeof(control);
+
+    cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type  = SCM_RIGHTS;
+    cmsg->cmsg_len   = CMSG_LEN(sizeof(int));
+    std::memcpy(CMSG_DATA(cmsg), &pass_fd, sizeof(int));
+
+    ssize_t w = sendmsg(fd, &msg, MSG_NOSIGNAL);
+    if (w <= 0)
+    {
+        return false;
+    }
+
+    // The fd was sent with the first byte, write the rest of the header normally.
+    return write_exact(fd, (char*)&len + w, sizeof(len) - w);
+}
+
+bool wf::ipc::client_t::send_buffer(const char *buffer, size_t size, int pass_fd)
 {
+    if (size > MAX_MESSAGE_LEN)
+    {
+        LOGE("Error sending json to client: message too long!");
+        shutdown(fd, SHUT_RDWR);
+        return false;
+    }
+
+    uint32_t len = size;
+    const bool header_sent = (pass_fd >= 0) ?
+        write_header_with_fd(fd, len, pass_fd) : write_exact(fd, (char*)&len, 4);
+    if (!header_sent || !write_exact(fd, buffer, len))
+    {
+        LOGE("Error sending json to client!");
+        shutdown(fd, SHUT_RDWR);
+        return false;
+    }
+
+    return true;
+}
+
+bool wf::ipc::client_t::send_json_with_fd(wf::json_t& json, int pass_fd)
+{
+    if (encoding == wire_encoding_t::MSGPACK)
+    {
+        std::string encoded;
+        msgpack::encode(json, encoded);
+        return send_buffer(encoded.data(), encoded.size(), pass_fd);
+    }
+
     bool status = false;
     json.map_serialized([&] (const char *buffer, size_t size)
     {
-        if (size > MAX_MESSAGE_LEN)
-        {
-            LOGE("Error sending json to client: message too long!");
-            shutdown(fd, SHUT_RDWR);
-            return;
-        }
+        status = send_buffer(buffer, size, pass_fd);
+    });
 
-        uint32_t len = size;
-        if (!write_exact(fd, (char*)&len, 4) || !write_exact(fd, buffer, len))
-        {
-            LOGE("Error sending json to client!");
-            shutdown(fd, SHUT_RDWR);
-            return;
-        }
+    return status;
+}
 
-        status = true;
-    });
+bool wf::ipc::client_t::send_json(wf::json_t json)
+{
+    return send_json_with_fd(json, -1);
+}
+
+bool wf::ipc::client_t::send_reply(wf::json_t json)
+{
+    const int pass_fd = std::exchange(reply_fd, -1);
+    const bool status = send_json_with_fd(json, pass_fd);
+    if (pass_fd >= 0)
+    {
+        close(pass_fd);
+    }
 
     return status;
 }
 
+bool wf::ipc::client_t::attach_fd_to_reply(int pass_fd)
+{
+    if (reply_fd >= 0)
+    {
+        close(reply_fd);
+    }
+
+    reply_fd = pass_fd;
+    return true;
+}
+
+void wf::ipc::client_t::set_encoding_after_reply(wire_encoding_t encoding)
+{
+    this->next_encoding = encoding;
+}
+
+void wf::ipc::client_t::apply_next_encoding()
+{
+    if (next_encoding)
+    {
+        encoding = *next_encoding;
+        next_encoding.reset();
+    }
+}
+
 namespace wf
 {
 class ipc_plugin_t : public wf::plugin_interface_t
@@ -5,11 +5,22 @@
 #include <wayland-server.h>
 #include <wayfire/plugins/common/shared-core-data.hpp>
 #include "wayfire/plugins/ipc/ipc-method-repository.hpp"
+#include <optional>
 
 namespace wf
 {
 namespace ipc
 {
+/**
+ * The encoding of the messages exchanged with a client. All clients start with JSON and may switch to
+ * MessagePack with the wayfire/set-ipc-encoding method. The framing (a 4-byte length prefix) is the same.
+ */
+enum class wire_encoding_t
+{
+    JSON,
+    MSGPACK,
+};
+
 /**
  * Represents a single connected client to the IPC socket.
  */
@@ -20,12 +31,36 @@ class client_t : public client_interface_t
     client_t(server_t *server, int client_fd);
     ~client_t();
     bool send_json(wf::json_t json) override;
+    bool attach_fd_to_reply(int pass_fd) override;
+
+    /**
+     * Send the reply to the current message, together with the file descriptor attached to it, if any.
+     */
+    bool send_reply(wf::json_t json);
+
+    /**
+     * Switch to the given encoding once the reply to the current message has been sent.
+     */
+    void set_encoding_after_reply(wire_encoding_t encoding);
+
+    /**
+     * Switch to the encoding requested with set_encoding_after_reply(), if any. Called by the server once
+     * the reply has been sent.
+     */
+    void apply_next_encoding();
 
   private:
     int fd;
     wl_event_source *source;
     server_t *ipc;
 
+    wire_encoding_t encoding = wire_encoding_t::JSON;
+    std::optional<wire_encoding_t> next_encoding;
+    // A file descriptor to be sent with the reply to the current message, or -1.
+    int reply_fd = -1;
+    bool send_buffer(const char *data, size_t size, int fd = -1);
+    bool send_json_with_fd(wf::json_t& json, int fd);
+
     int current_buffer_valid = 0;
     std::vector<char> buffer;
     int read_up_to(int n, int *available);
@@ -51,6 +86,7 @@ class server_t
     wf::shared_data::ref_ptr_t<wf::ipc::method_repository_t> method_repository;
 
     void handle_incoming_message(client_t *client, wf::json_t message);
+    wf::ipc::method_callback_full set_ipc_encoding;
 
     void client_disappeared(client_t *client);
 
@@ -9,6 +9,8 @@
 #include <wayfire/output-layout.hpp>
 #include <wayfire/core.hpp>
 #include "wayfire/plugins/ipc/ipc-method-repository.hpp"
+#include <optional>
+#include <set>
 
 namespace wf
 {
@@ -222,5 +224,72 @@ inline std::optional<wf::dimensions_t> dimensions_from_json(const wf::json_t& j)
 }
 
 #undef CHECK
+
+/**
+ * The set of fields a client wants to receive, given by an optional "fields" array of key names in the
+ * request. Methods which return large objects (e.g. the view list) only compute and send those keys.
+ * Without a "fields" array, all fields are returned.
+ */
+class json_fields_t
+{
+  public:
+    json_fields_t() = default;
+
+    /**
+     * Read the projection from the "fields" member of @data.
+     *
+     * @throws ipc_method_exception_t if "fields" is not an array of strings.
+     */
+    static json_fields_t from_request(const wf::json_t& data)
+    {
+        json_fields_t result;
+        if (!data.has_member("fields"))
+        {
+            return result;
+        }
+
+        const auto& fields = data["fields"];
+        if (!fields.is_array())
+        {
+            throw ipc_method_exception_t("Field \"fields\" does not have the correct type, expected array");
+        }
+
+        result.projection.emplace();
+        for (size_t i = 0; i < fields.size(); i++)
+        {
+            if (!fields[i].is_string())
+            {
+                throw ipc_method_exception_t("Entries of \"fields\" must be strings");
+            }
+
+            result.projection->insert((std::string)fields[i]);
+        }
+
+        return result;
+    }
+
+    /**
+     * Check whether the field with the given key should be included in the response.
+     */
+    bool wants(const std::string& key) const
+    {
+        return !projection || projection->count(key);
+    }
+
+    /**
+     * Set @object[@key] to the result of @getter if the field is wanted. The getter is not called otherwise.
+     */
+    template<class Getter>
+    void set(wf::json_t& object, const std::string& key, Getter&& getter) const
+    {
+        if (wants(key))
+        {
+            object[key] = getter();
+        }
+    }
+
+  private:
+    std::optional<std::set<std::string>> projection;
+};
 }
 }
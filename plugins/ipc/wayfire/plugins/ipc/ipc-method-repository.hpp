@@ -30,6 +30,19 @@ class client_interface_t
 {
   public:
     virtual bool send_json(json_t json) = 0;
+
+    /**
+     * Attach a file descriptor to the reply of the method which is currently being executed for this client.
+     * On success, the client takes ownership of @fd and closes it after sending.
+     *
+     * @return false if the client does not support passing file descriptors, in which case the caller keeps
+     *   ownership of @fd.
+     */
+    virtual bool attach_fd_to_reply(int fd)
+    {
+        return false;
+    }
+
     virtual ~client_interface_t() = default;
 };
 
@@ -129,10 +142,60 @@ class method_repository_t : public wf::signal::provider_t
 
             return response;
         });
+
+        register_method("batch", [this] (const wf::json_t& data, client_interface_t *client)
+        {
+            return call_batch(data, client);
+        });
     }
 
   private:
     std::map<std::string, method_callback_full> methods;
+
+    /**
+     * Execute several method calls given as {"calls": [{"method": ..., "data": ...}, ...]} and return all
+     * their responses in one reply, in the same order, as {"result": "ok", "results": [...]}.
+     *
+     * The calls are executed one after another, a failing call does not stop the rest of the batch.
+     */
+    wf::json_t call_batch(const wf::json_t& data, client_interface_t *client)
+    {
+        wf::json_t response;
+        if (!data.has_member("calls") || !data["calls"].is_array())
+        {
+            response["error"] = "Missing \"calls\" array";
+            return response;
+        }
+
+        const auto& calls = data["calls"];
+        response["result"]  = "ok";
+        response["results"] = wf::json_t::array();
+        for (size_t i = 0; i < calls.size(); i++)
+        {
+            const auto& call = calls[i];
+            if (!call.is_object() || !call.has_member("method") || !call["method"].is_string())
+            {
+                wf::json_t error;
+                error["error"] = "Missing \"method\" in batch entry";
+                response["results"].append(error);
+                continue;
+            }
+
+            auto method = (std::string)call["method"];
+            if (method == "batch")
+            {
+                wf::json_t error;
+                error["error"] = "Batches cannot be nested";
+                response["results"].append(error);
+                continue;
+            }
+
+            wf::json_t call_data = call.has_member("data") ? call["data"] : wf::json_t{};
+            response["results"].append(call_method(method, std::move(call_data), client));
+        }
+
+        return response;
+    }
 };
 
 // A few helper definitions for IPC method implementations.
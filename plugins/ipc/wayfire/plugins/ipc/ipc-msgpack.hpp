@@ -0,0 +1,456 @@
+#pragma once
+
+#include <wayfire/nonstd/json.hpp>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace wf
+{
+namespace ipc
+{
+/**
+ * A MessagePack encoding of wf::json_t, used by IPC clients which negotiated the binary wire format.
+ *
+ * Only the subset of MessagePack which maps 1:1 to JSON is supported: nil, booleans, integers, floats,
+ * strings, arrays and maps with string keys. Binary and extension types are rejected when decoding.
+ */
+namespace msgpack
+{
+namespace detail
+{
+inline void put_be(std::string& out, uint64_t value, int bytes)
+{
+    for (int i = bytes - 1; i >= 0; i--)
+    {
+        out.push_back((char)((value >> (8 * i)) & 0xff));
+    }
+}
+
+inline void put_header(std::string& out, uint64_t len, uint8_t fix, uint64_t fix_max,
+    uint8_t tag8, uint8_t tag16, uint8_t tag32)
+{
+    if (len <= fix_max)
+    {
+        out.push_back((char)(fix | len));
+    } else if (tag8 && (len <= UINT8_MAX))
+    {
+        out.push_back((char)tag8);
+        put_be(out, len, 1);
+    } else if (len <= UINT16_MAX)
+    {
+        out.push_back((char)tag16);
+        put_be(out, len, 2);
+    } else
+    {
+        out.push_back((char)tag32);
+        put_be(out, len, 4);
+    }
+}
+
+inline void put_string(std::string& out, const std::string& str)
+{
+    put_header(out, str.size(), 0xa0, 31, 0xd9, 0xda, 0xdb);
+    out.append(str);
+}
+
+inline void put_uint(std::string& out, uint64_t value)
+{
+    if (value <= 0x7f)
+    {
+        out.push_back((char)value);
+    } else if (value <= UINT8_MAX)
+    {
+        out.push_back((char)0xcc);
+        put_be(out, value, 1);
+    } else if (value <= UINT16_MAX)
+    {
+        out.push_back((char)0xcd);
+        put_be(out, value, 2);
+    } else if (value <= UINT32_MAX)
+    {
+        out.push_back((char)0xce);
+        put_be(out, value, 4);
+    } else
+    {
+        out.push_back((char)0xcf);
+        put_be(out, value, 8);
+    }
+}
+
+inline void put_int(std::string& out, int64_t value)
+{
+    if (value >= 0)
+    {
+        put_uint(out, value);
+    } else if (value >= -32)
+    {
+        out.push_back((char)(uint8_t)(int8_t)value);
+    } else if (value >= INT8_MIN)
+    {
+        out.push_back((char)0xd0);
+        put_be(out, (uint64_t)value, 1);
+    } else if (value >= INT16_MIN)
+    {
+        out.push_back((char)0xd1);
+        put_be(out, (uint64_t)value, 2);
+    } else if (value >= INT32_MIN)
+    {
+        out.push_back((char)0xd2);
+        put_be(out, (uint64_t)value, 4);
+    } else
+    {
+        out.push_back((char)0xd3);
+        put_be(out, (uint64_t)value, 8);
+    }
+}
+
+inline void put_double(std::string& out, double value)
+{
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    out.push_back((char)0xcb);
+    put_be(out, bits, 8);
+}
+
+template<class Json>
+void encode_value(const Json& value, std::string& out)
+{
+    if (value.is_object())
+    {
+        auto names = value.get_member_names();
+        put_header(out, names.size(), 0x80, 15, 0, 0xde, 0xdf);
+        for (auto& name : names)
+        {
+            put_string(out, name);
+            encode_value(value[name], out);
+        }
+    } else if (value.is_array())
+    {
+        put_header(out, value.size(), 0x90, 15, 0, 0xdc, 0xdd);
+        for (size_t i = 0; i < value.size(); i++)
+        {
+            encode_value(value[i], out);
+        }
+    } else if (value.is_string())
+    {
+        put_string(out, value.as_string());
+    } else if (value.is_bool())
+    {
+        out.push_back(value.as_bool() ? (char)0xc3 : (char)0xc2);
+    } else if (value.is_uint64())
+    {
+        put_uint(out, value.as_uint64());
+    } else if (value.is_int64())
+    {
+        put_int(out, value.as_int64());
+    } else if (value.is_double())
+    {
+        put_double(out, value.as_double());
+    } else
+    {
+        out.push_back((char)0xc0);
+    }
+}
+
+/**
+ * Sequential reader over an encoded message. All reads are bounds-checked.
+ */
+class reader_t
+{
+  public:
+    reader_t(std::string_view data) : data(data)
+    {}
+
+    bool read_be(int bytes, uint64_t& value)
+    {
+        if (data.size() - pos < (size_t)bytes)
+        {
+            return false;
+        }
+
+        value = 0;
+        for (int i = 0; i < bytes; i++)
+        {
+            value = (value << 8) | (uint8_t)data[pos++];
+        }
+
+        return true;
+    }
+
+    bool read_string(uint64_t len, std::string& value)
+    {
+        if (data.size() - pos < len)
+        {
+            return false;
+        }
+
+        value.assign(data.data() + pos, len);
+        pos += len;
+        return true;
+    }
+
+    // Every element takes at least one byte, so longer containers cannot be valid.
+    bool can_hold(uint64_t elements) const
+    {
+        return elements <= data.size() - pos;
+    }
+
+    bool at_end() const
+    {
+        return pos == data.size();
+    }
+
+  private:
+    std::string_view data;
+    size_t pos = 0;
+};
+
+// Deeper messages are rejected, so that malicious input cannot exhaust the stack.
+static constexpr int MAX_DEPTH = 64;
+
+inline std::optional<std::string> decode_value(reader_t& in, wf::json_t& out, int depth);
+
+inline std::optional<std::string> decode_array(reader_t& in, uint64_t len, wf::json_t& out, int depth)
+{
+    if (!in.can_hold(len))
+    {
+        return "array length exceeds message size";
+    }
+
+    out = wf::json_t::array();
+    for (uint64_t i = 0; i < len; i++)
+    {
+        wf::json_t element;
+        if (auto err = decode_value(in, element, depth + 1))
+        {
+            return err;
+        }
+
+        out.append(element);
+    }
+
+    return {};
+}
+
+inline std::optional<std::string> decode_map(reader_t& in, uint64_t len, wf::json_t& out, int depth)
+{
+    if (!in.can_hold(len))
+    {
+        return "map length exceeds message size";
+    }
+
+    out = wf::json_t{};
+    for (uint64_t i = 0; i < len; i++)
+    {
+        wf::json_t key;
+        if (auto err = decode_value(in, key, depth + 1))
+        {
+            return err;
+        }
+
+        if (!key.is_string())
+        {
+            return "map keys must be strings";
+        }
+
+        wf::json_t value;
+        if (auto err = decode_value(in, value, depth + 1))
+        {
+            return err;
+        }
+
+        out[key.as_string()] = value;
+    }
+
+    return {};
+}
+
+inline std::optional<std::string> decode_value(reader_t& in, wf::json_t& out, int depth)
+{
+    if (depth > MAX_DEPTH)
+    {
+        return "message is nested too deeply";
+    }
+
+    uint64_t tag;
+    if (!in.read_be(1, tag))
+    {
+        return "unexpected end of message";
+    }
+
+    uint64_t value = 0;
+    std::string str;
+    auto read_string = [&] (int len_bytes) -> std::optional<std::string>
+    {
+        uint64_t len = tag & 0x1f;
+        if ((len_bytes > 0) && !in.read_be(len_bytes, len))
+        {
+            return "unexpected end of message";
+        }
+
+        if (!in.read_string(len, str))
+        {
+            return "string length exceeds message size";
+        }
+
+        out = str;
+        return {};
+    };
+
+    if (tag <= 0x7f)
+    {
+        out = (uint64_t)tag;
+    } else if (tag >= 0xe0)
+    {
+        out = (int64_t)(int8_t)tag;
+    } else if ((tag & 0xf0) == 0x80)
+    {
+        return decode_map(in, tag & 0x0f, out, depth);
+    } else if ((tag & 0xf0) == 0x90)
+    {
+        return decode_array(in, tag & 0x0f, out, depth);
+    } else if ((tag & 0xe0) == 0xa0)
+    {
+        return read_string(0);
+    } else
+    {
+        switch (tag)
+        {
+          case 0xc0:
+            out = wf::json_t::null();
+            return {};
+
+          case 0xc2:
+            out = false;
+            return {};
+
+          case 0xc3:
+            out = true;
+            return {};
+
+          case 0xca:
+          {
+            if (!in.read_be(4, value))
+            {
+                return "unexpected end of message";
+            }
+
+            float f;
+            uint32_t bits = value;
+            std::memcpy(&f, &bits, sizeof(f));
+            out = (double)f;
+            return {};
+          }
+
+          case 0xcb:
+          {
+            if (!in.read_be(8, value))
+            {
+                return "unexpected end of message";
+            }
+
+            double d;
+            std::memcpy(&d, &value, sizeof(d));
+            out = d;
+            return {};
+          }
+
+          case 0xcc:
+          case 0xcd:
+          case 0xce:
+          case 0xcf:
+            if (!in.read_be(1 << (tag - 0xcc), value))
+            {
+                return "unexpected end of message";
+            }
+
+            out = value;
+            return {};
+
+          case 0xd0:
+          case 0xd1:
+          case 0xd2:
+          case 0xd3:
+          {
+            const int bytes = 1 << (tag - 0xd0);
+            if (!in.read_be(bytes, value))
+            {
+                return "unexpected end of message";
+            }
+
+            // Sign-extend from the encoded width.
+            const int shift = 64 - 8 * bytes;
+            out = (int64_t)(value << shift) >> shift;
+            return {};
+          }
+
+          case 0xd9:
+            return read_string(1);
+
+          case 0xda:
+            return read_string(2);
+
+          case 0xdb:
+            return read_string(4);
+
+          case 0xdc:
+          case 0xdd:
+            if (!in.read_be(tag == 0xdc ? 2 : 4, value))
+            {
+                return "unexpected end of message";
+            }
+
+            return decode_array(in, value, out, depth);
+
+          case 0xde:
+          case 0xdf:
+            if (!in.read_be(tag == 0xde ? 2 : 4, value))
+            {
+                return "unexpected end of message";
+            }
+
+            return decode_map(in, value, out, depth);
+
+          default:
+            return "unsupported MessagePack type " + std::to_string(tag);
+        }
+    }
+
+    return {};
+}
+}
+
+/**
+ * Encode @value as MessagePack and append it to @out.
+ */
+inline void encode(const wf::json_t& value, std::string& out)
+{
+    detail::encode_value(value, out);
+}
+
+/**
+ * Decode a single MessagePack value which spans all of @data.
+ *
+ * @return An error message, or nothing if the value was decoded successfully.
+ */
+inline std::optional<std::string> decode(std::string_view data, wf::json_t& out)
+{
+    detail::reader_t reader{data};
+    if (auto err = detail::decode_value(reader, out, 0))
+    {
+        return err;
+    }
+
+    if (!reader.at_end())
+    {
+        return std::string("trailing data after message");
+    }
+
+    return {};
+}
+}
+}
+}
@@ -14,6 +14,7 @@
 #include <wayfire/opengl.hpp>
 #include <wayfire/util/log.hpp>
 #include <wayfire/plugins/common/cairo-util.hpp>
+#include <wayfire/plugins/common/shared-core-data.hpp>
 #include <wayfire/scene.hpp>
 #include <wayfire/scene-render.hpp>
 
@@ -25,6 +26,7 @@ struct view_title_texture_t : public wf::custom_data_t
     wayfire_toplevel_view view;
     wf::cairo_text_t overlay;
     wf::cairo_text_t::params par;
+    wf::shared_data::ref_ptr_t<wf::raster_cache_t> raster_cache;
     bool overflow = false;
     wayfire_toplevel_view dialog; /* the texture should be rendered on top of this dialog */
 
@@ -40,7 +42,7 @@ struct view_title_texture_t : public wf::custom_data_t
 
     void update_overlay_texture()
     {
-        auto res = overlay.render_text(view->get_title(), par);
+        auto res = overlay.render_text(view->get_title(), par, raster_cache.get());
         overflow = res.width > overlay.get_size().width;
     }
 
@@ -7,6 +7,8 @@
 #include <wayfire/plugin.hpp>
 #include <wayfire/output.hpp>
 #include <wayfire/plugins/scale-signal.hpp>
+#include <wayfire/plugins/common/cairo-util.hpp>
+#include <wayfire/plugins/common/shared-core-data.hpp>
 
 namespace wf
 {
@@ -28,6 +30,8 @@ class scale_show_title_t
     wf::option_wrapper_t<int> title_font_size{"scale/title_font_size"};
     wf::option_wrapper_t<std::string> title_position{"scale/title_position"};
     wf::output_t *output;
+    /* Keeps rasterized titles around between activations of scale */
+    wf::shared_data::ref_ptr_t<wf::raster_cache_t> raster_cache;
 
   public:
     scale_show_title_t();
@@ -22,6 +22,7 @@
 #include <wayfire/plugins/common/move-drag-interface.hpp>
 #include <wayfire/plugins/common/shared-core-data.hpp>
 #include <wayfire/plugins/common/input-grab.hpp>
+#include <wayfire/plugins/common/thumbnail-node.hpp>
 
 #include <linux/input-event-codes.h>
 
@@ -39,6 +40,7 @@
 #include "wayfire/view.hpp"
 
 static constexpr const char *SCALE_TRANSFORMER = "scale";
+static constexpr const char *SCALE_THUMBNAIL   = "scale-thumbnail";
 using namespace wf::animation;
 
 class scale_animation_t : public duration_t
@@ -61,6 +63,7 @@ struct view_scale_data
 {
     int row, col;
     std::shared_ptr<wf::scene::view_2d_transformer_t> transformer;
+    std::shared_ptr<wf::thumbnail_node_t> thumbnail;
     wf::animation::simple_animation_t fade_animation;
     wf_scale_animation_attribs animation;
     enum class view_visibility_t
@@ -117,6 +120,7 @@ class wayfire_scale : public wf::per_output_plugin_instance_t,
     wf::option_wrapper_t<bool> allow_scale_zoom{"scale/allow_zoom"};
     wf::option_wrapper_t<bool> include_minimized{"scale/include_minimized"};
     wf::option_wrapper_t<bool> close_on_new_view{"scale/close_on_new_view"};
+    wf::option_wrapper_t<int> thumbnail_refresh_rate{"scale/thumbnail_refresh_rate"};
 
     /* maximum scale -- 1.0 means we will not "zoom in" on a view */
     const double max_scale_factor = 1.0;
@@ -208,6 +212,11 @@ class wayfire_scale : public wf::per_output_plugin_instance_t,
         scale_data[view].transformer = tr;
         view->get_transformed_node()->add_transformer(tr, wf::TRANSFORMER_2D + 1,
             SCALE_TRANSFORMER);
+        /* Render the view at (roughly) its scaled size below the scale transformer */
+        auto thumbnail = std::make_shared<wf::thumbnail_node_t>();
+        scale_data[view].thumbnail = thumbnail;
+        view->get_transformed_node()->add_transformer(thumbnail, wf::TRANSFORMER_2D,
+            SCALE_THUMBNAIL);
         /* Handle potentially minimized views by making them visible,
          * however, they start out as fully transparent. */
         if (view->minimized)
@@ -240,6 +249,7 @@ class wayfire_scale : public wf::per_output_plugin_instance_t,
         data.view = view;
         output->emit(&data);
         view->get_transformed_node()->rem_transformer(SCALE_TRANSFORMER);
+        view->get_transformed_node()->rem_transformer(SCALE_THUMBNAIL);
         view->disconnect(&view_unmapped);
         set_tiled_wobbly(view, false);
     }
@@ -682,6 +692,21 @@ class wayfire_scale : public wf::per_output_plugin_instance_t,
         }
     }
 
+    /* Keep the thumbnail of a view in sync with its current scale and focus state */
+    void update_thumbnail(wayfire_toplevel_view view, view_scale_data& view_data)
+    {
+        if (!view_data.thumbnail)
+        {
+            return;
+        }
+
+        view_data.thumbnail->set_display_scale(
+            std::max(view_data.transformer->scale_x, view_data.transformer->scale_y));
+        /* The focused view is refreshed on every commit, the others are rate-limited */
+        view_data.thumbnail->set_max_refresh_rate(
+            wf::find_topmost_parent(view) == current_focus_view ? 0 : (int)thumbnail_refresh_rate);
+    }
+
     /* Assign the transformer values to the view transformers */
     void transform_views()
     {
@@ -707,6 +732,7 @@ class wayfire_scale : public wf::per_output_plugin_instance_t,
                 view_data.transformer->translation_y =
                     view_data.animation.scale_animation.translation_y;
                 view_data.transformer->alpha = view_data.fade_animation;
+                update_thumbnail(view, view_data);
 
                 if ((view_data.visibility ==
                      view_scale_data::view_visibility_t::HIDING) &&
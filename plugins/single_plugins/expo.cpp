@@ -43,6 +43,7 @@ class wayfire_expo : public wf::per_output_plugin_instance_t, public wf::keyboar
     wf::option_wrapper_t<bool> keyboard_interaction{"expo/keyboard_interaction"};
     wf::option_wrapper_t<double> inactive_brightness{"expo/inactive_brightness"};
     wf::option_wrapper_t<int> transition_length{"expo/transition_length"};
+    wf::option_wrapper_t<int> background_cache_budget{"expo/background_cache_budget"};
     wf::geometry_animation_t zoom_animation{zoom_duration};
 
     wf::option_wrapper_t<bool> move_enable_snap_off{"move/enable_snap_off"};
@@ -128,12 +129,19 @@ class wayfire_expo : public wf::per_output_plugin_instance_t, public wf::keyboar
 
         setup_workspace_bindings_from_config();
         wall = std::make_unique<wf::workspace_wall_t>(this->output);
+        update_background_cache();
+        background_cache_budget.set_callback([=] () { update_background_cache(); });
 
         drag_helper->connect(&on_drag_output_focus);
         drag_helper->connect(&on_drag_snap_off);
         drag_helper->connect(&on_drag_done);
     }
 
+    void update_background_cache()
+    {
+        wall->set_background_cache_budget((size_t)std::max(0, (int)background_cache_budget) * 1024 * 1024);
+    }
+
     bool handle_toggle()
     {
         if (!state.active)
@@ -42,6 +42,23 @@ void main()
 }
 )";
 
+/* The same effect as fragment_shader, for fusing with other post hooks. */
+static const char *fused_shader_source =
+    R"(
+uniform bool invert_preserve_hue;
+
+highp vec4 invert_color(highp vec4 tex)
+{
+    if (invert_preserve_hue)
+    {
+        highp float hue = tex.a - min(tex.r, min(tex.g, tex.b)) - max(tex.r, max(tex.g, tex.b));
+        return hue + tex;
+    }
+
+    return vec4(1.0 - tex.r, 1.0 - tex.g, 1.0 - tex.b, 1.0);
+}
+)";
+
 class wayfire_invert_screen : public wf::per_output_plugin_instance_t
 {
     wf::post_hook_t hook;
@@ -87,7 +104,15 @@ class wayfire_invert_screen : public wf::per_output_plugin_instance_t
                 output->render->rem_post(&hook);
             } else
             {
-                output->render->add_post(&hook);
+                output->render->add_post(&hook, {
+                    .per_pixel = true,
+                    .shader_source   = fused_shader_source,
+                    .shader_function = "invert_color",
+                    .set_uniforms    = [=] (OpenGL::program_t& fused)
+                    {
+                        fused.uniform1i("invert_preserve_hue", preserve_hue);
+                    },
+                });
             }
 
             active = !active;
@@ -95,6 +120,15 @@ class wayfire_invert_screen : public wf::per_output_plugin_instance_t
             return true;
         };
 
+        // Post-processing may only repaint the damaged region, so the whole output has to be damaged.
+        preserve_hue.set_callback([=] ()
+        {
+            if (active)
+            {
+                output->render->damage_whole();
+            }
+        });
+
         wf::gles::run_in_context([&]
         {
             program.set_simple(OpenGL::compile_program(vertex_shader, fragment_shader));
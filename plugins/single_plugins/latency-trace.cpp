@@ -0,0 +1,394 @@
+#include <wayfire/core.hpp>
+#include <wayfire/plugin.hpp>
+#include <wayfire/output.hpp>
+#include <wayfire/output-layout.hpp>
+#include <wayfire/view.hpp>
+#include <wayfire/util.hpp>
+#include <wayfire/signal-definitions.hpp>
+#include <wayfire/nonstd/wlroots-full.hpp>
+#include "wayfire/plugins/common/shared-core-data.hpp"
+#include "wayfire/plugins/ipc/ipc-helpers.hpp"
+#include "wayfire/plugins/ipc/ipc-method-repository.hpp"
+#include <algorithm>
+#include <list>
+#include <map>
+#include <memory>
+#include <optional>
+
+namespace wf
+{
+namespace latency_trace
+{
+/**
+ * A histogram of latencies with fixed-width buckets. Latencies above the last bucket are counted in an
+ * additional overflow bucket.
+ */
+class histogram_t
+{
+  public:
+    void add(uint32_t latency, int bucket_width, int max_latency)
+    {
+        const size_t nr_buckets = std::max(1, max_latency / std::max(1, bucket_width)) + 1;
+        if (buckets.size() != nr_buckets)
+        {
+            // Configuration changed, old samples cannot be redistributed.
+            *this = {};
+            buckets.resize(nr_buckets, 0);
+        }
+
+        buckets[std::min<size_t>(latency / std::max(1, bucket_width), nr_buckets - 1)]++;
+        count++;
+        total += latency;
+        min = std::min(min, latency);
+        max = std::max(max, latency);
+    }
+
+    /**
+     * Approximate the given percentile (0..1) as the upper bound of the bucket which contains it.
+     */
+    uint32_t percentile(double p, int bucket_width) const
+    {
+        uint64_t seen = 0;
+        for (size_t i = 0; i < buckets.size(); i++)
+        {
+            seen += buckets[i];
+            if (seen >= p * count)
+            {
+                return std::min<uint32_t>((i + 1) * bucket_width, max);
+            }
+        }
+
+        return max;
+    }
+
+    wf::json_t to_json(int bucket_width) const
+    {
+        wf::json_t result;
+        result["count"] = count;
+        result["min-ms"]  = count ? min : 0;
+        result["max-ms"]  = max;
+        result["mean-ms"] = count ? (double)total / count : 0.0;
+        result["p50-ms"]  = percentile(0.5, bucket_width);
+        result["p90-ms"]  = percentile(0.9, bucket_width);
+        result["p99-ms"]  = percentile(0.99, bucket_width);
+        result["bucket-width-ms"] = bucket_width;
+        result["buckets"] = wf::json_t::array();
+        for (auto& bucket : buckets)
+        {
+            result["buckets"].append(bucket);
+        }
+
+        return result;
+    }
+
+  private:
+    std::vector<uint64_t> buckets;
+    uint64_t count = 0;
+    uint64_t total = 0;
+    uint32_t min   = UINT32_MAX;
+    uint32_t max   = 0;
+};
+
+/**
+ * An input event whose effect on the screen is being followed.
+ */
+struct trace_t
+{
+    // Device timestamp of the input event, in milliseconds.
+    uint32_t input_time;
+    std::string client;
+    // Outputs the surface was visible on when it committed.
+    std::vector<wlr_output*> outputs;
+};
+
+/**
+ * A surface which received input. Its next commit is assumed to be the reaction to the earliest input event
+ * since its last commit.
+ */
+struct traced_surface_t
+{
+    std::optional<uint32_t> pending_input;
+    wf::wl_listener_wrapper on_commit;
+    wf::wl_listener_wrapper on_destroy;
+};
+
+/**
+ * A frame which was committed to an output and contains the reaction to some input events.
+ */
+struct in_flight_frame_t
+{
+    uint64_t commit_seq;
+    std::vector<trace_t> traces;
+};
+
+struct traced_output_t
+{
+    // Traces whose surface committed, but no frame containing them was submitted yet.
+    std::vector<trace_t> committed;
+    // Frames which were submitted, but not yet presented.
+    std::list<in_flight_frame_t> in_flight;
+
+    wf::wl_listener_wrapper on_commit;
+    wf::wl_listener_wrapper on_present;
+};
+}
+}
+
+/**
+ * Measures the time from input events (as timestamped by the input device) to the presentation of the first
+ * frame which contains the client's reaction to them.
+ *
+ * An input event is attributed to the surface which has keyboard or pointer focus. The next commit of that
+ * surface is taken as the client's response, the next frame submitted on each output the surface is visible
+ * on as the frame showing it, and the presentation feedback of that frame as the time it reached the screen.
+ *
+ * The results are collected in histograms per output and per client, which can be queried with the
+ * wayfire/latency-trace/get IPC method.
+ */
+class wayfire_latency_trace : public wf::plugin_interface_t
+{
+    wf::option_wrapper_t<int> bucket_width{"latency-trace/bucket_width"};
+    wf::option_wrapper_t<int> max_latency{"latency-trace/max_latency"};
+
+    wf::shared_data::ref_ptr_t<wf::ipc::method_repository_t> ipc_repo;
+
+    std::map<wlr_surface*, std::unique_ptr<wf::latency_trace::traced_surface_t>> surfaces;
+    std::map<wlr_output*, std::unique_ptr<wf::latency_trace::traced_output_t>> outputs;
+
+    std::map<std::string, wf::latency_trace::histogram_t> by_output;
+    std::map<std::string, wf::latency_trace::histogram_t> by_client;
+    wf::latency_trace::histogram_t total;
+
+  public:
+    void init() override
+    {
+        auto& core = wf::get_core();
+        core.connect(&on_key);
+        core.connect(&on_button);
+        core.connect(&on_motion);
+        core.connect(&on_motion_absolute);
+        core.connect(&on_axis);
+        core.output_layout->connect(&on_output_added);
+        core.output_layout->connect(&on_output_removed);
+        for (auto wo : core.output_layout->get_outputs())
+        {
+            track_output(wo->handle);
+        }
+
+        ipc_repo->register_method("wayfire/latency-trace/get", ipc_get);
+        ipc_repo->register_method("wayfire/latency-trace/reset", ipc_reset);
+    }
+
+    void fini() override
+    {
+        ipc_repo->unregister_method("wayfire/latency-trace/get");
+        ipc_repo->unregister_method("wayfire/latency-trace/reset");
+        surfaces.clear();
+        outputs.clear();
+    }
+
+    void track_output(wlr_output *handle)
+    {
+        auto output = std::make_unique<wf::latency_trace::traced_output_t>();
+        output->on_commit.set_callback([=] (void *data)
+        {
+            auto ev = static_cast<wlr_output_event_commit*>(data);
+            if (ev->state->committed & WLR_OUTPUT_STATE_BUFFER)
+            {
+                handle_output_frame(handle);
+            }
+        });
+        output->on_present.set_callback([=] (void *data)
+        {
+            handle_output_present(handle, static_cast<wlr_output_event_present*>(data));
+        });
+        output->on_commit.connect(&handle->events.commit);
+        output->on_present.connect(&handle->events.present);
+        outputs[handle] = std::move(output);
+    }
+
+    wf::signal::connection_t<wf::output_added_signal> on_output_added = [=] (wf::output_added_signal *ev)
+    {
+        track_output(ev->output->handle);
+    };
+
+    wf::signal::connection_t<wf::output_removed_signal> on_output_removed =
+        [=] (wf::output_removed_signal *ev)
+    {
+        outputs.erase(ev->output->handle);
+    };
+
+    /* Input side: remember which surface received input and when. */
+    void handle_input(wlr_surface *focus, uint32_t time_msec)
+    {
+        if (!focus)
+        {
+            return;
+        }
+
+        auto& surface = surfaces[focus];
+        if (!surface)
+        {
+            surface = std::make_unique<wf::latency_trace::traced_surface_t>();
+            surface->on_commit.set_callback([=] (void*) { handle_surface_commit(focus); });
+            surface->on_destroy.set_callback([=] (void*) { surfaces.erase(focus); });
+            surface->on_commit.connect(&focus->events.commit);
+            surface->on_destroy.connect(&focus->events.destroy);
+        }
+
+        if (!surface->pending_input)
+        {
+            surface->pending_input = time_msec;
+        }
+    }
+
+    wlr_surface *keyboard_focus()
+    {
+        return wf::get_core().get_current_seat()->keyboard_state.focused_surface;
+    }
+
+    wlr_surface *pointer_focus()
+    {
+        return wf::get_core().get_current_seat()->pointer_state.focused_surface;
+    }
+
+    wf::signal::connection_t<wf::post_input_event_signal<wlr_keyboard_key_event>> on_key = [=] (auto ev)
+    {
+        if (ev->event->state == WL_KEYBOARD_KEY_STATE_PRESSED)
+        {
+            handle_input(keyboard_focus(), ev->event->time_msec);
+        }
+    };
+
+    wf::signal::connection_t<wf::post_input_event_signal<wlr_pointer_button_event>> on_button = [=] (auto ev)
+    {
+        handle_input(pointer_focus(), ev->event->time_msec);
+    };
+
+    wf::signal::connection_t<wf::post_input_event_signal<wlr_pointer_motion_event>> on_motion = [=] (auto ev)
+    {
+        handle_input(pointer_focus(), ev->event->time_msec);
+    };
+
+    wf::signal::connection_t<wf::post_input_event_signal<wlr_pointer_motion_absolute_event>>
+    on_motion_absolute = [=] (auto ev)
+    {
+        handle_input(pointer_focus(), ev->event->time_msec);
+    };
+
+    wf::signal::connection_t<wf::post_input_event_signal<wlr_pointer_axis_event>> on_axis = [=] (auto ev)
+    {
+        handle_input(pointer_focus(), ev->event->time_msec);
+    };
+
+    /* Client side: the surface reacted to the input. */
+    std::string describe_client(wlr_surface *surface)
+    {
+        if (auto view = wf::wl_surface_to_wayfire_view(surface->resource))
+        {
+            return view->get_app_id();
+        }
+
+        pid_t pid;
+        wl_client_get_credentials(wl_resource_get_client(surface->resource), &pid, NULL, NULL);
+        return "pid:" + std::to_string(pid);
+    }
+
+    void handle_surface_commit(wlr_surface *surface)
+    {
+        auto& traced = surfaces[surface];
+        if (!traced->pending_input)
+        {
+            return;
+        }
+
+        wf::latency_trace::trace_t trace;
+        trace.input_time = *traced->pending_input;
+        trace.client     = describe_client(surface);
+        traced->pending_input.reset();
+
+        wlr_surface_output *surface_output;
+        wl_list_for_each(surface_output, &surface->current_outputs, link)
+        {
+            trace.outputs.push_back(surface_output->output);
+        }
+
+        for (auto& wo : trace.outputs)
+        {
+            if (outputs.count(wo))
+            {
+                outputs[wo]->committed.push_back(trace);
+            }
+        }
+    }
+
+    /* Compositor side: a frame containing the new surface state was submitted. */
+    void handle_output_frame(wlr_output *handle)
+    {
+        auto& output = outputs[handle];
+        if (output->committed.empty())
+        {
+            return;
+        }
+
+        output->in_flight.push_back({
+            .commit_seq = handle->commit_seq,
+            .traces     = std::move(output->committed),
+        });
+        output->committed.clear();
+    }
+
+    /* Display side: the frame reached the screen. */
+    void handle_output_present(wlr_output *handle, wlr_output_event_present *ev)
+    {
+        if (!ev->presented)
+        {
+            // The frame was discarded, its contents will be shown by a later frame.
+            return;
+        }
+
+        auto& output = outputs[handle];
+        const uint32_t present_time = wf::timespec_to_msec(ev->when);
+        while (!output->in_flight.empty() && (output->in_flight.front().commit_seq <= ev->commit_seq))
+        {
+            for (auto& trace : output->in_flight.front().traces)
+            {
+                // Device timestamps are 32-bit milliseconds of CLOCK_MONOTONIC, unsigned arithmetic
+                // handles wrap-around.
+                const uint32_t latency = present_time - trace.input_time;
+                by_output[handle->name].add(latency, bucket_width, max_latency);
+                by_client[trace.client].add(latency, bucket_width, max_latency);
+                total.add(latency, bucket_width, max_latency);
+            }
+
+            output->in_flight.pop_front();
+        }
+    }
+
+    wf::ipc::method_callback ipc_get = [=] (const wf::json_t&)
+    {
+        auto response = wf::ipc::json_ok();
+        response["total"]   = total.to_json(bucket_width);
+        for (auto& [name, histogram] : by_output)
+        {
+            response["outputs"][name] = histogram.to_json(bucket_width);
+        }
+
+        for (auto& [name, histogram] : by_client)
+        {
+            response["clients"][name] = histogram.to_json(bucket_width);
+        }
+
+        return response;
+    };
+
+    wf::ipc::method_callback ipc_reset = [=] (const wf::json_t&)
+    {
+        by_output.clear();
+        by_client.clear();
+        total = {};
+        return wf::ipc::json_ok();
+    };
+};
+
+DECLARE_WAYFIRE_PLUGIN(wayfire_latency_trace);
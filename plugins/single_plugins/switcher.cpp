@@ -1,5 +1,6 @@
 #include "wayfire/object.hpp"
 #include "wayfire/plugins/common/input-grab.hpp"
+#include "wayfire/plugins/common/thumbnail-node.hpp"
 #include "wayfire/scene-input.hpp"
 #include "wayfire/scene-operations.hpp"
 #include "wayfire/scene-render.hpp"
@@ -30,6 +31,7 @@
 #include <set>
 
 constexpr const char *switcher_transformer = "switcher-3d";
+constexpr const char *switcher_thumbnail   = "switcher-thumbnail";
 constexpr const char *switcher_transformer_background = "switcher-3d";
 constexpr float background_dim_factor = 0.6;
 
@@ -112,6 +114,8 @@ class WayfireSwitcher : public wf::per_output_plugin_instance_t, public wf::keyb
     wf::option_wrapper_t<wf::animation_description_t> speed{"switcher/speed"};
     wf::option_wrapper_t<int> view_thumbnail_rotation{
         "switcher/view_thumbnail_rotation"};
+    wf::option_wrapper_t<int> thumbnail_refresh_rate{
+        "switcher/thumbnail_refresh_rate"};
 
     duration_t background_dim_duration{speed};
     timed_transition_t background_dim{background_dim_duration};
@@ -379,6 +383,7 @@ class WayfireSwitcher : public wf::per_output_plugin_instance_t, public wf::keyb
             }
 
             view->get_transformed_node()->rem_transformer(switcher_transformer);
+            view->get_transformed_node()->rem_transformer(switcher_thumbnail);
             view->get_transformed_node()->rem_transformer(
                 switcher_transformer_background);
         }
@@ -705,6 +710,9 @@ class WayfireSwitcher : public wf::per_output_plugin_instance_t, public wf::keyb
             view->get_transformed_node()->add_transformer(
                 std::make_shared<wf::scene::view_3d_transformer_t>(view),
                 wf::TRANSFORMER_3D, switcher_transformer);
+            view->get_transformed_node()->add_transformer(
+                std::make_shared<wf::thumbnail_node_t>(),
+                wf::TRANSFORMER_2D, switcher_thumbnail);
         }
 
         SwitcherView sw{speed};
@@ -744,6 +752,17 @@ class WayfireSwitcher : public wf::per_output_plugin_instance_t, public wf::keyb
             (float)sv.attribs.rotation, {0.0, 1.0, 0.0});
 
         transform->color[3] = sv.attribs.alpha;
+
+        if (auto thumbnail = sv.view->get_transformed_node()
+                ->get_transformer<wf::thumbnail_node_t>(switcher_thumbnail))
+        {
+            thumbnail->set_display_scale(
+                std::max((float)sv.attribs.scale_x, (float)sv.attribs.scale_y));
+            /* Only the selected view is refreshed on every commit */
+            thumbnail->set_max_refresh_rate(
+                sv.position == SWITCHER_POSITION_CENTER ? 0 : (int)thumbnail_refresh_rate);
+        }
+
         render_view_scene(sv.view, buffer);
     }
 
@@ -4,12 +4,184 @@
 #include <wayfire/output.hpp>
 #include <wayfire/render.hpp>
 #include <wayfire/render-manager.hpp>
+#include <wayfire/util.hpp>
 #include <wayfire/util/duration.hpp>
 #include <wayfire/config-backend.hpp>
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <linux/dma-buf.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include <cstring>
+#include <map>
+#include <memory>
+
+/**
+ * Exports the GL commands submitted so far as a sync file (EGL_ANDROID_native_fence_sync), so that the
+ * Vulkan renderer can wait for them on the GPU instead of blocking the CPU with glFinish().
+ */
+class gl_fence_exporter_t
+{
+    EGLDisplay display = EGL_NO_DISPLAY;
+    PFNEGLCREATESYNCKHRPROC create_sync = nullptr;
+    PFNEGLDESTROYSYNCKHRPROC destroy_sync     = nullptr;
+    PFNEGLDUPNATIVEFENCEFDANDROIDPROC dup_fd = nullptr;
+
+  public:
+    gl_fence_exporter_t()
+    {
+        wf::gles::run_in_context_if_gles([&]
+        {
+            display = eglGetCurrentDisplay();
+            const char *extensions = eglQueryString(display, EGL_EXTENSIONS);
+            if (!extensions || !strstr(extensions, "EGL_ANDROID_native_fence_sync"))
+            {
+                return;
+            }
+
+            create_sync  = (PFNEGLCREATESYNCKHRPROC)eglGetProcAddress("eglCreateSyncKHR");
+            destroy_sync = (PFNEGLDESTROYSYNCKHRPROC)eglGetProcAddress("eglDestroySyncKHR");
+            dup_fd = (PFNEGLDUPNATIVEFENCEFDANDROIDPROC)eglGetProcAddress("eglDupNativeFenceFDANDROID");
+        });
+    }
+
+    bool is_supported() const
+    {
+        return create_sync && destroy_sync && dup_fd;
+    }
+
+    /**
+     * Flush the GL command stream and return a sync file which is signalled once it completes, or -1 on
+     * failure. Must be called with the GL context current.
+     */
+    int export_fence()
+    {
+        if (!is_supported())
+        {
+            return -1;
+        }
+
+        const EGLint attribs[] = {
+            EGL_SYNC_NATIVE_FENCE_FD_ANDROID, EGL_NO_NATIVE_FENCE_FD_ANDROID,
+            EGL_NONE,
+        };
+
+        EGLSyncKHR sync = create_sync(display, EGL_SYNC_NATIVE_FENCE_ANDROID, attribs);
+        if (sync == EGL_NO_SYNC_KHR)
+        {
+            return -1;
+        }
+
+        // The fence fd only becomes available once the fence command has been flushed.
+        GL_CALL(glFlush());
+        int fd = dup_fd(display, sync);
+        destroy_sync(display, sync);
+        return fd == EGL_NO_NATIVE_FENCE_FD_ANDROID ? -1 : fd;
+    }
+};
+
+/**
+ * Attach @fence_fd as a write fence to all planes of @dmabuf. The Vulkan renderer picks up such implicit
+ * fences when it samples from the buffer.
+ */
+static bool attach_fence_to_dmabuf(const wlr_dmabuf_attributes& dmabuf, int fence_fd)
+{
+#ifdef DMA_BUF_IOCTL_IMPORT_SYNC_FILE
+    for (int i = 0; i < dmabuf.n_planes; i++)
+    {
+        dma_buf_import_sync_file data{};
+        data.flags = DMA_BUF_SYNC_WRITE;
+        data.fd    = fence_fd;
+        if (ioctl(dmabuf.fd[i], DMA_BUF_IOCTL_IMPORT_SYNC_FILE, &data) != 0)
+        {
+            return false;
+        }
+    }
+
+    return true;
+#else
+    (void)dmabuf;
+    (void)fence_fd;
+    return false;
+#endif
+}
 
 class wayfire_passthrough_screen : public wf::per_output_plugin_instance_t
 {
     wlr_renderer *vk_renderer = NULL;
+    std::unique_ptr<gl_fence_exporter_t> fence_exporter;
+    // Set once attaching a fence failed, from then on we fall back to glFinish().
+    bool fences_broken = false;
+
+    /**
+     * A Vulkan texture imported from one of the render manager's postprocessing buffers. The buffers are
+     * reused across frames, so the import is kept until the buffer is destroyed.
+     */
+    struct imported_texture_t
+    {
+        wlr_texture *texture = NULL;
+        wf::wl_listener_wrapper on_buffer_destroy;
+
+        ~imported_texture_t()
+        {
+            wlr_texture_destroy(texture);
+        }
+    };
+
+    std::map<wlr_buffer*, std::unique_ptr<imported_texture_t>> imported;
+
+    wlr_texture *get_vk_texture(wlr_buffer *buffer, const wlr_dmabuf_attributes& dmabuf)
+    {
+        auto it = imported.find(buffer);
+        if (it != imported.end())
+        {
+            return it->second->texture;
+        }
+
+        auto vk_tex = wlr_texture_from_dmabuf(vk_renderer, (wlr_dmabuf_attributes*)&dmabuf);
+        if (!vk_tex)
+        {
+            return NULL;
+        }
+
+        auto entry = std::make_unique<imported_texture_t>();
+        entry->texture = vk_tex;
+        entry->on_buffer_destroy.set_callback([=] (void*)
+        {
+            imported.erase(buffer);
+        });
+        entry->on_buffer_destroy.connect(&buffer->events.destroy);
+        imported[buffer] = std::move(entry);
+        return vk_tex;
+    }
+
+    /**
+     * Make sure the Vulkan renderer sees the finished contents of @dmabuf.
+     */
+    void sync_with_gl(const wlr_dmabuf_attributes& dmabuf)
+    {
+        wf::gles::run_in_context_if_gles([&]
+        {
+            if (!fences_broken)
+            {
+                int fence_fd = fence_exporter->export_fence();
+                if (fence_fd >= 0)
+                {
+                    const bool attached = attach_fence_to_dmabuf(dmabuf, fence_fd);
+                    close(fence_fd);
+                    if (attached)
+                    {
+                        return;
+                    }
+                }
+
+                LOGW("vk-color-management: cannot use sync files, falling back to glFinish()");
+                fences_broken = true;
+            }
+
+            GL_CALL(glFinish());
+        });
+    }
 
   public:
     void init() override
@@ -20,24 +192,34 @@ class wayfire_passthrough_screen : public wf::per_output_plugin_instance_t
             return;
         }
 
-        output->render->add_post(&render_hook);
+        // The color transform works on each pixel separately, so only the damaged part has to be converted.
+        output->render->add_post(&render_hook, {
+            .transform_damage = [] (const wf::region_t& damage) { return damage; },
+        });
 
         vk_renderer = wlr_vk_renderer_create_with_drm_fd(wlr_renderer_get_drm_fd(wf::get_core().renderer));
+        fence_exporter = std::make_unique<gl_fence_exporter_t>();
+        fences_broken  = !fence_exporter->is_supported();
     }
 
     wf::post_hook_t render_hook = [=] (wf::auxilliary_buffer_t& source,
                                        const wf::render_buffer_t& destination)
     {
-        GL_CALL(glFinish());
-        wlr_dmabuf_attributes dmabuf{};
+        const auto& damage = output->render->get_post_damage();
+        if (damage.empty())
+        {
+            return;
+        }
 
+        wlr_dmabuf_attributes dmabuf{};
         if (!wlr_buffer_get_dmabuf(source.get_buffer(), &dmabuf))
         {
             LOGE("Failed to get dmabuf!");
             return;
         }
 
-        auto vk_tex = wlr_texture_from_dmabuf(vk_renderer, &dmabuf);
+        sync_with_gl(dmabuf);
+        auto vk_tex = get_vk_texture(source.get_buffer(), dmabuf);
         if (!vk_tex)
         {
             LOGE("Failed to create vk texture!");
@@ -63,18 +245,19 @@ class wayfire_passthrough_screen : public wf::per_output_plugin_instance_t
         tex.filter_mode = WLR_SCALE_FILTER_BILINEAR; // Use bilinear filtering for a smooth copy
         tex.transform   = WL_OUTPUT_TRANSFORM_NORMAL;
         tex.alpha = NULL;
-        tex.clip  = NULL;
+        // Only the damaged part of the destination needs to be updated
+        tex.clip = damage.to_pixman();
         wlr_render_pass_add_texture(pass, &tex);
         wlr_render_pass_submit(pass);
-        wlr_texture_destroy(vk_tex);
     };
 
     void fini() override
     {
         if (vk_renderer)
         {
-            wlr_renderer_destroy(vk_renderer);
             output->render->rem_post(&render_hook);
+            imported.clear();
+            wlr_renderer_destroy(vk_renderer);
         }
     }
 };
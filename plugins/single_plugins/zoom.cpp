@@ -3,6 +3,8 @@
 #include <wayfire/render.hpp>
 #include <wayfire/render-manager.hpp>
 #include <wayfire/util/duration.hpp>
+#include <wayfire/signal-definitions.hpp>
+#include <cmath>
 
 class wayfire_zoom_screen : public wf::per_output_plugin_instance_t
 {
@@ -19,6 +21,10 @@ class wayfire_zoom_screen : public wf::per_output_plugin_instance_t
     wf::animation::simple_animation_t progression{smoothing_duration};
     bool hook_set = false;
 
+    // The part of the output (in buffer coordinates) which is magnified in the current frame.
+    wf::geometry_t source_box = {0, 0, 0, 0};
+    wf::dimensions_t buffer_size = {0, 0};
+
     wf::plugin_activation_data_t grab_interface = {
         .name = "zoom",
         .capabilities = 0,
@@ -29,6 +35,13 @@ class wayfire_zoom_screen : public wf::per_output_plugin_instance_t
     {
         progression.set(1, 1);
         output->add_axis(modifier, &axis);
+        interpolation_method.set_callback([=] ()
+        {
+            if (hook_set)
+            {
+                output->render->damage_whole();
+            }
+        });
     }
 
     void update_zoom_target(float delta)
@@ -44,9 +57,18 @@ class wayfire_zoom_screen : public wf::per_output_plugin_instance_t
             if (!hook_set)
             {
                 hook_set = true;
-                output->render->add_post(&render_hook);
-                output->render->set_redraw_always();
+                output->render->add_post(&render_hook, {
+                    .transform_damage = [=] (const wf::region_t& damage)
+                    {
+                        return transform_damage(damage);
+                    },
+                });
+                output->render->add_effect(&pre_hook, wf::OUTPUT_EFFECT_PRE);
+                wf::get_core().connect(&on_motion);
+                wf::get_core().connect(&on_motion_absolute);
             }
+
+            output->render->schedule_redraw();
         }
     }
 
@@ -67,17 +89,11 @@ class wayfire_zoom_screen : public wf::per_output_plugin_instance_t
         return true;
     };
 
-    wf::post_hook_t render_hook = [=] (wf::auxilliary_buffer_t& source,
-                                       const wf::render_buffer_t& destination)
+    /**
+     * Compute the magnified part of the output for the current cursor position and zoom level.
+     */
+    wf::geometry_t compute_source_box(float w, float h)
     {
-        auto w = destination.get_size().width;
-        auto h = destination.get_size().height;
-        if ((w <= 0) || (h <= 0))
-        {
-            LOGE("Invalid output size in zoom plugin!");
-            return;
-        }
-
         auto oc = output->get_cursor_position();
         double x, y;
         wlr_box b = wf::to_integer_box(output->get_relative_geometry());
@@ -97,27 +113,105 @@ class wayfire_zoom_screen : public wf::per_output_plugin_instance_t
         const float y1     = std::clamp(float(y * scale), 0.0f, h - 1.0f);
         const float tw     = std::clamp(w / factor, 0.0f, w - x1);
         const float th     = std::clamp(h / factor, 0.0f, h - y1);
-        auto filter_mode   = (interpolation_method == (int)interpolation_method_t::NEAREST) ?
-            WLR_SCALE_FILTER_NEAREST : WLR_SCALE_FILTER_BILINEAR;
-        destination.blit(source, {x1, y1, tw, th}, {0.0, 0.0, (double)w, (double)h}, filter_mode);
+        return {x1, y1, tw, th};
+    }
+
+    /**
+     * Map damage on the unzoomed output to the part of the zoomed output which shows it.
+     */
+    wf::region_t transform_damage(const wf::region_t& damage)
+    {
+        if ((source_box.width <= 0) || (source_box.height <= 0))
+        {
+            return wf::region_t{wlr_box{0, 0, buffer_size.width, buffer_size.height}};
+        }
+
+        const double sx = buffer_size.width / source_box.width;
+        const double sy = buffer_size.height / source_box.height;
+
+        wf::region_t result;
+        for (const auto& box : damage)
+        {
+            // Filtering samples neighbouring pixels as well, so grow the damage by one source pixel.
+            const int x1 = std::floor((box.x1 - 1 - source_box.x) * sx);
+            const int y1 = std::floor((box.y1 - 1 - source_box.y) * sy);
+            const int x2 = std::ceil((box.x2 + 1 - source_box.x) * sx);
+            const int y2 = std::ceil((box.y2 + 1 - source_box.y) * sy);
+            result |= wlr_box{x1, y1, x2 - x1, y2 - y1};
+        }
+
+        return result;
+    }
+
+    /**
+     * Update the magnified region at the start of each frame. If it changed (or the zoom level is animating),
+     * everything on screen moves, so the whole output is damaged. Otherwise, only damage from the scene is
+     * re-sampled.
+     */
+    wf::effect_hook_t pre_hook = [=] ()
+    {
         if (!progression.running() && (progression - 1 <= 0.01))
         {
             unset_hook();
+            return;
+        }
+
+        buffer_size = output->render->get_target_framebuffer().get_size();
+        auto new_box = compute_source_box(buffer_size.width, buffer_size.height);
+        if ((new_box != source_box) || progression.running())
+        {
+            source_box = new_box;
+            output->render->damage_whole();
+        }
+    };
+
+    /* The magnified region follows the cursor, check it again on the next frame. */
+    wf::signal::connection_t<wf::post_input_event_signal<wlr_pointer_motion_event>> on_motion = [=] (auto)
+    {
+        output->render->schedule_redraw();
+    };
+
+    wf::signal::connection_t<wf::post_input_event_signal<wlr_pointer_motion_absolute_event>>
+    on_motion_absolute = [=] (auto)
+    {
+        output->render->schedule_redraw();
+    };
+
+    wf::post_hook_t render_hook = [=] (wf::auxilliary_buffer_t& source,
+                                       const wf::render_buffer_t& destination)
+    {
+        auto w = destination.get_size().width;
+        auto h = destination.get_size().height;
+        if ((w <= 0) || (h <= 0))
+        {
+            LOGE("Invalid output size in zoom plugin!");
+            return;
+        }
+
+        auto filter_mode = (interpolation_method == (int)interpolation_method_t::NEAREST) ?
+            WLR_SCALE_FILTER_NEAREST : WLR_SCALE_FILTER_BILINEAR;
+        const auto& clip = output->render->get_post_damage();
+        if (!clip.empty())
+        {
+            destination.blit(source, source_box, {0.0, 0.0, (double)w, (double)h}, filter_mode, &clip);
         }
     };
 
     void unset_hook()
     {
-        output->render->set_redraw_always(false);
+        output->render->rem_effect(&pre_hook);
         output->render->rem_post(&render_hook);
-        hook_set = false;
+        on_motion.disconnect();
+        on_motion_absolute.disconnect();
+        source_box = {0, 0, 0, 0};
+        hook_set   = false;
     }
 
     void fini() override
     {
         if (hook_set)
         {
-            output->render->rem_post(&render_hook);
+            unset_hook();
         }
 
         output->rem_binding(&axis);
@@ -172,8 +172,6 @@ class drag_manager_t
         }
 
         {
-            autocommit_transaction_t tx;
-
             auto old_tile_a = view_node_t::get_node(a);
             auto old_tile_b = view_node_t::get_node(b);
             auto parent_a   = old_tile_a->parent;
@@ -188,11 +186,11 @@ class drag_manager_t
 
             auto new_b = std::make_unique<tile::view_node_t>(b);
             new_b->set_gaps(gaps_a);
-            new_b->set_geometry(geometry_a, tx.tx);
+            new_b->set_geometry(geometry_a);
 
             auto new_a = std::make_unique<tile::view_node_t>(a);
             new_a->set_gaps(gaps_b);
-            new_a->set_geometry(geometry_b, tx.tx);
+            new_a->set_geometry(geometry_b);
 
             new_a->parent = parent_b;
             new_b->parent = parent_a;
@@ -229,7 +227,6 @@ class drag_manager_t
             move_tiled_view(source, target_output);
         }
 
-        autocommit_transaction_t tx;
         auto split_type = (split == INSERT_LEFT || split == INSERT_RIGHT) ?
             SPLIT_VERTICAL : SPLIT_HORIZONTAL;
 
@@ -237,7 +234,7 @@ class drag_manager_t
         if (target->parent->get_split_direction() == split_type)
         {
             /* We can simply add the dragged view as a sibling of the target view */
-            auto src = source_node->parent->remove_child(source_node, tx.tx);
+            auto src = source_node->parent->remove_child(source_node);
 
             int idx = find_idx(target);
             if ((split == INSERT_RIGHT) || (split == INSERT_BELOW))
@@ -245,7 +242,7 @@ class drag_manager_t
                 ++idx;
             }
 
-            target->parent->add_child(std::move(src), tx.tx, idx);
+            target->parent->add_child(std::move(src), idx);
         } else
         {
             /* Case 2: we need a new split just for the dropped on and the dragged
@@ -253,32 +250,32 @@ class drag_manager_t
             auto new_split = std::make_unique<split_node_t>(split_type);
             /* The size will be autodetermined by the tree structure, but we set
              * some valid size here to avoid UB */
-            new_split->set_geometry(target->geometry, tx.tx);
+            new_split->set_geometry(target->geometry);
 
             /* Find the position of the dropped view and its parent */
             int idx = find_idx(target);
             auto dropped_parent = target->parent;
 
             /* Remove both views */
-            auto dropped_view = target->parent->remove_child(target, tx.tx);
-            auto dragged_view = source_node->parent->remove_child(source_node, tx.tx);
+            auto dropped_view = target->parent->remove_child(target);
+            auto dragged_view = source_node->parent->remove_child(source_node);
 
             if ((split == INSERT_ABOVE) || (split == INSERT_LEFT))
             {
-                new_split->add_child(std::move(dragged_view), tx.tx);
-                new_split->add_child(std::move(dropped_view), tx.tx);
+                new_split->add_child(std::move(dragged_view));
+                new_split->add_child(std::move(dropped_view));
             } else
             {
-                new_split->add_child(std::move(dropped_view), tx.tx);
-                new_split->add_child(std::move(dragged_view), tx.tx);
+                new_split->add_child(std::move(dropped_view));
+                new_split->add_child(std::move(dragged_view));
             }
 
             /* Put them in place */
-            dropped_parent->add_child(std::move(new_split), tx.tx, idx);
+            dropped_parent->add_child(std::move(new_split), idx);
         }
 
-        tile_workspace_set_data_t::get(source_output).refresh(tx.tx);
-        tile_workspace_set_data_t::get(target_output).refresh(tx.tx);
+        tile_workspace_set_data_t::get(source_output).refresh();
+        tile_workspace_set_data_t::get(target_output).refresh();
 
         if (source_output != target_output)
         {
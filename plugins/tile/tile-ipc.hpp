@@ -331,7 +331,6 @@ inline wf::json_t handle_ipc_set_layout(json_t params)
     tile_ws.detach_views(views_to_remove);
 
     {
-        autocommit_transaction_t tx;
         data.touched_wsets.erase(nullptr);
 
         // Step 2: temporarily detach some of the nodes
@@ -340,7 +339,7 @@ inline wf::json_t handle_ipc_set_layout(json_t params)
             auto tile = wf::tile::view_node_t::get_node(touched_view);
             if (tile)
             {
-                tile->parent->remove_child(tile, tx.tx);
+                tile->parent->remove_child(tile);
             }
 
             if (touched_view->get_wset().get() != ws)
@@ -364,7 +363,7 @@ inline wf::json_t handle_ipc_set_layout(json_t params)
             static_cast<int>(y)});
         tile::flatten_tree(tile_ws.roots[x][y]);
         tile_ws.roots[x][y]->set_gaps(tile_ws.get_gaps());
-        tile_ws.roots[x][y]->set_geometry(workarea, tx.tx);
+        tile_ws.roots[x][y]->set_geometry(workarea);
     }
 
     data.touched_wsets.insert(ws);
@@ -308,13 +308,11 @@ class tile_output_plugin_t : public wf::pointer_interaction_t, public wf::custom
 
             if (was_maximized)
             {
-                autocommit_transaction_t tx;
-
                 current_node->show_maximized = false;
-                current_node->set_geometry(current_node->geometry, tx.tx);
+                current_node->mark_dirty();
 
                 adjacent->show_maximized = true;
-                adjacent->set_geometry(adjacent->geometry, tx.tx);
+                adjacent->mark_dirty();
             }
 
             /* This will lower the fullscreen status of the view */
@@ -458,6 +456,7 @@ class tile_plugin_t : public wf::plugin_interface_t, wf::per_output_tracker_mixi
             wo->erase_data<tile_output_plugin_t>();
         }
 
+        wf::get_core().erase_data<tile::layout_scheduler_t>();
         ipc_repo->unregister_method("simple-tile/get-layout");
         ipc_repo->unregister_method("simple-tile/set-layout");
         ipc_repo->unregister_method("simple-tile/set-show-maximized");
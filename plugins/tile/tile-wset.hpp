@@ -3,29 +3,10 @@
 #include "tree.hpp"
 #include "tree-controller.hpp"
 #include "wayfire/view-helpers.hpp"
-#include "wayfire/txn/transaction-manager.hpp"
 #include "wayfire/scene-operations.hpp"
 #include <wayfire/workarea.hpp>
 #include <wayfire/window-manager.hpp>
 
-struct autocommit_transaction_t
-{
-  public:
-    wf::txn::transaction_uptr tx;
-    autocommit_transaction_t()
-    {
-        tx = wf::txn::transaction_t::create();
-    }
-
-    ~autocommit_transaction_t()
-    {
-        if (!tx->get_objects().empty())
-        {
-            wf::get_core().tx_manager->schedule_transaction(std::move(tx));
-        }
-    }
-};
-
 namespace wf
 {
 /**
@@ -151,8 +132,7 @@ class tile_workspace_set_data_t : public wf::custom_data_t
                 vp_geometry.x += i * output_geometry.width;
                 vp_geometry.y += j * output_geometry.height;
 
-                autocommit_transaction_t tx;
-                roots[i][j]->set_geometry(vp_geometry, tx.tx);
+                roots[i][j]->set_geometry(vp_geometry);
             }
         }
     }
@@ -181,28 +161,27 @@ class tile_workspace_set_data_t : public wf::custom_data_t
         };
     }
 
-    void update_gaps_with_tx(wf::txn::transaction_uptr& tx)
+    void refresh_gaps()
     {
         for (auto& col : roots)
         {
             for (auto& root : col)
             {
                 root->set_gaps(get_gaps());
-                root->set_geometry(root->geometry, tx);
+                root->set_geometry(root->geometry);
             }
         }
     }
 
-    void refresh(wf::txn::transaction_uptr& tx)
+    void refresh()
     {
         flatten_roots();
-        update_gaps_with_tx(tx);
+        refresh_gaps();
     }
 
     std::function<void()> update_gaps = [=] ()
     {
-        autocommit_transaction_t tx;
-        update_gaps_with_tx(tx.tx);
+        refresh_gaps();
     };
 
     void flatten_roots()
@@ -262,10 +241,7 @@ class tile_workspace_set_data_t : public wf::custom_data_t
     {
         auto vp = _vp.value_or(wset.lock()->get_current_workspace());
         auto view_node = setup_view_tiling(view, vp);
-        {
-            autocommit_transaction_t tx;
-            roots[vp.x][vp.y]->as_split_node()->add_child(std::move(view_node), tx.tx);
-        }
+        roots[vp.x][vp.y]->as_split_node()->add_child(std::move(view_node));
 
         consider_exit_fullscreen(view);
         unmaximize_all_views_on_workspace();
@@ -275,24 +251,21 @@ class tile_workspace_set_data_t : public wf::custom_data_t
     void detach_views(std::vector<nonstd::observer_ptr<tile::view_node_t>> views,
         bool reinsert = true)
     {
+        for (auto& v : views)
         {
-            autocommit_transaction_t tx;
-            for (auto& v : views)
-            {
-                auto view = v->view;
-                view->set_allowed_actions(VIEW_ALLOW_ALL);
-                // After this, `v` is freed.
-                v->parent->remove_child(v, tx.tx);
+            auto view = v->view;
+            view->set_allowed_actions(VIEW_ALLOW_ALL);
+            // After this, `v` is freed.
+            v->parent->remove_child(v);
 
-                if (view->pending_fullscreen() && view->is_mapped())
-                {
-                    wf::get_core().default_wm->fullscreen_request(view, nullptr, false);
-                }
+            if (view->pending_fullscreen() && view->is_mapped())
+            {
+                wf::get_core().default_wm->fullscreen_request(view, nullptr, false);
+            }
 
-                if (reinsert && view->get_output())
-                {
-                    wf::scene::readd_front(view->get_output()->wset()->get_node(), view->get_root_node());
-                }
+            if (reinsert && view->get_output())
+            {
+                wf::scene::readd_front(view->get_output()->wset()->get_node(), view->get_root_node());
             }
         }
 
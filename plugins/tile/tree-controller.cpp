@@ -9,7 +9,6 @@
 #include <wayfire/util.hpp>
 #include <wayfire/nonstd/reverse.hpp>
 #include <wayfire/plugins/common/preview-indication.hpp>
-#include <wayfire/txn/transaction-manager.hpp>
 
 namespace wf
 {
@@ -153,10 +152,16 @@ resize_view_controller_t::resize_view_controller_t(wf::workspace_set_t *wset, wa
         horizontal_pair = this->find_resizing_pair(true);
         vertical_pair   = this->find_resizing_pair(false);
     }
+
+    /* Pointer motion events usually arrive much faster than the output refreshes,
+     * so apply the resized layout at most once per frame. */
+    layout_scheduler_t::get().throttle_to(this->output);
 }
 
 resize_view_controller_t::~resize_view_controller_t()
-{}
+{
+    layout_scheduler_t::get().throttle_to(nullptr);
+}
 
 uint32_t resize_view_controller_t::calculate_resizing_edges(wf::pointf_t grab)
 {
@@ -299,7 +304,6 @@ void resize_view_controller_t::input_motion()
         return;
     }
 
-    auto tx = wf::txn::transaction_t::create();
     if (horizontal_pair.first && horizontal_pair.second)
     {
         double dy = input.y - last_point.y;
@@ -308,8 +312,8 @@ void resize_view_controller_t::input_motion()
         auto g2 = horizontal_pair.second->geometry;
 
         adjust_geometry(g1.y, g1.height, g2.y, g2.height, dy);
-        horizontal_pair.first->set_geometry(g1, tx);
-        horizontal_pair.second->set_geometry(g2, tx);
+        horizontal_pair.first->set_geometry(g1);
+        horizontal_pair.second->set_geometry(g2);
     }
 
     if (vertical_pair.first && vertical_pair.second)
@@ -320,11 +324,10 @@ void resize_view_controller_t::input_motion()
         auto g2 = vertical_pair.second->geometry;
 
         adjust_geometry(g1.x, g1.width, g2.x, g2.width, dx);
-        vertical_pair.first->set_geometry(g1, tx);
-        vertical_pair.second->set_geometry(g2, tx);
+        vertical_pair.first->set_geometry(g1);
+        vertical_pair.second->set_geometry(g2);
     }
 
-    wf::get_core().tx_manager->schedule_transaction(std::move(tx));
     this->last_point = input;
 }
 
@@ -14,12 +14,13 @@
 #include <wayfire/toplevel.hpp>
 #include <wayfire/txn/transaction-manager.hpp>
 #include <wayfire/window-manager.hpp>
+#include <algorithm>
 
 namespace wf
 {
 namespace tile
 {
-void tree_node_t::set_geometry(wf::geometry_t geometry, wf::txn::transaction_uptr&)
+void tree_node_t::set_geometry(wf::geometry_t geometry)
 {
     this->geometry = geometry;
 }
@@ -90,7 +91,7 @@ int32_t split_node_t::calculate_splittable() const
     return calculate_splittable(this->geometry);
 }
 
-void split_node_t::recalculate_children(wf::geometry_t available, wf::txn::transaction_uptr& tx)
+void split_node_t::recalculate_children(wf::geometry_t available)
 {
     if (this->children.empty())
     {
@@ -126,11 +127,11 @@ void split_node_t::recalculate_children(wf::geometry_t available, wf::txn::trans
 
         /* Set new size */
         int32_t child_size = child_end - child_start;
-        child->set_geometry(get_child_geometry(child_start, child_size), tx);
+        child->set_geometry(get_child_geometry(child_start, child_size));
     }
 }
 
-void split_node_t::add_child(std::unique_ptr<tree_node_t> child, wf::txn::transaction_uptr& tx, int index)
+void split_node_t::add_child(std::unique_ptr<tree_node_t> child, int index)
 {
     /*
      * Strategy:
@@ -166,11 +167,10 @@ void split_node_t::add_child(std::unique_ptr<tree_node_t> child, wf::txn::transa
     set_gaps(this->gaps);
 
     /* Recalculate geometry */
-    recalculate_children(geometry, tx);
+    recalculate_children(geometry);
 }
 
-std::unique_ptr<tree_node_t> split_node_t::remove_child(
-    nonstd::observer_ptr<tree_node_t> child, wf::txn::transaction_uptr& tx)
+std::unique_ptr<tree_node_t> split_node_t::remove_child(nonstd::observer_ptr<tree_node_t> child)
 {
     /* Remove child */
     std::unique_ptr<tree_node_t> result;
@@ -189,16 +189,16 @@ std::unique_ptr<tree_node_t> split_node_t::remove_child(
     }
 
     /* Remaining children have the full geometry */
-    recalculate_children(this->geometry, tx);
+    recalculate_children(this->geometry);
     result->parent = nullptr;
 
     return result;
 }
 
-void split_node_t::set_geometry(wf::geometry_t geometry, wf::txn::transaction_uptr& tx)
+void split_node_t::set_geometry(wf::geometry_t geometry)
 {
-    tree_node_t::set_geometry(geometry, tx);
-    recalculate_children(geometry, tx);
+    tree_node_t::set_geometry(geometry);
+    recalculate_children(geometry);
 }
 
 void split_node_t::set_gaps(const gap_size_t& gaps)
@@ -356,6 +356,7 @@ view_node_t::view_node_t(wayfire_toplevel_view view)
 
 view_node_t::~view_node_t()
 {
+    layout_scheduler_t::get().forget(this);
     view->get_transformed_node()->rem_transformer(scale_transformer_name);
     view->erase_data<view_node_custom_data_t>();
 }
@@ -478,10 +479,19 @@ static nonstd::observer_ptr<wf::grid::grid_animation_t> ensure_animation(
     return view->get_data<wf::grid::grid_animation_t>();
 }
 
-void view_node_t::set_geometry(wf::geometry_t geometry, wf::txn::transaction_uptr& tx)
+void view_node_t::set_geometry(wf::geometry_t geometry)
 {
-    tree_node_t::set_geometry(geometry, tx);
+    tree_node_t::set_geometry(geometry);
+    mark_dirty();
+}
 
+void view_node_t::mark_dirty()
+{
+    layout_scheduler_t::get().mark_dirty(this);
+}
+
+void view_node_t::apply_geometry(wf::txn::transaction_uptr& tx)
+{
     if (!view->is_mapped())
     {
         return;
@@ -540,6 +550,115 @@ nonstd::observer_ptr<view_node_t> view_node_t::get_node(wayfire_view view)
     return view->get_data<view_node_custom_data_t>()->ptr;
 }
 
+/* ---------------------- layout_scheduler_t implementation ----------------- */
+layout_scheduler_t::layout_scheduler_t()
+{
+    idle_flush.set_callback([=] () { flush(); });
+    on_frame = [=] ()
+    {
+        remove_frame_hook();
+        flush();
+    };
+}
+
+layout_scheduler_t::~layout_scheduler_t()
+{
+    remove_frame_hook();
+}
+
+layout_scheduler_t& layout_scheduler_t::get()
+{
+    return *wf::get_core().get_data_safe<layout_scheduler_t>();
+}
+
+void layout_scheduler_t::mark_dirty(view_node_t *node)
+{
+    if (!node->layout_dirty)
+    {
+        node->layout_dirty = true;
+        dirty.push_back(node);
+    }
+
+    schedule_flush();
+}
+
+void layout_scheduler_t::forget(view_node_t *node)
+{
+    if (node->layout_dirty)
+    {
+        node->layout_dirty = false;
+        dirty.erase(std::remove(dirty.begin(), dirty.end(), node), dirty.end());
+    }
+}
+
+void layout_scheduler_t::throttle_to(wf::output_t *output)
+{
+    if (output == throttle_output)
+    {
+        return;
+    }
+
+    remove_frame_hook();
+    throttle_output = output;
+    if (!dirty.empty())
+    {
+        schedule_flush();
+    }
+}
+
+void layout_scheduler_t::schedule_flush()
+{
+    if (!throttle_output)
+    {
+        idle_flush.run_once();
+        return;
+    }
+
+    if (!frame_hook_active)
+    {
+        throttle_output->render->add_effect(&on_frame, wf::OUTPUT_EFFECT_PRE);
+        throttle_output->render->schedule_redraw();
+        frame_hook_active = true;
+    }
+}
+
+void layout_scheduler_t::remove_frame_hook()
+{
+    if (frame_hook_active)
+    {
+        throttle_output->render->rem_effect(&on_frame);
+        frame_hook_active = false;
+    }
+}
+
+void layout_scheduler_t::flush()
+{
+    idle_flush.disconnect();
+    if (dirty.empty())
+    {
+        return;
+    }
+
+    // Nodes may be marked dirty again while applying the layout, they will be handled by the next flush.
+    auto nodes = std::move(dirty);
+    dirty.clear();
+    for (auto& node : nodes)
+    {
+        node->layout_dirty = false;
+    }
+
+    auto tx = wf::txn::transaction_t::create();
+    for (auto& node : nodes)
+    {
+        node->apply_geometry(tx);
+    }
+
+    if (!tx->get_objects().empty())
+    {
+        wf::get_core().tx_manager->schedule_transaction(std::move(tx));
+    }
+}
+
 /* ----------------- Generic tree operations implementation ----------------- */
 bool flatten_tree(std::unique_ptr<tree_node_t>& root)
 {
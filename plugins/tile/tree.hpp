@@ -7,6 +7,8 @@
 #include <wayfire/view.hpp>
 #include <wayfire/option-wrapper.hpp>
 #include <wayfire/txn/transaction.hpp>
+#include <wayfire/render-manager.hpp>
+#include <wayfire/util.hpp>
 
 namespace wf
 {
@@ -48,8 +50,13 @@ struct tree_node_t
     /** The geometry occupied by the node */
     wf::geometry_t geometry;
 
-    /** Set the geometry available for the node and its subnodes. */
-    virtual void set_geometry(wf::geometry_t geometry, wf::txn::transaction_uptr& tx);
+    /**
+     * Set the geometry available for the node and its subnodes.
+     *
+     * The geometry of the tree nodes is updated immediately, but views are only resized once the layout is
+     * applied by the layout_scheduler_t.
+     */
+    virtual void set_geometry(wf::geometry_t geometry);
 
     /** Set the gaps for the node and subnodes. */
     virtual void set_gaps(const gap_size_t& gaps) = 0;
@@ -96,20 +103,19 @@ struct split_node_t : public tree_node_t
      * @param index The index at which to insert the new child, or -1 for
      *              adding to the end of the child list.
      */
-    void add_child(std::unique_ptr<tree_node_t> child, wf::txn::transaction_uptr& tx, int index = -1);
+    void add_child(std::unique_ptr<tree_node_t> child, int index = -1);
 
     /**
      * Remove a child from the node, and return its unique_ptr
      */
-    std::unique_ptr<tree_node_t> remove_child(
-        nonstd::observer_ptr<tree_node_t> child, wf::txn::transaction_uptr& tx);
+    std::unique_ptr<tree_node_t> remove_child(nonstd::observer_ptr<tree_node_t> child);
 
     /**
      * Set the total geometry available to the node. This will recursively
      * resize the children nodes, so that they fit inside the new geometry and
      * have a size proportional to their old size.
      */
-    void set_geometry(wf::geometry_t geometry, wf::txn::transaction_uptr& tx) override;
+    void set_geometry(wf::geometry_t geometry) override;
 
     /**
      * Set the gaps for the subnodes. The internal gap will override
@@ -127,7 +133,7 @@ struct split_node_t : public tree_node_t
      * Resize the children so that they fit inside the given
      * available_geometry.
      */
-    void recalculate_children(wf::geometry_t available_geometry, wf::txn::transaction_uptr& tx);
+    void recalculate_children(wf::geometry_t available_geometry);
 
     /**
      * Calculate the geometry of a child if it has child_size as one
@@ -161,13 +167,24 @@ struct view_node_t : public tree_node_t
     wayfire_toplevel_view view;
 
     /**
-     * Set the geometry of the node and the contained view.
+     * Set the geometry of the node and mark the contained view as dirty.
      *
      * Note that the resulting view geometry will not always be equal to the
      * geometry of the node. For example, a fullscreen view will always have
      * the geometry of the whole output.
      */
-    void set_geometry(wf::geometry_t geometry, wf::txn::transaction_uptr& tx) override;
+    void set_geometry(wf::geometry_t geometry) override;
+
+    /**
+     * Send the current geometry of the node to the view, adding it to @tx.
+     * Called by the layout_scheduler_t for each dirty node.
+     */
+    void apply_geometry(wf::txn::transaction_uptr& tx);
+
+    /**
+     * Mark the view as needing a relayout, for example because its fullscreen or maximized state changed.
+     */
+    void mark_dirty();
 
     /**
      * When true, the view will occupy the entire workarea (minus gaps),
@@ -183,6 +200,9 @@ struct view_node_t : public tree_node_t
     /* Return the tree node corresponding to the view, or nullptr if none */
     static nonstd::observer_ptr<view_node_t> get_node(wayfire_view view);
 
+    /** Whether the node is waiting for the layout_scheduler_t to apply its geometry. */
+    bool layout_dirty = false;
+
   private:
     struct scale_transformer_t;
     nonstd::observer_ptr<scale_transformer_t> transformer;
@@ -204,6 +224,50 @@ struct view_node_t : public tree_node_t
     void update_transformer();
 };
 
+/**
+ * Applies the geometry of the view nodes to their views.
+ *
+ * Operations on the tree (adding or removing nodes, changing gaps, resizing a split) often touch the same
+ * views several times, for example once for every gap option which changed or for every pointer motion event
+ * during a drag. Instead of sending each intermediate geometry to the clients, view nodes are only marked as
+ * dirty. Once per event loop iteration, the final geometry of all dirty views is applied in a single
+ * transaction.
+ *
+ * While an output is set with throttle_to(), the layout is applied at most once per frame of that output.
+ * This is used during interactive resizing, where input events usually arrive much faster than frames.
+ */
+class layout_scheduler_t : public wf::custom_data_t
+{
+  public:
+    layout_scheduler_t();
+    ~layout_scheduler_t();
+
+    static layout_scheduler_t& get();
+
+    /** Schedule the geometry of @node to be applied to its view. */
+    void mark_dirty(view_node_t *node);
+
+    /** Drop @node from the dirty nodes, for example because it is being destroyed. */
+    void forget(view_node_t *node);
+
+    /** Apply the layout at most once per frame of @output, or on idle if @output is null. */
+    void throttle_to(wf::output_t *output);
+
+    /** Apply the geometry of all dirty nodes in a single transaction. */
+    void flush();
+
+  private:
+    std::vector<view_node_t*> dirty;
+    wf::wl_idle_call idle_flush;
+
+    wf::output_t *throttle_output = nullptr;
+    bool frame_hook_active = false;
+    wf::effect_hook_t on_frame;
+
+    void schedule_flush();
+    void remove_frame_hook();
+};
+
 /**
  * Flatten the tree as much as possible, i.e remove nodes with only one
  * split-node child.
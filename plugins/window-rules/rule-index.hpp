@@ -0,0 +1,259 @@
+#ifndef WINDOW_RULES_RULE_INDEX_HPP
+#define WINDOW_RULES_RULE_INDEX_HPP
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace wf
+{
+namespace windowrules
+{
+/**
+ * The view properties for which equality predicates are hashed.
+ */
+enum class indexed_property_t
+{
+    APP_ID = 0,
+    TITLE  = 1,
+};
+
+static constexpr size_t NR_INDEXED_PROPERTIES = 2;
+
+/**
+ * What the rule index knows about a single rule, see analyze_rule().
+ */
+struct rule_key_t
+{
+    /** The signal the rule reacts to, or empty if it could not be determined. */
+    std::string signal;
+
+    /**
+     * If set, the rule can only ever match views whose @property is exactly @value, i.e. the condition is
+     * a conjunction whose first term is `<property> is "<value>"` and the rule has no else branch.
+     */
+    std::optional<indexed_property_t> property;
+    std::string value;
+};
+
+inline bool is_operator(char c)
+{
+    return (c == '&') || (c == '|') || (c == '!') || (c == '(') || (c == ')');
+}
+
+/**
+ * Split a rule into tokens: quoted strings (including the quotes), the operators & | ! ( ) and words.
+ * Returns false if the rule contains something which is not understood, e.g. an unterminated or escaped
+ * string.
+ */
+inline bool tokenize_rule(const std::string& text, std::vector<std::string>& tokens)
+{
+    size_t i = 0;
+    while (i < text.size())
+    {
+        const char c = text[i];
+        if (std::isspace((unsigned char)c))
+        {
+            ++i;
+        } else if (c == '"')
+        {
+            size_t end = text.find('"', i + 1);
+            if ((end == std::string::npos) || (text.find('\\', i) < end))
+            {
+                return false;
+            }
+
+            tokens.push_back(text.substr(i, end - i + 1));
+            i = end + 1;
+        } else if (c == '\'')
+        {
+            return false;
+        } else if (is_operator(c))
+        {
+            tokens.push_back(std::string(1, c));
+            ++i;
+        } else
+        {
+            size_t start = i;
+            while ((i < text.size()) && !std::isspace((unsigned char)text[i]) && !is_operator(text[i]) &&
+                   (text[i] != '"') && (text[i] != '\''))
+            {
+                ++i;
+            }
+
+            tokens.push_back(text.substr(start, i - start));
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Find out which signal a rule reacts to and whether it has a hashable equality predicate.
+ *
+ * The analysis only looks at the rule text and is conservative: whenever it is not sure, the rule is left
+ * unindexed (or, if even the signal is unclear, is considered for every signal). Rules are still evaluated
+ * in full by the rule engine, so the index only ever narrows down the set of rules to try.
+ */
+inline rule_key_t analyze_rule(const std::string& text)
+{
+    rule_key_t key;
+    std::vector<std::string> tokens;
+    if (!tokenize_rule(text, tokens) || (tokens.size() < 2) || (tokens[0] != "on"))
+    {
+        return key;
+    }
+
+    key.signal = tokens[1];
+    if (std::find(tokens.begin(), tokens.end(), "else") != tokens.end())
+    {
+        // The else branch runs exactly for the views the condition does not match.
+        return key;
+    }
+
+    auto cond_begin = std::find(tokens.begin(), tokens.end(), "if");
+    auto cond_end   = std::find(tokens.begin(), tokens.end(), "then");
+    if ((cond_begin != tokens.begin() + 2) || (cond_end == tokens.end()) || (cond_end - cond_begin < 4))
+    {
+        return key;
+    }
+
+    auto first = cond_begin + 1;
+    if ((first[1] != "is") || (first[2].size() < 2) || (first[2].front() != '"'))
+    {
+        return key;
+    }
+
+    if ((first + 3 != cond_end) && (first[3] != "&") && (first[3] != "and"))
+    {
+        return key;
+    }
+
+    // The first term must be a conjunct of the whole condition, i.e. no top-level disjunction.
+    int depth = 0;
+    for (auto it = first + 3; it != cond_end; ++it)
+    {
+        if (*it == "(")
+        {
+            ++depth;
+        } else if (*it == ")")
+        {
+            --depth;
+        } else if ((depth == 0) && ((*it == "|") || (*it == "or")))
+        {
+            return key;
+        }
+    }
+
+    if (first[0] == "app_id")
+    {
+        key.property = indexed_property_t::APP_ID;
+    } else if (first[0] == "title")
+    {
+        key.property = indexed_property_t::TITLE;
+    } else
+    {
+        return key;
+    }
+
+    key.value = first[2].substr(1, first[2].size() - 2);
+    return key;
+}
+
+/**
+ * An index from (signal, view properties) to the rules which may possibly apply.
+ *
+ * Rules are identified by their position in the rule list, and lookup() returns them in that order, so that
+ * the rules are applied in the same order as they appear in the config.
+ */
+class rule_index_t
+{
+  public:
+    void clear()
+    {
+        by_signal.clear();
+        any_signal = {};
+    }
+
+    /**
+     * Add the rule with the given text at position @id of the rule list.
+     */
+    void add(size_t id, const std::string& text)
+    {
+        auto key = analyze_rule(text);
+        auto& bucket = key.signal.empty() ? any_signal : by_signal[key.signal];
+        if (key.property)
+        {
+            bucket.by_value[(size_t)*key.property].emplace(key.value, id);
+        } else
+        {
+            bucket.unindexed.push_back(id);
+        }
+    }
+
+    /**
+     * Collect the rules which may apply to a view on @signal into @out, in rule list order.
+     *
+     * @param get_property A callable which returns the current value of an indexed_property_t of the view.
+     *   It is called at most once per property, and only if some rule is indexed by that property.
+     */
+    template<class Getter>
+    void lookup(const std::string& signal, Getter&& get_property, std::vector<size_t>& out) const
+    {
+        std::array<std::optional<std::string>, NR_INDEXED_PROPERTIES> values;
+        auto collect = [&] (const bucket_t& bucket)
+        {
+            out.insert(out.end(), bucket.unindexed.begin(), bucket.unindexed.end());
+            for (size_t i = 0; i < NR_INDEXED_PROPERTIES; i++)
+            {
+                if (bucket.by_value[i].empty())
+                {
+                    continue;
+                }
+
+                if (!values[i])
+                {
+                    values[i] = get_property((indexed_property_t)i);
+                }
+
+                auto range = bucket.by_value[i].equal_range(*values[i]);
+                for (auto it = range.first; it != range.second; ++it)
+                {
+                    out.push_back(it->second);
+                }
+            }
+        };
+
+        size_t start = out.size();
+        auto it = by_signal.find(signal);
+        if (it != by_signal.end())
+        {
+            collect(it->second);
+        }
+
+        collect(any_signal);
+        std::sort(out.begin() + start, out.end());
+    }
+
+  private:
+    struct bucket_t
+    {
+        // Rules which have to be tried for every view.
+        std::vector<size_t> unindexed;
+        // Rules which can only match views with the given value of a property.
+        std::array<std::unordered_multimap<std::string, size_t>, NR_INDEXED_PROPERTIES> by_value;
+    };
+
+    std::unordered_map<std::string, bucket_t> by_signal;
+    // Rules whose signal could not be determined.
+    bucket_t any_signal;
+};
+}
+}
+
+#endif // WINDOW_RULES_RULE_INDEX_HPP
@@ -16,6 +16,7 @@
 #include <wayfire/toplevel-view.hpp>
 
 #include "lambda-rules-registration.hpp"
+#include "rule-index.hpp"
 #include "view-action-interface.hpp"
 #include "wayfire/signal-provider.hpp"
 
@@ -62,6 +63,8 @@ class wayfire_window_rules_t : public wf::per_output_plugin_instance_t
     };
 
     std::vector<std::shared_ptr<wf::rule_t>> _rules;
+    // Narrows down the rules to try for a given signal and view, see rule-index.hpp.
+    wf::windowrules::rule_index_t _rule_index;
 
     wf::view_access_interface_t _access_interface;
     wf::view_action_interface_t _action_interface;
@@ -111,11 +114,19 @@ void wayfire_window_rules_t::apply(const std::string & signal, wayfire_view view
         return;
     }
 
-    for (const auto & rule : _rules)
+    std::vector<size_t> candidates;
+    _rule_index.lookup(signal, [&] (wf::windowrules::indexed_property_t property)
     {
+        return (property == wf::windowrules::indexed_property_t::APP_ID) ?
+               view->get_app_id() : view->get_title();
+    }, candidates);
+
+    for (size_t id : candidates)
+    {
+        // Actions may emit signals which recursively apply rules, so the view is set again for each rule.
         _access_interface.set_view(view);
         _action_interface.set_view(view);
-        auto error = rule->apply(signal, _access_interface, _action_interface);
+        auto error = _rules[id]->apply(signal, _access_interface, _action_interface);
         if (error)
         {
             LOGE("Window-rules: Error while executing rule on ", signal, " signal.");
@@ -180,6 +191,7 @@ void wayfire_window_rules_t::apply(const std::string & signal, wayfire_view view
 void wayfire_window_rules_t::setup_rules_from_config()
 {
     _rules.clear();
+    _rule_index.clear();
 
     wf::option_wrapper_t<wf::config::compound_list_t<std::string>> rule_list_option{"window-rules/rules"};
     auto rule_list = rule_list_option.value();
@@ -191,6 +203,7 @@ void wayfire_window_rules_t::setup_rules_from_config()
         auto rule = wf::rule_parser_t().parse(_lexer);
         if (rule != nullptr)
         {
+            _rule_index.add(_rules.size(), rule_str);
             _rules.push_back(rule);
         }
     }
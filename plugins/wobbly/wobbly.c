@@ -516,8 +516,8 @@ void wobbly_prepare_paint(struct wobbly_surface *surface, int msSinceLastPaint)
     WobblyWindow *ww = surface->ww;
     float  friction, springK;
 
-    friction = wobbly_settings_get_friction();
-    springK  = wobbly_settings_get_spring_k();
+    friction = surface->friction;
+    springK  = surface->spring_k;
 
     if (ww->wobbly)
     {
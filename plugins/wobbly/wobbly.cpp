@@ -132,28 +132,6 @@ void render_triangles(OpenGL::program_t *program, wf::gles_texture_t tex, glm::m
 }
 }
 
-namespace wobbly_settings
-{
-wf::option_wrapper_t<double> friction{"wobbly/friction"};
-wf::option_wrapper_t<double> spring_k{"wobbly/spring_k"};
-wf::option_wrapper_t<int> resolution{"wobbly/grid_resolution"};
-}
-
-extern "C"
-{
-    double wobbly_settings_get_friction()
-    {
-        return wf::clamp((double)wobbly_settings::friction,
-            MINIMAL_FRICTION, MAXIMAL_FRICTION);
-    }
-
-    double wobbly_settings_get_spring_k()
-    {
-        return wf::clamp((double)wobbly_settings::spring_k,
-            MINIMAL_SPRING_K, MAXIMAL_SPRING_K);
-    }
-}
-
 namespace wf
 {
 using wobbly_model_t = std::unique_ptr<wobbly_surface>;
@@ -670,6 +648,10 @@ class wobbly_transformer_node_t : public wf::scene::transformer_base_node_t
     uint32_t last_frame;
     bool force_tile = false;
 
+    wf::option_wrapper_t<double> friction{"wobbly/friction"};
+    wf::option_wrapper_t<double> spring_k{"wobbly/spring_k"};
+    wf::option_wrapper_t<int> resolution{"wobbly/grid_resolution"};
+
     void init_model()
     {
         model = std::make_unique<wobbly_surface>();
@@ -684,8 +666,8 @@ class wobbly_transformer_node_t : public wf::scene::transformer_base_node_t
         model->grabbed = 0;
         model->synced  = 1;
 
-        model->x_cells = wobbly_settings::resolution;
-        model->y_cells = wobbly_settings::resolution;
+        model->x_cells = resolution;
+        model->y_cells = resolution;
 
         model->v  = NULL;
         model->uv = NULL;
@@ -709,6 +691,8 @@ class wobbly_transformer_node_t : public wf::scene::transformer_base_node_t
         if (now > last_frame)
         {
             view->get_transformed_node()->begin_transform_update();
+            model->friction = wf::clamp((double)friction, MINIMAL_FRICTION, MAXIMAL_FRICTION);
+            model->spring_k = wf::clamp((double)spring_k, MINIMAL_SPRING_K, MAXIMAL_SPRING_K);
             wobbly_prepare_paint(model.get(), now - last_frame);
             /* Update wobbly geometry */
             last_frame = now;
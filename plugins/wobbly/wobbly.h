@@ -15,9 +15,6 @@
 #define MAXIMAL_SPRING_K 10.0
 #define WOBBLY_MASS 15.0
 
-double wobbly_settings_get_friction();
-double wobbly_settings_get_spring_k();
-
 struct wobbly_surface
 {
    void *ww;
@@ -25,6 +22,8 @@ struct wobbly_surface
    int x_cells, y_cells;
    int grabbed, synced;
    int vertex_count;
+   /* Set by the caller before each wobbly_prepare_paint() */
+   double friction, spring_k;
 
    GLfloat *v, *uv;
 };
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <wayfire/render.hpp>
+#include <wayfire/option-wrapper.hpp>
+#include <list>
+#include <map>
+#include <memory>
+#include <tuple>
+
+namespace wf
+{
+/**
+ * Statistics about the shared auxilliary buffer pool.
+ */
+struct aux_buffer_pool_stats_t
+{
+    /** Memory (estimated, in bytes) of buffers currently lent out to users of the pool. */
+    size_t leased_bytes = 0;
+    /** Memory (estimated, in bytes) of idle buffers kept in the pool for reuse. */
+    size_t pooled_bytes = 0;
+    /** The configured memory budget in bytes. */
+    size_t budget_bytes = 0;
+
+    /** Number of buffers currently lent out / kept idle in the pool. */
+    size_t leased_buffers = 0;
+    size_t pooled_buffers = 0;
+
+    /** Number of acquire() calls satisfied by a pooled buffer. */
+    uint64_t hits = 0;
+    /** Number of acquire() calls which needed a fresh allocation. */
+    uint64_t misses = 0;
+    /** Number of idle buffers freed to stay within the budget. */
+    uint64_t evictions = 0;
+};
+
+/**
+ * A pool of auxilliary buffers shared between all transformer nodes (and any plugin which wishes to use it).
+ *
+ * Transformers come and go very often (for example, every animation or scale/expo activation adds a
+ * transformer to many views at once). Instead of allocating and freeing a full-size buffer for each of them,
+ * buffers are returned to the pool when they are no longer needed and reused for the next request with the
+ * same size and format. Idle buffers are kept in LRU order and freed once the total memory used by the pool
+ * exceeds the budget configured in workarounds/aux_buffer_pool_budget (in MiB, 0 disables pooling).
+ *
+ * Buffers are bucketed by their size in pixels (after applying scale) and by their format class (8-bit or
+ * HDR linear).
+ */
+class aux_buffer_pool_t
+{
+  public:
+    aux_buffer_pool_t();
+    ~aux_buffer_pool_t();
+
+    aux_buffer_pool_t(const aux_buffer_pool_t&) = delete;
+    aux_buffer_pool_t(aux_buffer_pool_t&&) = delete;
+    aux_buffer_pool_t& operator =(const aux_buffer_pool_t&) = delete;
+    aux_buffer_pool_t& operator =(aux_buffer_pool_t&&) = delete;
+
+    /**
+     * Make sure that @buffer is allocated with the given size/scale/hints, taking a buffer from the pool
+     * if possible. If @buffer already has the correct size, it is left untouched. Otherwise, its old contents
+     * are returned to the pool.
+     *
+     * The semantics of @size, @scale and @hints are the same as in auxilliary_buffer_t::allocate().
+     *
+     * @return The result of the operation. Note that a buffer taken from the pool reports REALLOCATED,
+     *   since its contents are undefined and need to be fully repainted.
+     */
+    buffer_reallocation_result_t acquire(auxilliary_buffer_t& buffer, wf::dimensions_t size,
+        float scale = 1.0, buffer_allocation_hints_t hints = {});
+
+    /**
+     * Return the memory backing @buffer to the pool. After this call, @buffer is empty (as if free() was
+     * called on it). The pooled buffer may be freed immediately if the pool is over budget.
+     *
+     * Buffers obtained via acquire() should always be given back with release() instead of being freed
+     * directly, otherwise the pool's accounting goes out of sync.
+     */
+    void release(auxilliary_buffer_t& buffer);
+
+    /**
+     * Free idle buffers until the pool uses at most @max_bytes.
+     */
+    void trim(size_t max_bytes);
+
+    /**
+     * Get the current statistics of the pool.
+     */
+    aux_buffer_pool_stats_t get_stats() const;
+
+  private:
+    struct bucket_t
+    {
+        int width;
+        int height;
+        bool hdr_linear;
+
+        bool operator <(const bucket_t& other) const
+        {
+            return std::tie(width, height, hdr_linear) <
+                   std::tie(other.width, other.height, other.hdr_linear);
+        }
+    };
+
+    struct pooled_buffer_t
+    {
+        bucket_t bucket;
+        auxilliary_buffer_t buffer;
+    };
+
+    // Idle buffers, most recently used at the front.
+    std::list<pooled_buffer_t> lru;
+    // Index into @lru for each bucket. Within a bucket, the most recently pooled buffer comes last.
+    std::multimap<bucket_t, std::list<pooled_buffer_t>::iterator> idle_by_bucket;
+    // Format class of the buffers which are currently lent out.
+    std::map<wlr_buffer*, bucket_t> leased;
+    // Buckets whose allocations fell back to a smaller size (see auxilliary_buffer_t::allocate()), mapped
+    // to the bucket of the buffer they actually got. Requests for them are served from that bucket.
+    std::map<bucket_t, bucket_t> degraded;
+
+    aux_buffer_pool_stats_t stats;
+    wf::option_wrapper_t<int> budget_mib{"workarounds/aux_buffer_pool_budget"};
+
+    static size_t bucket_size(const bucket_t& bucket);
+    size_t get_budget() const;
+    // The part of the budget which is not used by leased buffers.
+    size_t get_idle_budget() const;
+    void evict_lru();
+};
+}
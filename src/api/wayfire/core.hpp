@@ -21,6 +21,8 @@ class toplevel_view_interface_t;
 class window_manager_t;
 class workspace_set_t;
 class config_backend_t;
+class aux_buffer_pool_t;
+class startup_timing_t;
 
 namespace scene
 {
@@ -158,6 +160,16 @@ class compositor_core_t : public wf::object_base_t, public signal::provider_t
     std::unique_ptr<wf::txn::transaction_manager_t> tx_manager;
     std::unique_ptr<wf::window_manager_t> default_wm;
 
+    /**
+     * A pool of auxilliary buffers shared by view transformers and plugins, see aux-buffer-pool.hpp.
+     */
+    std::unique_ptr<wf::aux_buffer_pool_t> aux_buffer_pool;
+
+    /**
+     * Timings of the compositor startup phases, see startup-timing.hpp.
+     */
+    std::unique_ptr<wf::startup_timing_t> startup_timing;
+
     /**
      * Various protocols supported by wlroots
      */
@@ -2,7 +2,12 @@
 #define IMG_HPP_
 
 #include <wayfire/opengl.hpp>
+#include <wayfire/geometry.hpp>
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace image_io
 {
@@ -17,8 +22,77 @@ void write_to_file(std::string name, uint8_t *pixels, int w, int h,
 
 void write_to_file(std::string name, const wf::render_buffer_t& buffer);
 
+/* Image data decoded from a file, rows are tightly packed, top to bottom. */
+struct decoded_image_t
+{
+    int width    = 0;
+    int height   = 0;
+    /* 3 (RGB) or 4 (RGBA) */
+    int channels = 4;
+    std::vector<uint8_t> pixels;
+};
+
+/**
+ * Decode the given file without touching any GL state. Safe to call from any thread.
+ *
+ * If @max_size is non-zero, the image is downsampled by an integer factor until it fits.
+ *
+ * @return The decoded image, or nullptr if the file could not be read.
+ */
+std::shared_ptr<const decoded_image_t> decode_file(const std::string& name,
+    wf::dimensions_t max_size = {0, 0});
+
+/**
+ * Loads an image into a new GL texture without blocking the compositor.
+ *
+ * The file is decoded (and optionally downsampled) on a worker thread, and the pixels are then uploaded on
+ * the main thread in several slices, so that no single event loop iteration spends long in the driver.
+ * Decoded images are cached by path and modification time, so that reloading an unchanged image skips the
+ * decoding step entirely.
+ *
+ * Until the callback is invoked, users should keep showing whatever they showed before (the old texture or
+ * a placeholder).
+ */
+class async_texture_loader_t
+{
+  public:
+    /* Called on the main thread with the new texture, or 0 if loading failed. The texture is owned by the
+     * receiver of the callback. */
+    using callback_t = std::function<void (GLuint tex)>;
+
+    async_texture_loader_t();
+    /* Cancels the current load, if any. */
+    ~async_texture_loader_t();
+
+    async_texture_loader_t(const async_texture_loader_t&) = delete;
+    async_texture_loader_t(async_texture_loader_t&&) = delete;
+    async_texture_loader_t& operator =(const async_texture_loader_t&) = delete;
+    async_texture_loader_t& operator =(async_texture_loader_t&&) = delete;
+
+    /**
+     * Start loading @name as a GL_TEXTURE_2D or GL_TEXTURE_CUBE_MAP (in the layout accepted by
+     * load_from_file()). Cancels any load which is still in progress.
+     *
+     * @param max_size If non-zero, 2D images larger than this are downsampled. Ignored for cubemaps.
+     */
+    void load(const std::string& name, GLuint target, wf::dimensions_t max_size, callback_t on_ready);
+
+    /* Stop the current load without invoking the callback. */
+    void cancel();
+
+    /* @return true if a load was started and its callback has not been invoked yet. */
+    bool is_loading() const;
+
+  private:
+    struct impl;
+    std::unique_ptr<impl> priv;
+};
+
 /* Initializes all backends, called at startup */
 void init();
+
+/* Drops cached images and pending decodes, called at shutdown */
+void fini();
 }
 
 #endif /* end of include guard: IMG_HPP_ */
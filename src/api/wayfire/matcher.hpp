@@ -5,6 +5,19 @@
 
 namespace wf
 {
+/**
+ * Statistics about the cache of view_matcher_t results, shared by all matchers.
+ */
+struct view_matcher_cache_stats_t
+{
+    /** Number of matches() calls answered from the cache. */
+    uint64_t hits = 0;
+    /** Number of matches() calls which evaluated the condition. */
+    uint64_t misses = 0;
+    /** Number of misses whose result could not be cached, see view_matcher_t::matches(). */
+    uint64_t uncacheable = 0;
+};
+
 /**
  * view_matcher_t provides a way to match certain views based on conditions.
  * The conditions are represented as string options.
@@ -45,9 +58,18 @@ class view_matcher_t
 
     /**
      * @return True if the view matches the condition specified, false otherwise.
+     *
+     * The result is cached per view until one of the properties the condition read changes. Conditions
+     * which read properties that cannot be tracked (for example the type of non-toplevel views) are
+     * evaluated every time.
      */
     bool matches(wayfire_view view);
 
+    /**
+     * Get the statistics of the result cache of all matchers.
+     */
+    static view_matcher_cache_stats_t get_cache_stats();
+
     /** Destructor */
     ~view_matcher_t();
 
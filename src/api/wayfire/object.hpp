@@ -32,6 +32,34 @@ class property_data_t : public custom_data_t
     T value;
 };
 
+/**
+ * Custom data is stored in slots identified by small integers. Each name used with the custom data API is
+ * assigned a slot once, the first time data is stored with it. Typed accessors (the overloads without a
+ * name) cache the slot for their type, so that they do not need to build and hash a string on every call.
+ *
+ * Slots for types use typeid(T).name() as their name, so typed and named accessors for the same type refer
+ * to the same data.
+ */
+namespace custom_data_slots
+{
+/** Get the slot for the given name, assigning a new one if the name was never used before. */
+uint32_t register_slot(const std::string& name);
+
+/** Get the slot for the given name, or std::nullopt if the name was never used to store data. */
+std::optional<uint32_t> find_slot(const std::string& name);
+
+/** Get the name which a slot was registered with. */
+const std::string& get_slot_name(uint32_t slot);
+
+/** Get the slot for the type T. */
+template<class T>
+uint32_t get_type_slot()
+{
+    static const uint32_t slot = register_slot(typeid(T).name());
+    return slot;
+}
+}
+
 /**
  * A base class for "objects". Objects provide signals and ways for plugins to
  * store custom data about the object.
@@ -53,43 +81,55 @@ class object_base_t
      * If your type doesn't have one, use store_data + get_data
      */
     template<class T>
-    nonstd::observer_ptr<T> get_data_safe(
-        std::string name = typeid(T).name())
+    nonstd::observer_ptr<T> get_data_safe(std::string name)
     {
-        auto data = get_data<T>(name);
-        if (data)
-        {
-            return data;
-        } else
-        {
-            store_data<T>(std::make_unique<T>(), name);
+        return _get_data_safe<T>(custom_data_slots::register_slot(name));
+    }
 
-            return get_data<T>(name);
-        }
+    /**
+     * Same as get_data_safe(name) with name = typeid(T).name(), but faster.
+     */
+    template<class T>
+    nonstd::observer_ptr<T> get_data_safe()
+    {
+        return _get_data_safe<T>(custom_data_slots::get_type_slot<T>());
     }
 
     /* Retrieve custom data stored with the given name. If no such
      * data exists, NULL is returned */
     template<class T>
-    nonstd::observer_ptr<T> get_data(
-        std::string name = typeid(T).name())
+    nonstd::observer_ptr<T> get_data(std::string name)
+    {
+        auto slot = custom_data_slots::find_slot(name);
+        return slot ? _get_data<T>(*slot) : nullptr;
+    }
+
+    /* Same as get_data(name) with name = typeid(T).name(), but faster. */
+    template<class T>
+    nonstd::observer_ptr<T> get_data()
     {
-        return nonstd::make_observer(dynamic_cast<T*>(_fetch_data(name)));
+        return _get_data<T>(custom_data_slots::get_type_slot<T>());
     }
 
     /* Assigns the given data to the given name */
     template<class T>
-    void store_data(std::unique_ptr<T> stored_data,
-        std::string name = typeid(T).name())
+    void store_data(std::unique_ptr<T> stored_data, std::string name)
     {
-        _store_data(std::move(stored_data), name);
+        _store_data(std::move(stored_data), custom_data_slots::register_slot(name), typeid(T));
+    }
+
+    /* Same as store_data(data, name) with name = typeid(T).name(), but faster. */
+    template<class T>
+    void store_data(std::unique_ptr<T> stored_data)
+    {
+        _store_data(std::move(stored_data), custom_data_slots::get_type_slot<T>(), typeid(T));
     }
 
     /* Returns true if there is saved data under the given name */
     template<class T>
     bool has_data()
     {
-        return has_data(typeid(T).name());
+        return _fetch_data(custom_data_slots::get_type_slot<T>()) != nullptr;
     }
 
     /** @return true if there is saved data with the given name */
@@ -102,22 +142,22 @@ class object_base_t
     template<class T>
     void erase_data()
     {
-        erase_data(typeid(T).name());
+        _erase_data(custom_data_slots::get_type_slot<T>());
     }
 
     /* Erase the saved data from the store and return the pointer */
     template<class T>
-    std::unique_ptr<T> release_data(
-        std::string name = typeid(T).name())
+    std::unique_ptr<T> release_data(std::string name)
     {
-        if (!has_data(name))
-        {
-            return {nullptr};
-        }
-
-        auto stored = _fetch_erase(name);
+        auto slot = custom_data_slots::find_slot(name);
+        return slot ? _release_data<T>(*slot) : nullptr;
+    }
 
-        return std::unique_ptr<T>(dynamic_cast<T*>(stored));
+    /* Same as release_data(name) with name = typeid(T).name(), but faster. */
+    template<class T>
+    std::unique_ptr<T> release_data()
+    {
+        return _release_data<T>(custom_data_slots::get_type_slot<T>());
     }
 
     virtual ~object_base_t();
@@ -179,17 +219,67 @@ class object_base_t
     void _clear_data();
 
   private:
-    /** Just get the data under the given name, or nullptr, if it does not exist */
-    custom_data_t *_fetch_data(std::string name);
-    /** Get the data under the given name, and release the pointer, deleting
-     * the entry in the map */
-    custom_data_t *_fetch_erase(std::string name);
+    /**
+     * Just get the data in the given slot, or nullptr, if it does not exist.
+     * If @stored_type is not NULL, it is set to the type the data was stored with.
+     */
+    custom_data_t *_fetch_data(uint32_t slot, const std::type_info **stored_type = nullptr);
+    /** Get the data in the given slot, and release the pointer, removing the entry from the store */
+    custom_data_t *_fetch_erase(uint32_t slot);
 
-    /** Store the given data under the given name */
-    void _store_data(std::unique_ptr<custom_data_t> data, std::string name);
+    /** Store the given data in the given slot */
+    void _store_data(std::unique_ptr<custom_data_t> data, uint32_t slot, const std::type_info& type);
+
+    void _erase_data(uint32_t slot);
 
     void _warn_wrong_type(std::string name);
 
+    template<class T>
+    static T *_cast_data(custom_data_t *data, const std::type_info *stored_type)
+    {
+        if (data && stored_type && (*stored_type == typeid(T)))
+        {
+            // Stored with exactly this type, no need for a dynamic_cast.
+            return static_cast<T*>(data);
+        }
+
+        return dynamic_cast<T*>(data);
+    }
+
+    template<class T>
+    nonstd::observer_ptr<T> _get_data(uint32_t slot)
+    {
+        const std::type_info *stored_type = nullptr;
+        auto data = _fetch_data(slot, &stored_type);
+        return nonstd::make_observer(_cast_data<T>(data, stored_type));
+    }
+
+    template<class T>
+    nonstd::observer_ptr<T> _get_data_safe(uint32_t slot)
+    {
+        auto data = _get_data<T>(slot);
+        if (data)
+        {
+            return data;
+        }
+
+        _store_data(std::make_unique<T>(), slot, typeid(T));
+        return _get_data<T>(slot);
+    }
+
+    template<class T>
+    std::unique_ptr<T> _release_data(uint32_t slot)
+    {
+        const std::type_info *stored_type = nullptr;
+        if (!_fetch_data(slot, &stored_type))
+        {
+            return {nullptr};
+        }
+
+        auto stored = _fetch_erase(slot);
+        return std::unique_ptr<T>(_cast_data<T>(stored, stored_type));
+    }
+
     class obase_impl;
     std::unique_ptr<obase_impl> obase_priv;
 };
@@ -3,6 +3,7 @@
 
 #include <functional>
 #include <string>
+#include <vector>
 #include <cstdint>
 
 class wayfire_config;
@@ -91,6 +92,15 @@ class plugin_interface_t
         return 0;
     }
 
+    /**
+     * A list of plugin names (as in the `core/plugins` option) which have to be initialized before this
+     * plugin, if they are loaded at the same time. Dependencies take precedence over the order hint.
+     */
+    virtual std::vector<std::string> get_dependencies() const
+    {
+        return {};
+    }
+
     virtual ~plugin_interface_t() = default;
 };
 }
@@ -107,7 +117,7 @@ using wayfire_plugin_load_func = wf::plugin_interface_t * (*)();
 /**
  * The version is defined as macro as well, to allow conditional compilation.
  */
-#define WAYFIRE_API_ABI_VERSION_MACRO 2026'06'17
+#define WAYFIRE_API_ABI_VERSION_MACRO 2026'10'18
 
 /**
  * The version of Wayfire's API/ABI
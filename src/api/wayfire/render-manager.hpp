@@ -4,6 +4,13 @@
 #include <wayfire/output.hpp>
 #include <wayfire/object.hpp>
 #include <wayfire/region.hpp>
+#include <string>
+#include <vector>
+
+namespace OpenGL
+{
+class program_t;
+}
 
 namespace wf
 {
@@ -35,6 +42,120 @@ enum output_effect_type_t
     OUTPUT_EFFECT_TOTAL     = 5,
 };
 
+/**
+ * Information about the frame for which animations are being updated.
+ */
+struct animation_frame_t
+{
+    /**
+     * The predicted time at which the frame will be shown on the output, in nanoseconds of the same clock
+     * as wf::get_current_time() (CLOCK_MONOTONIC). It is based on the last presentation feedback from the
+     * output and its refresh rate, so animations which use it advance by the same amount every frame even
+     * if the compositor is late in starting to render.
+     */
+    int64_t presentation_time_nsec = 0;
+
+    /** The refresh interval of the output in nanoseconds, or 0 if not known. */
+    int64_t refresh_nsec = 0;
+
+    /**
+     * Damage in output-local coordinates, applied at once after all animations were ticked. Parts of it
+     * which lie outside of the output are damaged on the outputs they overlap, if any.
+     * Animations which damage many nodes every frame can add to it instead of damaging each node.
+     */
+    wf::regionf_t *damage = nullptr;
+};
+
+/**
+ * An animation tick is called once per frame while it is registered, see render_manager::add_animation().
+ * The callback should update its animation state and damage whatever changed.
+ *
+ * @return Whether the animation is still running. Once no animation is running, the output stops requesting
+ *   new frames on their behalf.
+ */
+using animation_tick_t = std::function<bool (const animation_frame_t& frame)>;
+
+/**
+ * Statistics about the animations ticked on an output.
+ */
+struct animation_stats_t
+{
+    /** The number of registered animations. */
+    size_t animations = 0;
+    /** Time spent in animation ticks during the last frame, in microseconds. */
+    int64_t last_frame_cost_us = 0;
+    /** Exponential moving average of the time spent in animation ticks per frame, in microseconds. */
+    double average_frame_cost_us = 0;
+    /** The largest time spent in animation ticks during a single frame, in microseconds. */
+    int64_t max_frame_cost_us = 0;
+};
+
+/**
+ * How the repaint delay of an output was chosen, see repaint_stats_t.
+ */
+enum class repaint_delay_mode_t
+{
+    /** core/max_render_time is -1, frames are rendered as soon as possible. */
+    DISABLED,
+    /** The delay is the refresh interval minus core/max_render_time. */
+    FIXED,
+    /** Dynamic delay, but too few render times have been measured for the active plugins yet. */
+    LEARNING,
+    /** Dynamic delay, computed from the measured render times of the active plugins. */
+    LEARNED,
+};
+
+/**
+ * Render times measured on an output while a particular set of plugins was active.
+ */
+struct repaint_profile_stats_t
+{
+    /** The names of the active plugins, sorted and comma-separated. Empty if no plugin is active. */
+    std::string active_plugins;
+    /** The number of recent frames the statistics are computed from. */
+    size_t samples = 0;
+    int64_t last_render_us = 0;
+    int64_t max_render_us  = 0;
+    /** The render time percentile used for choosing the delay, see workarounds/repaint_delay_percentile. */
+    int64_t percentile_render_us = 0;
+    /** Extra margin added after missed frames, decays while frames are on time. */
+    int64_t miss_penalty_us = 0;
+    uint64_t frames = 0;
+    uint64_t missed_frames = 0;
+};
+
+/**
+ * Statistics about the repaint delay of an output, i.e. how long it waits after the start of a refresh cycle
+ * before rendering the next frame, to give clients as much time as possible to submit new content.
+ */
+struct repaint_stats_t
+{
+    /** The refresh interval of the output in nanoseconds, or 0 if not known. */
+    int64_t refresh_nsec = 0;
+    /** The delay of the current frame in milliseconds. */
+    int delay_ms = 0;
+    repaint_delay_mode_t mode = repaint_delay_mode_t::DISABLED;
+    /** The plugins which were active when the current delay was chosen. */
+    std::string active_plugins;
+    /** The render time the delay was chosen for (percentile plus margins), 0 if not LEARNED. */
+    int64_t predicted_render_us = 0;
+    /** One entry per set of active plugins seen on the output so far. */
+    std::vector<repaint_profile_stats_t> profiles;
+};
+
+/**
+ * Statistics about the occlusion culling in the main render pass of an output, i.e. how many render
+ * instructions were skipped because they were hidden below opaque content (see
+ * render_instruction_t::opaque_region).
+ */
+struct occlusion_stats_t
+{
+    uint64_t last_frame_culled = 0;
+    uint64_t total_culled = 0;
+    /** The number of frames rendered so far. */
+    uint64_t frames = 0;
+};
+
 /** Post hooks are called just before swapping buffers. In contrast to
  * render hooks, post hooks operate on the whole output image, i.e they
  * are suitable for different postprocessing effects.
@@ -51,6 +172,53 @@ enum output_effect_type_t
 using post_hook_t = std::function<void (wf::auxilliary_buffer_t& source,
     const wf::render_buffer_t& destination)>;
 
+/**
+ * Additional information about a post hook, see render_manager::add_post().
+ */
+struct post_hook_options_t
+{
+    /**
+     * The hook computes each pixel of the destination only from the same pixel of the source (for example
+     * color inversion or a color filter).
+     *
+     * With the GLES renderer, if all post hooks are per-pixel (or declare transform_damage), they are run
+     * only on the damaged part of the output: the hook is called with the scissor box set to the damaged
+     * region (possibly several times per frame, once for each damaged rectangle), and the rest of the
+     * destination keeps its previous contents. Such hooks should therefore draw the whole buffer as usual
+     * and must not change the scissor state.
+     */
+    bool per_pixel = false;
+
+    /**
+     * Optional, only used for per-pixel hooks with the GLES renderer.
+     *
+     * A GLSL ES 1.00 snippet which implements the effect as a function
+     * `highp vec4 <shader_function>(highp vec4 color)`, together with any uniforms it needs. Uniform and
+     * function names should be unique (for example, prefixed with the plugin name).
+     *
+     * Consecutive post hooks with a shader are fused into a single pass, in which case the hooks themselves
+     * are not called.
+     */
+    std::string shader_source;
+    std::string shader_function;
+
+    /**
+     * For hooks which move pixels around (for example, zoom), a function which maps damage of the source
+     * buffer to the region of the destination buffer which is affected by it. Both are in buffer
+     * coordinates. The mapping may only change together with a full damage of the output.
+     *
+     * If set, the hook is not scissored and may run on any renderer. Instead, it should update only the
+     * region returned by render_manager::get_post_damage(), for example by passing it as the clip region to
+     * render_buffer_t::blit().
+     */
+    std::function<wf::region_t(const wf::region_t&)> transform_damage;
+
+    /**
+     * Called while the fused program is in use, to set the uniforms declared in @shader_source.
+     */
+    std::function<void (OpenGL::program_t&)> set_uniforms;
+};
+
 /**
  * The frame-done signal is emitted on an output when the frame has been completed (regardless of whether new
  * content was painted or not).
@@ -108,12 +276,57 @@ class render_manager
      */
     void rem_effect(effect_hook_t *hook);
 
+    /**
+     * Register an animation with the output's animation timeline.
+     *
+     * All registered animations are ticked together at the start of each frame (after the PRE effect
+     * hooks), with the predicted presentation time of the frame. While any of them reports that it is
+     * still running, the next frame is scheduled automatically.
+     *
+     * @param tick The tick callback. It must stay valid until rem_animation() is called.
+     */
+    void add_animation(animation_tick_t *tick);
+
+    /**
+     * Remove an animation from the timeline. No-op if the animation wasn't added. Safe to call from within
+     * an animation tick.
+     */
+    void rem_animation(animation_tick_t *tick);
+
+    /**
+     * Get the animation frame which is currently being (or was last) ticked.
+     */
+    animation_frame_t get_animation_frame() const;
+
+    /**
+     * Get statistics about the animations on this output.
+     */
+    animation_stats_t get_animation_stats() const;
+
+    /**
+     * Get statistics about the repaint delay of this output and how it was chosen.
+     */
+    repaint_stats_t get_repaint_stats() const;
+
+    /**
+     * Get statistics about the occlusion culling on this output.
+     */
+    occlusion_stats_t get_occlusion_stats() const;
+
     /**
      * Add a new post hook.
      *
      * @param hook The hook callback
+     * @param options Additional information about the hook, which allows the
+     *   render manager to avoid processing the whole output on each frame.
+     */
+    void add_post(post_hook_t *hook, post_hook_options_t options = {});
+
+    /**
+     * Get the region of the destination buffer which the currently running post hook has to update, in
+     * buffer coordinates. Only valid while post hooks are running.
      */
-    void add_post(post_hook_t *hook);
+    const wf::region_t& get_post_damage() const;
 
     /**
      * Remove a post hook. No-op if hook isn't active.
@@ -225,9 +225,10 @@ struct render_buffer_t
      * @param src_box The subrectangle of the source buffer to be copied from.
      * @param dst_box The subrectangle of the destination buffer to be copied to.
      * @param filter_mode The filter mode to use.
+     * @param clip If set, only the part of @dst_box inside this region (in buffer coordinates) is updated.
      */
     void blit(wf::auxilliary_buffer_t& source, wf::geometry_t src_box, wf::geometry_t dst_box,
-        wlr_scale_filter_mode filter_mode = WLR_SCALE_FILTER_BILINEAR) const;
+        wlr_scale_filter_mode filter_mode = WLR_SCALE_FILTER_BILINEAR, const wf::region_t *clip = nullptr) const;
 
     /**
      * Copy a part of another buffer onto this buffer.
@@ -238,9 +239,10 @@ struct render_buffer_t
      * @param src_box The subrectangle of the source buffer to be copied from.
      * @param dst_box The subrectangle of the destination buffer to be copied to.
      * @param filter_mode The filter mode to use.
+     * @param clip If set, only the part of @dst_box inside this region (in buffer coordinates) is updated.
      */
     void blit(const wf::render_buffer_t& source, wf::geometry_t src_box, wf::geometry_t dst_box,
-        wlr_scale_filter_mode filter_mode = WLR_SCALE_FILTER_BILINEAR) const;
+        wlr_scale_filter_mode filter_mode = WLR_SCALE_FILTER_BILINEAR, const wf::region_t *clip = nullptr) const;
 
   private:
     friend struct auxilliary_buffer_t;
@@ -252,7 +254,7 @@ struct render_buffer_t
 
     // Helper for copy operations
     void do_blit(wlr_texture *src_wlr_tex, wf::geometry_t src_box, wf::geometry_t dst_box,
-        wlr_scale_filter_mode filter_mode) const;
+        wlr_scale_filter_mode filter_mode, const wf::region_t *clip) const;
 };
 
 /**
@@ -268,6 +270,15 @@ struct buffer_allocation_hints_t
      * if no FP16 format is available.
      */
     bool hdr_linear = false;
+
+    /**
+     * Get the memory used per pixel by a buffer allocated with these hints, assuming that the preferred
+     * format is available (fallback formats never use more).
+     */
+    size_t get_bytes_per_pixel() const
+    {
+        return hdr_linear ? 8 : 4;
+    }
 };
 
 /**
@@ -314,6 +325,12 @@ struct auxilliary_buffer_t
     buffer_reallocation_result_t allocate(wf::dimensions_t size, float scale = 1.0,
         buffer_allocation_hints_t hints = {});
 
+    /**
+     * Get the size which allocate() aims for with the given parameters, i.e. the scaled size, limited by
+     * workarounds/max_buffer_size. The allocated buffer may still be smaller if the allocation fails.
+     */
+    static wf::dimensions_t get_allocation_size(wf::dimensions_t size, float scale = 1.0);
+
     /**
      * Free the wlr_buffer/wlr_texture backing this framebuffer.
      */
@@ -568,7 +585,8 @@ class render_pass_t
      *
      * 1. Optionally, emit render-pass-begin.
      * 2. Render instructions are generated from the given instances. During this phase, the instances may
-     *    start and execute sub-passes.
+     *    start and execute sub-passes. Instructions which are fully hidden below the opaque regions of the
+     *    instructions above them are dropped, see render_instruction_t::opaque_region.
      * 3. The wlroots render pass begins.
      * 4. Optionally, clear visible background areas with @background_color.
      * 5. Render instructions are executed back-to-front, i.e starting with the last instruction in the list.
@@ -623,6 +641,12 @@ class render_pass_t
      */
     wf::render_target_t get_target() const;
 
+    /**
+     * Get the number of render instructions which were skipped by @run_partial() because they were entirely
+     * occluded by opaque instructions above them.
+     */
+    uint64_t get_culled_instructions() const;
+
     /**
      * Submit the wlroots render pass.
      * Should only be used after run_partial().
@@ -699,6 +723,7 @@ class render_pass_t
     void finish_gles_subpass();
 
     bool needs_restart = false;
+    uint64_t culled_instructions = 0;
     wlr_render_pass *_get_pass();
 };
 
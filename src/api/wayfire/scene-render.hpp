@@ -52,6 +52,14 @@ struct render_instruction_t
     render_target_t target;
     wf::regionf_t damage;
     std::any data = {};
+
+    /**
+     * An optional hint for occlusion culling: the part of the instruction's area (in the same coordinate
+     * system as @damage) which the instance is guaranteed to cover with fully opaque pixels. Instructions
+     * further down the list whose damage is entirely covered by such regions are skipped, see
+     * render_pass_t::run_partial().
+     */
+    wf::regionf_t opaque_region = {};
 };
 
 /**
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <wayfire/util.hpp>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace wf
+{
+/**
+ * A single measured phase of the compositor startup.
+ */
+struct startup_phase_t
+{
+    std::string name;
+    /** Start of the phase relative to the start of the compositor, in microseconds. */
+    int64_t start_us = 0;
+    /** Duration of the phase in microseconds, or -1 if the phase has not finished yet. */
+    int64_t duration_us = -1;
+};
+
+/**
+ * Records how long the different phases of the compositor startup take, e.g. creating the backend and the
+ * renderer, initializing the desktop APIs or loading the plugins, as well as the time until the first frame
+ * is submitted to an output.
+ *
+ * Phases may be nested, in which case they are listed in the order in which they were started. The timings
+ * can be queried with the wayfire/startup-timing IPC method, and are logged once the first frame is shown.
+ */
+class startup_timing_t
+{
+  public:
+    startup_timing_t();
+
+    startup_timing_t(const startup_timing_t&) = delete;
+    startup_timing_t(startup_timing_t&&) = delete;
+    startup_timing_t& operator =(const startup_timing_t&) = delete;
+    startup_timing_t& operator =(startup_timing_t&&) = delete;
+
+    /** Start measuring the phase with the given name. */
+    void begin_phase(const std::string& name);
+
+    /** Finish the last started phase with the given name. No-op if there is no such unfinished phase. */
+    void end_phase(const std::string& name);
+
+    /**
+     * Notify that a frame has been submitted to an output. Only the first call after the compositor has
+     * started running has an effect.
+     */
+    void frame_submitted();
+
+    /** Get all phases recorded so far. */
+    const std::vector<startup_phase_t>& get_phases() const;
+
+    /**
+     * Get the time from the start of the compositor until the first frame was submitted, in microseconds,
+     * or -1 if no frame has been submitted yet.
+     */
+    int64_t get_time_to_first_frame_us() const;
+
+  private:
+    std::chrono::steady_clock::time_point origin;
+    std::vector<startup_phase_t> phases;
+    int64_t first_frame_us = -1;
+    wf::wl_idle_call idle_prewarm_xwayland;
+
+    int64_t now_us() const;
+    void handle_first_frame();
+};
+}
@@ -3,6 +3,7 @@
 #include "wayfire/signal-provider.hpp"
 #include "wayfire/util.hpp"
 #include <wayfire/txn/transaction-object.hpp>
+#include <unordered_set>
 
 namespace wf
 {
@@ -40,10 +41,15 @@ class transaction_t : public signal::provider_t
     void add_object(transaction_object_sptr object);
 
     /**
-     * Get a list of all the objects currently part of the transaction.
+     * Get a list of all the objects currently part of the transaction, in the order they were added.
      */
     const std::vector<transaction_object_sptr>& get_objects() const;
 
+    /**
+     * Check whether the given object is part of the transaction, in constant time.
+     */
+    bool has_object(const transaction_object_sptr& object) const;
+
     /**
      * Commit the transaction, that is, commit the pending state of all participating objects.
      * As soon as all objects are ready or the transaction times out, the state will be applied.
@@ -54,6 +60,8 @@ class transaction_t : public signal::provider_t
 
   private:
     std::vector<transaction_object_sptr> objects;
+    // The same objects as in @objects, for fast membership checks.
+    std::unordered_set<transaction_object_t*> object_set;
     int count_ready_objects = 0;
     uint64_t timeout;
     timer_setter_t timer_setter;
@@ -7,7 +7,10 @@
 #include "wayfire/scene-render.hpp"
 #include "wayfire/scene.hpp"
 #include <memory>
+#include <optional>
+#include <glm/glm.hpp>
 #include <wayfire/render.hpp>
+#include <wayfire/option-wrapper.hpp>
 
 namespace wf
 {
@@ -42,6 +45,63 @@ class opaque_region_node_t
     }
 };
 
+/**
+ * An interface for transformer nodes whose effect is fully described by a (projective) linear
+ * transformation and a color multiplier, for example view_2d_transformer_t and view_3d_transformer_t.
+ *
+ * Chains of such transformers are fused when rendering: instead of every transformer rendering its children
+ * to an auxiliary buffer and sampling it again, only the bottom-most transformer of the chain renders its
+ * children offscreen, and the top-most one draws the result with the composed transformation.
+ *
+ * Custom transformers can opt in by implementing this interface and overriding get_fused_texture() in their
+ * render instance (see transformer_render_instance_t::fuse_linear_transform()).
+ */
+class linear_transformer_node_t
+{
+  public:
+    virtual ~linear_transformer_node_t() = default;
+
+    /**
+     * Get the transformation of the node as a matrix which maps points (x, y, 0, 1) from the coordinate system
+     * of the node's children to homogeneous points in the coordinate system of the node's parent.
+     *
+     * @return The transformation, or std::nullopt if the node cannot be fused in its current state.
+     */
+    virtual std::optional<glm::mat4> get_linear_transform() = 0;
+
+    /**
+     * Get the color multiplier which is applied to the children's (premultiplied) colors.
+     */
+    virtual glm::vec4 get_color_multiplier()
+    {
+        return glm::vec4{1.0f};
+    }
+};
+
+/**
+ * The render-instance side of linear_transformer_node_t, implemented by transformer_render_instance_t.
+ */
+class linear_transformer_render_instance_t
+{
+  public:
+    virtual ~linear_transformer_render_instance_t() = default;
+
+    /**
+     * Collapse this instance (and any linear transformers below it) into the parent's draw call.
+     *
+     * @param scale The scale to use for the texture of the bottom-most transformer's children.
+     * @param transform The parent's accumulated transform, multiplied by the transform of each fused node.
+     * @param color The parent's accumulated color multiplier, multiplied by the color of each fused node.
+     * @param bbox Set to the bounding box of the returned texture, in the coordinate system @transform maps
+     *   from.
+     *
+     * @return The texture to draw with @transform, or nullptr if the instance cannot be fused, in which
+     *   case the parameters are left unchanged.
+     */
+    virtual std::shared_ptr<wf::texture_t> get_fused_texture(float scale, glm::mat4& transform,
+        glm::vec4& color, wf::geometry_t& bbox) = 0;
+};
+
 /**
  * A base class for all transformer nodes.
  * It facilitates the reuse of auxilliary buffers between render instances.
@@ -54,8 +114,14 @@ class transformer_base_node_t : public scene::floating_inner_node_t
     uint32_t optimize_update(uint32_t flags) override;
 
     // A temporary buffer to render children to.
+    // It is taken from (and given back to) the core's shared aux_buffer_pool_t.
     wf::auxilliary_buffer_t inner_content;
 
+    // A multiplier for the resolution of @inner_content, in (0, 1].
+    // Plugins which display the view scaled down (for example scale or expo) can lower it so that the
+    // children are rendered at (roughly) the displayed size instead of at full resolution.
+    float buffer_scale_hint = 1.0f;
+
     // Damage from the children, which is the region of @inner_content that
     // should be repainted on the next frame to have a valid copy of the
     // children's current content.
@@ -91,7 +157,7 @@ class transformer_base_node_t : public scene::floating_inner_node_t
  *   a subclass of transformer_base_node_t.
  */
 template<class NodeType>
-class transformer_render_instance_t : public render_instance_t
+class transformer_render_instance_t : public render_instance_t, public linear_transformer_render_instance_t
 {
   protected:
     std::shared_ptr<wf::texture_t> zero_copy_texture()
@@ -143,6 +209,68 @@ class transformer_render_instance_t : public render_instance_t
         return self->get_updated_contents(self->get_children_bounding_box(), scale, children, _shown_on);
     }
 
+    /**
+     * Like get_texture(), but if the only child is a chain of linear transformers (see
+     * linear_transformer_node_t), their transformations are folded into @transform and @color instead of
+     * rendering each of them to an intermediate buffer.
+     *
+     * @param transform Initially the identity (or the caller's own transform). On return, it maps from the
+     *   coordinate system of @bbox to the coordinate system of this node's children.
+     * @param color Multiplied by the color multipliers of the fused transformers.
+     * @param bbox Set to the bounding box of the returned texture.
+     * @param fused Set to whether any transformers were folded into @transform and @color.
+     */
+    std::shared_ptr<wf::texture_t> get_fused_children_texture(float scale, glm::mat4& transform,
+        glm::vec4& color, wf::geometry_t& bbox, bool& fused)
+    {
+        fused = false;
+        if ((children.size() == 1) && (self->get_children().size() == 1))
+        {
+            auto fusable = dynamic_cast<linear_transformer_render_instance_t*>(children.front().get());
+            if (fusable)
+            {
+                if (auto tex = fusable->get_fused_texture(scale, transform, color, bbox))
+                {
+                    // Our own intermediate buffer is not needed while the chain is fused. The damage
+                    // accumulated for it is dropped too, otherwise it would grow for as long as the chain
+                    // stays fused. If fusing stops, the buffer is reallocated and fully repainted anyway.
+                    self->release_buffers();
+                    self->cached_damage.clear();
+                    fused = true;
+                    return tex;
+                }
+            }
+        }
+
+        bbox = self->get_children_bounding_box();
+        return get_texture(scale);
+    }
+
+    /**
+     * An implementation of get_fused_texture() for render instances of nodes implementing
+     * linear_transformer_node_t, which draw their children only via the node's linear transform and color.
+     */
+    std::shared_ptr<wf::texture_t> fuse_linear_transform(float scale, glm::mat4& transform,
+        glm::vec4& color, wf::geometry_t& bbox)
+    {
+        auto linear = dynamic_cast<linear_transformer_node_t*>(self.get());
+        if (!linear)
+        {
+            return nullptr;
+        }
+
+        auto own_transform = linear->get_linear_transform();
+        if (!own_transform)
+        {
+            return nullptr;
+        }
+
+        transform = transform * own_transform.value();
+        color    *= linear->get_color_multiplier();
+        bool fused_below;
+        return get_fused_children_texture(scale, transform, color, bbox, fused_below);
+    }
+
     void presentation_feedback(wf::output_t *output) override
     {
         for (auto& ch : children)
@@ -209,15 +337,37 @@ class transformer_render_instance_t : public render_instance_t
                         .instance = this,
                         .target   = target,
                         .damage   = std::move(our_damage),
+                        .opaque_region = get_opaque_region(),
                     });
         }
     }
 
+    /**
+     * The region the transformed children are guaranteed to cover with opaque pixels, if the transformer
+     * node implements opaque_region_node_t, otherwise empty.
+     */
+    wf::regionf_t get_opaque_region() const
+    {
+        if (auto opaque = dynamic_cast<opaque_region_node_t*>(self.get()))
+        {
+            return opaque->get_opaque_region();
+        }
+
+        return {};
+    }
+
     void render(const wf::scene::render_instruction_t& data) override
     {
         wf::dassert(false, "Rendering not implemented for view transformer?");
     }
 
+    std::shared_ptr<wf::texture_t> get_fused_texture(float scale, glm::mat4& transform,
+        glm::vec4& color, wf::geometry_t& bbox) override
+    {
+        // Most transformers render their children in a custom way, so they cannot be fused.
+        return nullptr;
+    }
+
     direct_scanout try_scanout(wf::output_t *output) override
     {
         // By default, disable direct scanout
@@ -235,12 +385,22 @@ class transformer_render_instance_t : public render_instance_t
         {
             // By default, we are not sure how the visibility region is affected, so we take a simple 0-or-1
             // approach: if anything of the bounding box is visible, we assume the whole view is visible, and
-            // we do not subtract anything from the visibility region of the nodes below.
+            // we do not subtract anything from the visibility region of the nodes below, except for the
+            // opaque region, if the transformer reports one.
             wf::regionf_t copy{self->get_children_bounding_box()};
             for (auto& ch : this->children)
             {
                 ch->compute_visibility(output, copy);
             }
+
+            static wf::option_wrapper_t<bool> use_opaque_optimizations{
+                "workarounds/enable_opaque_region_damage_optimizations"
+            };
+
+            if (use_opaque_optimizations)
+            {
+                visible ^= get_opaque_region();
+            }
         }
     }
 };
@@ -337,7 +497,8 @@ class transform_manager_node_t : public wf::scene::floating_inner_node_t
 /**
  * A simple transformer which supports 2D transformations on a view.
  */
-class view_2d_transformer_t : public transformer_base_node_t
+class view_2d_transformer_t : public transformer_base_node_t, public linear_transformer_node_t,
+    public opaque_region_node_t
 {
   public:
     float scale_x = 1.0f;
@@ -397,13 +558,21 @@ class view_2d_transformer_t : public transformer_base_node_t
     void gen_render_instances(std::vector<render_instance_uptr>& instances,
         damage_callback push_damage, wf::output_t *shown_on) override;
 
+    std::optional<glm::mat4> get_linear_transform() override;
+    glm::vec4 get_color_multiplier() override;
+
+    /**
+     * The opaque region of the children, transformed. Empty if the view is rotated or made translucent.
+     */
+    wf::regionf_t get_opaque_region() const override;
+
     std::weak_ptr<wf::view_interface_t> view;
 };
 
 /**
  * A simple transformer which supports 3D transformations on a view.
  */
-class view_3d_transformer_t : public transformer_base_node_t
+class view_3d_transformer_t : public transformer_base_node_t, public linear_transformer_node_t
 {
   protected:
     std::weak_ptr<wf::view_interface_t> view;
@@ -423,6 +592,9 @@ class view_3d_transformer_t : public transformer_base_node_t
     void gen_render_instances(std::vector<render_instance_uptr>& instances,
         damage_callback push_damage, wf::output_t *shown_on) override;
 
+    std::optional<glm::mat4> get_linear_transform() override;
+    glm::vec4 get_color_multiplier() override;
+
     static const float fov; // PI / 8
     static glm::mat4 default_view_matrix();
     static glm::mat4 default_proj_matrix();
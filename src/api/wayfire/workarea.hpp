@@ -65,6 +65,12 @@ class output_workarea_manager_t
      */
     wf::geometry_t get_workarea();
 
+    /**
+     * @return The number of times reflow_reserved_areas() was called during the last full second. Useful for
+     *   finding clients which cause excessive relayouts.
+     */
+    int get_reflows_per_second();
+
     output_workarea_manager_t(wf::output_t *output);
     ~output_workarea_manager_t();
 
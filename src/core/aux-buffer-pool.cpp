@@ -0,0 +1,178 @@
+#include "wayfire/aux-buffer-pool.hpp"
+#include "wayfire/debug.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+wf::aux_buffer_pool_t::aux_buffer_pool_t()
+{
+    budget_mib.set_callback([=] ()
+    {
+        trim(get_idle_budget());
+    });
+}
+
+wf::aux_buffer_pool_t::~aux_buffer_pool_t()
+{
+    trim(0);
+}
+
+size_t wf::aux_buffer_pool_t::bucket_size(const bucket_t& bucket)
+{
+    const size_t bytes_per_pixel = bucket.hdr_linear ? 8 : 4;
+    return (size_t)bucket.width * bucket.height * bytes_per_pixel;
+}
+
+size_t wf::aux_buffer_pool_t::get_budget() const
+{
+    return (size_t)std::max(0, (int)budget_mib) * 1024 * 1024;
+}
+
+size_t wf::aux_buffer_pool_t::get_idle_budget() const
+{
+    return get_budget() - std::min(get_budget(), stats.leased_bytes);
+}
+
+wf::buffer_reallocation_result_t wf::aux_buffer_pool_t::acquire(auxilliary_buffer_t& buffer,
+    wf::dimensions_t size, float scale, buffer_allocation_hints_t hints)
+{
+    // Use the size allocate() would actually create, so that buffers limited by
+    // workarounds/max_buffer_size are reused as well.
+    const auto alloc_size = auxilliary_buffer_t::get_allocation_size(size, scale);
+    const bucket_t requested{
+        .width  = alloc_size.width,
+        .height = alloc_size.height,
+        .hdr_linear = hints.hdr_linear,
+    };
+
+    auto degraded_it = degraded.find(requested);
+    const bucket_t wanted = (degraded_it != degraded.end()) ? degraded_it->second : requested;
+    if (buffer.get_buffer() && (buffer.get_size() == wf::dimensions_t{wanted.width, wanted.height}))
+    {
+        return buffer_reallocation_result_t::SAME;
+    }
+
+    release(buffer);
+
+    auto range = idle_by_bucket.equal_range(wanted);
+    if (range.first != range.second)
+    {
+        // Take the most recently pooled buffer, it was inserted last.
+        auto it     = std::prev(range.second);
+        auto lru_it = it->second;
+        buffer = std::move(lru_it->buffer);
+        idle_by_bucket.erase(it);
+        lru.erase(lru_it);
+
+        const size_t bytes = bucket_size(wanted);
+        stats.pooled_bytes -= bytes;
+        stats.pooled_buffers--;
+        stats.leased_bytes += bytes;
+        stats.leased_buffers++;
+        stats.hits++;
+        leased[buffer.get_buffer()] = wanted;
+        return buffer_reallocation_result_t::REALLOCATED;
+    }
+
+    // A degraded bucket goes straight to the smaller size instead of failing with the requested one again.
+    auto result = (degraded_it != degraded.end()) ?
+        buffer.allocate({wanted.width, wanted.height}, 1.0, hints) : buffer.allocate(size, scale, hints);
+    if (result == buffer_reallocation_result_t::FAILED)
+    {
+        return result;
+    }
+
+    // The actual size may differ from the requested one if the buffer was too large.
+    bucket_t actual{
+        .width  = buffer.get_size().width,
+        .height = buffer.get_size().height,
+        .hdr_linear = hints.hdr_linear,
+    };
+
+    stats.leased_bytes += bucket_size(actual);
+    stats.leased_buffers++;
+    stats.misses++;
+    leased[buffer.get_buffer()] = actual;
+    if ((actual.width != requested.width) || (actual.height != requested.height))
+    {
+        // Otherwise, the buffer would be freed and allocated again for each request of this size.
+        degraded[requested] = actual;
+    }
+
+    // Make room for the new buffer by dropping idle buffers if necessary.
+    trim(get_idle_budget());
+    return result;
+}
+
+void wf::aux_buffer_pool_t::release(auxilliary_buffer_t& buffer)
+{
+    if (!buffer.get_buffer())
+    {
+        return;
+    }
+
+    auto it = leased.find(buffer.get_buffer());
+    if (it == leased.end())
+    {
+        // Not allocated by us, we do not know its format class.
+        buffer.free();
+        return;
+    }
+
+    const bucket_t bucket = it->second;
+    const size_t bytes    = bucket_size(bucket);
+    leased.erase(it);
+    stats.leased_bytes -= bytes;
+    stats.leased_buffers--;
+
+    if (bytes > get_idle_budget())
+    {
+        // Would not fit in the budget even with an empty pool.
+        buffer.free();
+        return;
+    }
+
+    lru.push_front(pooled_buffer_t{
+                .bucket = bucket,
+                .buffer = std::move(buffer),
+            });
+    idle_by_bucket.emplace(bucket, lru.begin());
+    stats.pooled_bytes += bytes;
+    stats.pooled_buffers++;
+
+    trim(get_idle_budget());
+}
+
+void wf::aux_buffer_pool_t::evict_lru()
+{
+    auto& victim = lru.back();
+    auto range   = idle_by_bucket.equal_range(victim.bucket);
+    for (auto it = range.first; it != range.second; ++it)
+    {
+        if (&(*it->second) == &victim)
+        {
+            idle_by_bucket.erase(it);
+            break;
+        }
+    }
+
+    stats.pooled_bytes -= bucket_size(victim.bucket);
+    stats.pooled_buffers--;
+    stats.evictions++;
+    lru.pop_back();
+}
+
+void wf::aux_buffer_pool_t::trim(size_t max_bytes)
+{
+    while (!lru.empty() && (stats.pooled_bytes > max_bytes))
+    {
+        evict_lru();
+    }
+}
+
+wf::aux_buffer_pool_stats_t wf::aux_buffer_pool_t::get_stats() const
+{
+    auto result = stats;
+    result.budget_bytes = get_budget();
+    return result;
+}
@@ -9,6 +9,8 @@
 #include <wayfire/workarea.hpp>
 #include "wayfire/scene-operations.hpp"
 #include "wayfire/txn/transaction-manager.hpp"
+#include "wayfire/aux-buffer-pool.hpp"
+#include "wayfire/startup-timing.hpp"
 #include "wayfire/bindings-repository.hpp"
 #include "wayfire/util.hpp"
 #include <memory>
@@ -101,6 +103,7 @@ void wf::compositor_core_impl_t::init()
     this->scene_root = std::make_shared<scene::root_node_t>();
     this->tx_manager = std::make_unique<txn::transaction_manager_t>();
     this->default_wm = std::make_unique<wf::window_manager_t>();
+    this->aux_buffer_pool = std::make_unique<wf::aux_buffer_pool_t>();
 
     wlr_renderer_init_wl_display(renderer, display);
 
@@ -137,7 +140,9 @@ void wf::compositor_core_impl_t::init()
     protocols.ext_data_control = wlr_ext_data_control_manager_v1_create(display, 1);
 
     output_layout = std::make_unique<wf::output_layout_t>(backend);
+    startup_timing->begin_phase("desktop-apis");
     init_desktop_apis();
+    startup_timing->end_phase("desktop-apis");
 
     /* Somehow GTK requires the tablet_v2 to be advertised pretty early */
     protocols.tablet_v2 = wlr_tablet_v2_create(display);
@@ -336,7 +341,9 @@ void wf::compositor_core_impl_t::post_init()
     core_backend_started_signal backend_started_ev;
     this->emit(&backend_started_ev);
     this->state = compositor_state_t::START_PLUGINS;
-    plugin_mgr  = std::make_unique<wf::plugin_manager_t>();
+    startup_timing->begin_phase("plugins");
+    plugin_mgr = std::make_unique<wf::plugin_manager_t>();
+    startup_timing->end_phase("plugins");
     this->bindings->reparse_extensions();
 
     this->state = compositor_state_t::RUNNING;
@@ -412,7 +419,9 @@ void wf::compositor_core_impl_t::fini()
     input.reset();
     output_layout.reset();
     tx_manager.reset();
+    aux_buffer_pool.reset();
 
+    image_io::fini();
     OpenGL::fini();
 #if WF_HAS_VULKANFX
     vulkan_state.reset();
@@ -843,7 +852,9 @@ std::unique_ptr<wf::wayland_global_filter_t> wf::compositor_core_t::create_globa
 }
 
 wf::compositor_core_impl_t::compositor_core_impl_t()
-{}
+{
+    this->startup_timing = std::make_unique<wf::startup_timing_t>();
+}
 wf::compositor_core_impl_t::~compositor_core_impl_t()
 {
     input.reset();
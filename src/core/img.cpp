@@ -16,7 +16,13 @@
 #include <stdint.h>
 #include <unistd.h>
 #include <string.h>
+#include <sys/eventfd.h>
+#include <sys/stat.h>
+#include <algorithm>
 #include <cstdio>
+#include <map>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
 #include <functional>
 
@@ -24,27 +30,34 @@
 
 namespace image_io
 {
-using Loader = std::function<bool (const char*, GLuint)>;
+using Decoder = std::function<bool (const char*, decoded_image_t&)>;
 using Writer = std::function<void (const char*name, uint8_t*pixels, unsigned long,
     unsigned long, bool)>;
 namespace
 {
-std::unordered_map<std::string, Loader> loaders;
+std::unordered_map<std::string, Decoder> decoders;
 std::unordered_map<std::string, Writer> writers;
 }
 
-bool load_data_as_cubemap(unsigned char *data, int width, int height, int channels)
+static GLenum gl_format(const decoded_image_t& image)
 {
-    width  /= 4;
-    height /= 3;
-    int x, y, t;
+    return image.channels == 4 ? GL_RGBA : GL_RGB;
+}
 
-    if (width != height)
+static bool check_cubemap_layout(const decoded_image_t& image)
+{
+    if (image.width / 4 != image.height / 3)
     {
-        LOGE("cubemap width / 4(", width, ") != height / 3(", height, ")");
+        LOGE("cubemap width / 4(", image.width / 4, ") != height / 3(", image.height / 3, ")");
         return false;
     }
 
+    return true;
+}
+
+/* Upload face GL_TEXTURE_CUBE_MAP_POSITIVE_X + @face of a cubemap image. */
+static void upload_cubemap_face(const decoded_image_t& image, int face)
+{
     /*
      *  CUBEMAP IMAGE FORMAT
      *
@@ -68,64 +81,62 @@ bool load_data_as_cubemap(unsigned char *data, int width, int height, int channe
      *  BO: BOTTOM
      *
      */
+    static const int face_x[6] = {2, 0, 1, 1, 1, 3};
+    static const int face_y[6] = {1, 1, 0, 2, 1, 1};
 
-    for (t = GL_TEXTURE_CUBE_MAP_POSITIVE_X;
-         t < GL_TEXTURE_CUBE_MAP_POSITIVE_X + 6;
-         t++)
-    {
-        switch (t)
-        {
-          case GL_TEXTURE_CUBE_MAP_POSITIVE_X:
-            x = 2, y = 1;
-            break;
-
-          case GL_TEXTURE_CUBE_MAP_NEGATIVE_X:
-            x = 0, y = 1;
-            break;
-
-          case GL_TEXTURE_CUBE_MAP_POSITIVE_Y:
-            x = 1, y = 0;
-            break;
+    const int size = image.width / 4;
+    auto format    = gl_format(image);
+    GL_CALL(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+    GL_CALL(glPixelStorei(GL_UNPACK_ROW_LENGTH, image.width));
+    GL_CALL(glPixelStorei(GL_UNPACK_SKIP_ROWS, face_y[face] * size));
+    GL_CALL(glPixelStorei(GL_UNPACK_SKIP_PIXELS, face_x[face] * size));
 
-          case GL_TEXTURE_CUBE_MAP_NEGATIVE_Y:
-            x = 1, y = 2;
-            break;
+    GL_CALL(glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, 0, format, size, size, 0,
+        format, GL_UNSIGNED_BYTE, image.pixels.data()));
 
-          case GL_TEXTURE_CUBE_MAP_POSITIVE_Z:
-            x = 1, y = 1;
-            break;
-
-          case GL_TEXTURE_CUBE_MAP_NEGATIVE_Z:
-            x = 3, y = 1;
-            break;
+    GL_CALL(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
+    GL_CALL(glPixelStorei(GL_UNPACK_SKIP_ROWS, 0));
+    GL_CALL(glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0));
+    GL_CALL(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
+}
 
-          default:
+/* Upload a whole image to the currently bound texture of @target. */
+static bool upload_image(const decoded_image_t& image, GLuint target)
+{
+    if (target == GL_TEXTURE_CUBE_MAP)
+    {
+        if (!check_cubemap_layout(image))
+        {
             return false;
-            break;
         }
 
-        auto format = (channels == 4 ? GL_RGBA : GL_RGB);
-        GL_CALL(glPixelStorei(GL_UNPACK_ROW_LENGTH, width * 4));
-        GL_CALL(glPixelStorei(GL_UNPACK_SKIP_ROWS, y * height));
-        GL_CALL(glPixelStorei(GL_UNPACK_SKIP_PIXELS, x * width));
-
-        GL_CALL(glTexImage2D(t, 0, format, width, height, 0,
-            format, GL_UNSIGNED_BYTE, data));
+        for (int face = 0; face < 6; face++)
+        {
+            upload_cubemap_face(image, face);
+        }
+    } else if (target == GL_TEXTURE_2D)
+    {
+        auto format = gl_format(image);
+        GL_CALL(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+        GL_CALL(glTexImage2D(target, 0, format, image.width, image.height, 0,
+            format, GL_UNSIGNED_BYTE, image.pixels.data()));
+        GL_CALL(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
     }
 
-    GL_CALL(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
-    GL_CALL(glPixelStorei(GL_UNPACK_SKIP_ROWS, 0));
-    GL_CALL(glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0));
-
     return true;
 }
 
 #ifdef BUILD_WITH_IMAGEIO
 /* All backend functions are taken from the internet.
  * If you want to be credited, contact me */
-bool texture_from_png(const char *filename, GLuint target)
+bool decode_png(const char *filename, decoded_image_t& image)
 {
     FILE *fp = fopen(filename, "rb");
+    if (!fp)
+    {
+        return false;
+    }
+
     int width, height;
     png_byte color_type;
     png_byte bit_depth;
@@ -142,12 +153,14 @@ bool texture_from_png(const char *filename, GLuint target)
     png_infop infos = png_create_info_struct(png);
     if (!infos)
     {
+        png_destroy_read_struct(&png, NULL, NULL);
         fclose(fp);
         return false;
     }
 
     if (setjmp(png_jmpbuf(png)))
     {
+        png_destroy_read_struct(&png, &infos, NULL);
         fclose(fp);
         return false;
     }
@@ -197,36 +210,22 @@ bool texture_from_png(const char *filename, GLuint target)
 
     png_read_update_info(png, infos);
 
-    row_pointers = new png_bytep[height];
-    png_byte *data = new png_byte[height * png_get_rowbytes(png, infos)];
+    const size_t rowbytes = png_get_rowbytes(png, infos);
+    image.width    = width;
+    image.height   = height;
+    image.channels = png_get_channels(png, infos);
+    image.pixels.resize(height * rowbytes);
 
+    row_pointers = new png_bytep[height];
     for (int i = 0; i < height; i++)
     {
-        row_pointers[i] = data + i * png_get_rowbytes(png, infos);
+        row_pointers[i] = image.pixels.data() + i * rowbytes;
     }
 
     png_read_image(png, row_pointers);
 
-    if (target == GL_TEXTURE_CUBE_MAP)
-    {
-        if (!load_data_as_cubemap(data, width, height,
-            png_get_channels(png, infos)))
-        {
-            png_destroy_read_struct(&png, &infos, NULL);
-            delete[] row_pointers;
-            delete[] data;
-            fclose(fp);
-            return false;
-        }
-    } else if (target == GL_TEXTURE_2D)
-    {
-        GL_CALL(glTexImage2D(target, 0, GL_RGBA, width, height, 0,
-            GL_RGBA, GL_UNSIGNED_BYTE, (GLvoid*)data));
-    }
-
     png_destroy_read_struct(&png, &infos, NULL);
     delete[] row_pointers;
-    delete[] data;
 
     fclose(fp);
 
@@ -297,67 +296,48 @@ void texture_to_png(const char *name, uint8_t *pixels, int w, int h, bool invert
     png_free(png, rows);
 }
 
-bool texture_from_jpeg(const char *FileName, GLuint target)
+bool decode_jpeg(const char *FileName, decoded_image_t& image)
 {
-    unsigned long data_size;
     unsigned char *rowptr[1];
-    unsigned char *jdata;
     struct jpeg_decompress_struct infot;
     struct jpeg_error_mgr err;
 
     std::FILE *file = fopen(FileName, "rb");
-    infot.err = jpeg_std_error(&err);
-    jpeg_create_decompress(&infot);
-
     if (!file)
     {
-        LOGE("failed to read JPEG file ", FileName);
-
         return false;
     }
 
+    infot.err = jpeg_std_error(&err);
+    jpeg_create_decompress(&infot);
+
     jpeg_stdio_src(&infot, file);
     jpeg_read_header(&infot, TRUE);
+    infot.out_color_space = JCS_RGB;
     jpeg_start_decompress(&infot);
 
-    data_size = infot.output_width * infot.output_height * 3;
-
-    jdata = new unsigned char [data_size];
+    image.width    = infot.output_width;
+    image.height   = infot.output_height;
+    image.channels = 3;
+    image.pixels.resize((size_t)infot.output_width * infot.output_height * 3);
     while (infot.output_scanline < infot.output_height)
     {
-        rowptr[0] = (unsigned char*)jdata + 3 * infot.output_width *
+        rowptr[0] = image.pixels.data() + 3 * infot.output_width *
             infot.output_scanline;
         jpeg_read_scanlines(&infot, rowptr, 1);
     }
 
     jpeg_finish_decompress(&infot);
-
-    GLint width  = infot.output_width;
-    GLint height = infot.output_height;
-
-    if (target == GL_TEXTURE_CUBE_MAP)
-    {
-        if (!load_data_as_cubemap(jdata, width, height, 3))
-        {
-            fclose(file);
-            delete[] jdata;
-            return false;
-        }
-    } else if (target == GL_TEXTURE_2D)
-    {
-        GL_CALL(glTexImage2D(target, 0, GL_RGB, width, height, 0,
-            GL_RGB, GL_UNSIGNED_BYTE, jdata));
-    }
-
+    jpeg_destroy_decompress(&infot);
     fclose(file);
-    delete[] jdata;
 
     return true;
 }
 
 #endif
 
-bool load_from_file(std::string name, GLuint target)
+/* Find the decoder for the given file, logging an error if there is none. */
+static Decoder find_decoder(const std::string& name)
 {
     if (access(name.c_str(), F_OK) == -1)
     {
@@ -366,7 +346,7 @@ bool load_from_file(std::string name, GLuint target)
             LOGE(__func__, "() cannot access ", name);
         }
 
-        return false;
+        return nullptr;
     }
 
     int len = name.length();
@@ -375,7 +355,7 @@ bool load_from_file(std::string name, GLuint target)
         LOGE(
             "load_from_file() called with file without extension or with invalid extension!");
 
-        return false;
+        return nullptr;
     }
 
     auto ext = name.substr(len - 3, 3);
@@ -384,16 +364,107 @@ bool load_from_file(std::string name, GLuint target)
         ext[i] = std::tolower(ext[i]);
     }
 
-    auto it = loaders.find(ext);
-    if (it == loaders.end())
+    auto it = decoders.find(ext);
+    if (it == decoders.end())
     {
         LOGE("load_from_file() called with unsupported extension ", ext);
 
-        return false;
-    } else
+        return nullptr;
+    }
+
+    return it->second;
+}
+
+/* Shrink the image by the smallest integer factor which makes it fit in @max_size, averaging each
+ * factor x factor block of pixels. */
+static void downsample(decoded_image_t& image, wf::dimensions_t max_size)
+{
+    int factor = 1;
+    if (max_size.width > 0)
+    {
+        factor = std::max(factor, (image.width + max_size.width - 1) / max_size.width);
+    }
+
+    if (max_size.height > 0)
     {
-        return it->second(name.c_str(), target);
+        factor = std::max(factor, (image.height + max_size.height - 1) / max_size.height);
     }
+
+    if (factor <= 1)
+    {
+        return;
+    }
+
+    const int width  = image.width / factor;
+    const int height = image.height / factor;
+    const int row_values = width * image.channels;
+    const size_t src_stride = (size_t)image.width * image.channels;
+    std::vector<uint8_t> result((size_t)height * row_values);
+    std::vector<uint32_t> sums(row_values);
+    for (int y = 0; y < height; y++)
+    {
+        std::fill(sums.begin(), sums.end(), 0);
+        for (int sy = 0; sy < factor; sy++)
+        {
+            const uint8_t *row = image.pixels.data() + (y * factor + sy) * src_stride;
+            for (int x = 0; x < width; x++)
+            {
+                for (int sx = 0; sx < factor; sx++)
+                {
+                    const uint8_t *pixel = row + (x * factor + sx) * image.channels;
+                    for (int c = 0; c < image.channels; c++)
+                    {
+                        sums[x * image.channels + c] += pixel[c];
+                    }
+                }
+            }
+        }
+
+        uint8_t *out = result.data() + (size_t)y * row_values;
+        for (int i = 0; i < row_values; i++)
+        {
+            out[i] = sums[i] / (factor * factor);
+        }
+    }
+
+    image.width  = width;
+    image.height = height;
+    image.pixels = std::move(result);
+}
+
+static std::shared_ptr<const decoded_image_t> decode_with(const Decoder& decoder, const std::string& name,
+    wf::dimensions_t max_size)
+{
+    auto image = std::make_shared<decoded_image_t>();
+    if (!decoder(name.c_str(), *image) || (image->width <= 0) || (image->height <= 0))
+    {
+        return nullptr;
+    }
+
+    downsample(*image, max_size);
+    return image;
+}
+
+std::shared_ptr<const decoded_image_t> decode_file(const std::string& name, wf::dimensions_t max_size)
+{
+    auto decoder = find_decoder(name);
+    if (!decoder)
+    {
+        return nullptr;
+    }
+
+    return decode_with(decoder, name, max_size);
+}
+
+bool load_from_file(std::string name, GLuint target)
+{
+    auto image = decode_file(name);
+    if (!image)
+    {
+        return false;
+    }
+
+    return upload_image(*image, target);
 }
 
 void write_to_file(std::string name, uint8_t *pixels, int w, int h, std::string type,
@@ -430,13 +501,424 @@ void write_to_file(std::string name, const wf::render_buffer_t& fb)
     wlr_texture_destroy(tex);
 }
 
+namespace
+{
+/* Decoded images are kept in memory for reloads up to this total size. */
+constexpr size_t DECODED_CACHE_BUDGET = 128 << 20;
+/* Upper bound for the amount of pixel data uploaded in one slice of an async load. */
+constexpr size_t UPLOAD_SLICE_BYTES = 4 << 20;
+/* Delay between two upload slices, so that frames can be rendered in between. */
+constexpr uint32_t UPLOAD_SLICE_INTERVAL_MS = 1;
+
+using image_ptr = std::shared_ptr<const decoded_image_t>;
+
+/* Identifies a version of a file on disk. */
+struct file_stamp_t
+{
+    timespec mtime;
+    off_t size;
+
+    bool operator ==(const file_stamp_t& other) const
+    {
+        return (mtime.tv_sec == other.mtime.tv_sec) && (mtime.tv_nsec == other.mtime.tv_nsec) &&
+               (size == other.size);
+    }
+};
+
+bool get_file_stamp(const std::string& name, file_stamp_t& stamp)
+{
+    struct stat st;
+    if (stat(name.c_str(), &st) != 0)
+    {
+        return false;
+    }
+
+    stamp.mtime = st.st_mtim;
+    stamp.size  = st.st_size;
+    return true;
+}
+
+/* State shared between the main thread and the worker thread decoding an image. */
+struct decode_task_t
+{
+    std::string name;
+    wf::dimensions_t max_size;
+    Decoder decoder;
+    int event_fd = -1;
+
+    std::mutex mutex;
+    image_ptr result;
+
+    ~decode_task_t()
+    {
+        if (event_fd != -1)
+        {
+            close(event_fd);
+        }
+    }
+};
+
+struct pending_decode_t
+{
+    std::string pending_key;
+    std::string cache_key;
+    file_stamp_t stamp;
+    std::shared_ptr<decode_task_t> task;
+    wl_event_source *source = nullptr;
+    std::vector<std::function<void (image_ptr)>> waiters;
+};
+
+struct cached_image_t
+{
+    file_stamp_t stamp;
+    image_ptr image;
+    uint64_t last_use;
+};
+
+/**
+ * Runs decodes on worker threads and caches their results. Only used from the main thread, requests for an
+ * image which is already being decoded share the same decode.
+ */
+class async_decoder_t
+{
+  public:
+    ~async_decoder_t()
+    {
+        for (auto& [key, pending] : in_flight)
+        {
+            wl_event_source_remove(pending->source);
+        }
+    }
+
+    /* Call @waiter with the decoded image, or nullptr on failure. If the image is cached, @waiter is
+     * called before request() returns. */
+    void request(const std::string& name, wf::dimensions_t max_size, Decoder decoder,
+        const file_stamp_t& stamp, std::function<void (image_ptr)> waiter)
+    {
+        std::string cache_key = name + '\n' + std::to_string(max_size.width) + 'x' +
+            std::to_string(max_size.height);
+        auto cached = cache.find(cache_key);
+        if (cached != cache.end())
+        {
+            if (cached->second.stamp == stamp)
+            {
+                cached->second.last_use = ++use_counter;
+                waiter(cached->second.image);
+                return;
+            }
+
+            cached_bytes -= cached->second.image->pixels.size();
+            cache.erase(cached);
+        }
+
+        std::string pending_key = cache_key + '\n' + std::to_string(stamp.mtime.tv_sec) + '.' +
+            std::to_string(stamp.mtime.tv_nsec) + '\n' + std::to_string(stamp.size);
+        auto& pending = in_flight[pending_key];
+        if (pending)
+        {
+            pending->waiters.push_back(std::move(waiter));
+            return;
+        }
+
+        auto task = std::make_shared<decode_task_t>();
+        task->name     = name;
+        task->max_size = max_size;
+        task->decoder  = std::move(decoder);
+        task->event_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        if (task->event_fd == -1)
+        {
+            LOGE("Failed to create eventfd, decoding ", name, " on the main thread");
+            in_flight.erase(pending_key);
+            waiter(decode_with(task->decoder, name, max_size));
+            return;
+        }
+
+        pending = std::make_unique<pending_decode_t>();
+        pending->pending_key = pending_key;
+        pending->cache_key   = cache_key;
+        pending->stamp = stamp;
+        pending->task  = task;
+        pending->waiters.push_back(std::move(waiter));
+        pending->source = wl_event_loop_add_fd(wf::get_core().ev_loop, task->event_fd,
+            WL_EVENT_READABLE, handle_decode_done, pending.get());
+
+        // The thread keeps the task alive, so it is fine if we are gone by the time it finishes.
+        std::thread([task] ()
+        {
+            auto image = decode_with(task->decoder, task->name, task->max_size);
+            {
+                std::lock_guard<std::mutex> lock(task->mutex);
+                task->result = std::move(image);
+            }
+
+            eventfd_write(task->event_fd, 1);
+        }).detach();
+    }
+
+  private:
+    std::map<std::string, cached_image_t> cache;
+    size_t cached_bytes  = 0;
+    uint64_t use_counter = 0;
+    std::map<std::string, std::unique_ptr<pending_decode_t>> in_flight;
+
+    static int handle_decode_done(int fd, uint32_t mask, void *data);
+
+    void finish(pending_decode_t *done)
+    {
+        eventfd_t value;
+        eventfd_read(done->task->event_fd, &value);
+        wl_event_source_remove(done->source);
+
+        auto it = in_flight.find(done->pending_key);
+        auto pending = std::move(it->second);
+        in_flight.erase(it);
+
+        image_ptr image;
+        {
+            std::lock_guard<std::mutex> lock(pending->task->mutex);
+            image = pending->task->result;
+        }
+
+        if (image)
+        {
+            add_to_cache(pending->cache_key, pending->stamp, image);
+        }
+
+        for (auto& waiter : pending->waiters)
+        {
+            waiter(image);
+        }
+    }
+
+    void add_to_cache(const std::string& key, const file_stamp_t& stamp, image_ptr image)
+    {
+        const size_t size = image->pixels.size();
+        if (size > DECODED_CACHE_BUDGET)
+        {
+            return;
+        }
+
+        // A stale entry for the same file (for example after it changed on disk) is replaced, so its
+        // bytes must not be counted twice.
+        auto existing = cache.find(key);
+        if (existing != cache.end())
+        {
+            cached_bytes -= existing->second.image->pixels.size();
+            cache.erase(existing);
+        }
+
+        while (cached_bytes + size > DECODED_CACHE_BUDGET)
+        {
+            auto oldest = std::min_element(cache.begin(), cache.end(), [] (auto& a, auto& b)
+            {
+                return a.second.last_use < b.second.last_use;
+            });
+            cached_bytes -= oldest->second.image->pixels.size();
+            cache.erase(oldest);
+        }
+
+        cache[key] = {stamp, image, ++use_counter};
+        cached_bytes += size;
+    }
+};
+
+std::unique_ptr<async_decoder_t> async_decoder;
+
+int async_decoder_t::handle_decode_done(int, uint32_t, void *data)
+{
+    async_decoder->finish(static_cast<pending_decode_t*>(data));
+    return 0;
+}
+}
+
+struct async_texture_loader_t::impl
+{
+    // Reset whenever the current load finishes or is cancelled, so that stale decodes are ignored.
+    std::shared_ptr<bool> token;
+    callback_t on_ready;
+    std::string name;
+    GLuint target = 0;
+
+    image_ptr image;
+    int next_slice = 0;
+    GLuint tex     = 0;
+    GLuint result  = 0;
+
+    wf::wl_timer<true> upload_timer;
+    wf::wl_idle_call deliver;
+
+    void start_upload(image_ptr decoded)
+    {
+        if (!decoded)
+        {
+            LOGE("Failed to decode image ", name);
+            deliver.run_once();
+            return;
+        }
+
+        if ((target == GL_TEXTURE_CUBE_MAP) && !check_cubemap_layout(*decoded))
+        {
+            deliver.run_once();
+            return;
+        }
+
+        image = std::move(decoded);
+        next_slice = 0;
+        upload_timer.set_timeout(UPLOAD_SLICE_INTERVAL_MS, [this] () { return upload_slice(); });
+    }
+
+    /* Upload one face of a cubemap or a band of rows of a 2D texture, returns true if more remain. */
+    bool upload_slice()
+    {
+        bool done = false;
+        wf::gles::run_in_context([&]
+        {
+            auto format = gl_format(*image);
+            if (!tex)
+            {
+                GL_CALL(glGenTextures(1, &tex));
+                if (target == GL_TEXTURE_2D)
+                {
+                    GL_CALL(glBindTexture(GL_TEXTURE_2D, tex));
+                    GL_CALL(glTexImage2D(GL_TEXTURE_2D, 0, format, image->width, image->height, 0,
+                        format, GL_UNSIGNED_BYTE, nullptr));
+                }
+            }
+
+            GL_CALL(glBindTexture(target, tex));
+            if (target == GL_TEXTURE_CUBE_MAP)
+            {
+                upload_cubemap_face(*image, next_slice++);
+                done = (next_slice == 6);
+            } else
+            {
+                const size_t stride = (size_t)image->width * image->channels;
+                const int rows = std::min<int>(image->height - next_slice,
+                    std::max<size_t>(1, UPLOAD_SLICE_BYTES / stride));
+                GL_CALL(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+                GL_CALL(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, next_slice, image->width, rows,
+                    format, GL_UNSIGNED_BYTE, image->pixels.data() + next_slice * stride));
+                GL_CALL(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
+                next_slice += rows;
+                done = (next_slice >= image->height);
+            }
+
+            GL_CALL(glBindTexture(target, 0));
+        });
+
+        if (!done)
+        {
+            return true;
+        }
+
+        result = tex;
+        tex    = 0;
+        image.reset();
+        deliver.run_once();
+        return false;
+    }
+
+    void delete_textures()
+    {
+        if (!tex && !result)
+        {
+            return;
+        }
+
+        wf::gles::run_in_context([&]
+        {
+            for (GLuint *t : {&tex, &result})
+            {
+                if (*t)
+                {
+                    GL_CALL(glDeleteTextures(1, t));
+                    *t = 0;
+                }
+            }
+        });
+    }
+};
+
+async_texture_loader_t::async_texture_loader_t() : priv(std::make_unique<impl>())
+{
+    priv->deliver.set_callback([this] ()
+    {
+        auto callback = std::move(priv->on_ready);
+        GLuint tex    = priv->result;
+        priv->on_ready = nullptr;
+        priv->result   = 0;
+        priv->token.reset();
+        callback(tex);
+    });
+}
+
+async_texture_loader_t::~async_texture_loader_t()
+{
+    cancel();
+}
+
+void async_texture_loader_t::load(const std::string& name, GLuint target, wf::dimensions_t max_size,
+    callback_t on_ready)
+{
+    cancel();
+    priv->token    = std::make_shared<bool>(true);
+    priv->on_ready = std::move(on_ready);
+    priv->name     = name;
+    priv->target   = target;
+    if (target == GL_TEXTURE_CUBE_MAP)
+    {
+        // Faces must stay square, which downsampling by an arbitrary factor does not guarantee.
+        max_size = {0, 0};
+    }
+
+    file_stamp_t stamp;
+    auto decoder = find_decoder(name);
+    if (!decoder || !get_file_stamp(name, stamp) || !async_decoder)
+    {
+        priv->deliver.run_once();
+        return;
+    }
+
+    std::weak_ptr<bool> token = priv->token;
+    auto on_decoded = [loader = priv.get(), token] (image_ptr image)
+    {
+        // The token is owned by the loader, so if it is still there, the loader is alive as well.
+        if (token.lock())
+        {
+            loader->start_upload(std::move(image));
+        }
+    };
+    async_decoder->request(name, max_size, std::move(decoder), stamp, on_decoded);
+}
+
+void async_texture_loader_t::cancel()
+{
+    priv->token.reset();
+    priv->on_ready = nullptr;
+    priv->upload_timer.disconnect();
+    priv->deliver.disconnect();
+    priv->image.reset();
+    priv->delete_textures();
+}
+
+bool async_texture_loader_t::is_loading() const
+{
+    return priv->token != nullptr;
+}
+
 void init()
 {
     LOGD("init ImageIO");
 #ifdef BUILD_WITH_IMAGEIO
-    loaders["png"] = Loader(texture_from_png);
-    loaders["jpg"] = Loader(texture_from_jpeg);
-    writers["png"] = Writer(texture_to_png);
+    decoders["png"] = Decoder(decode_png);
+    decoders["jpg"] = Decoder(decode_jpeg);
+    writers["png"]  = Writer(texture_to_png);
 #endif
+    async_decoder = std::make_unique<async_decoder_t>();
+}
+
+void fini()
+{
+    async_decoder.reset();
 }
 }
@@ -1,10 +1,167 @@
 #include <wayfire/matcher.hpp>
+#include <wayfire/core.hpp>
 #include <wayfire/util/log.hpp>
 #include <wayfire/lexer/lexer.hpp>
 #include <wayfire/option-wrapper.hpp>
 #include <wayfire/condition/condition.hpp>
 #include <wayfire/view-access-interface.hpp>
 #include <wayfire/parser/condition_parser.hpp>
+#include <wayfire/signal-definitions.hpp>
+#include <wayfire/toplevel-view.hpp>
+#include <unordered_map>
+
+namespace
+{
+wf::view_matcher_cache_stats_t cache_stats;
+
+/**
+ * The view properties a condition may depend on. Properties which are tracked via signals invalidate the
+ * cached results when the signal is emitted. The rest are (cheaply) compared against a snapshot, because
+ * the access interface reports pending state which has no signal of its own.
+ */
+enum matcher_dependency_t : uint32_t
+{
+    DEP_APP_ID      = (1 << 0),
+    DEP_TITLE       = (1 << 1),
+    DEP_ACTIVATED   = (1 << 2),
+    DEP_MINIMIZED   = (1 << 3),
+    DEP_SNAPSHOT    = (1 << 4),
+    DEP_UNCACHEABLE = (1 << 5),
+};
+
+/**
+ * The cheap-to-read view state which is validated on each lookup instead of being tracked by signals.
+ */
+struct view_snapshot_t
+{
+    wf::view_role_t role;
+    uint32_t tiled_edges;
+    bool fullscreen;
+    bool mapped;
+    bool focusable;
+
+    static view_snapshot_t of(wayfire_view view)
+    {
+        auto toplevel = wf::toplevel_cast(view);
+        return {
+            .role = view->role,
+            .tiled_edges = toplevel ? toplevel->pending_tiled_edges() : 0,
+            .fullscreen  = toplevel ? toplevel->pending_fullscreen() : false,
+            .mapped = view->is_mapped(),
+            .focusable = view->is_focusable(),
+        };
+    }
+
+    bool operator ==(const view_snapshot_t& other) const
+    {
+        return (role == other.role) && (tiled_edges == other.tiled_edges) &&
+               (fullscreen == other.fullscreen) && (mapped == other.mapped) && (focusable == other.focusable);
+    }
+};
+
+/**
+ * An access interface which records which properties the condition reads.
+ */
+class recording_access_interface_t : public wf::view_access_interface_t
+{
+  public:
+    recording_access_interface_t(wayfire_view view) : view_access_interface_t(view), view(view)
+    {}
+
+    wf::variant_t get(const std::string & identifier, bool & error) override
+    {
+        dependencies |= get_dependency(identifier);
+        return view_access_interface_t::get(identifier, error);
+    }
+
+    uint32_t dependencies = 0;
+
+  private:
+    wayfire_view view;
+
+    uint32_t get_dependency(const std::string& identifier)
+    {
+        if (identifier == "app_id")
+        {
+            return DEP_APP_ID;
+        } else if (identifier == "title")
+        {
+            return DEP_TITLE;
+        } else if (identifier == "activated")
+        {
+            return DEP_ACTIVATED;
+        } else if (identifier == "minimized")
+        {
+            return DEP_MINIMIZED;
+        } else if ((identifier == "role") || (identifier == "fullscreen") || (identifier == "mapped") ||
+                   (identifier == "focusable") || (identifier == "maximized") || (identifier == "floating") ||
+                   (identifier.rfind("tiled-", 0) == 0))
+        {
+            return DEP_SNAPSHOT;
+        } else if (identifier == "type")
+        {
+            // The type of toplevels depends only on the role, for other views it depends on the layer.
+            return (view->role == wf::VIEW_ROLE_TOPLEVEL) ? DEP_SNAPSHOT : DEP_UNCACHEABLE;
+        }
+
+        return DEP_UNCACHEABLE;
+    }
+};
+
+/**
+ * The cached results of all matchers for a single view.
+ */
+class matcher_cache_t : public wf::custom_data_t
+{
+  public:
+    struct entry_t
+    {
+        bool result;
+        uint32_t dependencies;
+        view_snapshot_t snapshot;
+    };
+
+    // Keyed by the matcher's condition id, see view_matcher_t::impl.
+    std::unordered_map<uint64_t, entry_t> entries;
+
+    matcher_cache_t(wayfire_view view)
+    {
+        view->connect(&on_app_id_changed);
+        view->connect(&on_title_changed);
+        view->connect(&on_activated);
+        view->connect(&on_minimized);
+    }
+
+  private:
+    void invalidate(uint32_t dependency)
+    {
+        for (auto it = entries.begin(); it != entries.end();)
+        {
+            it = (it->second.dependencies & dependency) ? entries.erase(it) : std::next(it);
+        }
+    }
+
+    wf::signal::connection_t<wf::view_app_id_changed_signal> on_app_id_changed = [=] (auto)
+    {
+        invalidate(DEP_APP_ID);
+    };
+
+    wf::signal::connection_t<wf::view_title_changed_signal> on_title_changed = [=] (auto)
+    {
+        invalidate(DEP_TITLE);
+    };
+
+    wf::signal::connection_t<wf::view_activated_state_signal> on_activated = [=] (auto)
+    {
+        invalidate(DEP_ACTIVATED);
+    };
+
+    wf::signal::connection_t<wf::view_minimized_signal> on_minimized = [=] (auto)
+    {
+        invalidate(DEP_MINIMIZED);
+    };
+};
+}
 
 class wf::view_matcher_t::impl
 {
@@ -15,8 +172,34 @@ class wf::view_matcher_t::impl
     wf::condition_parser_t parser;
     std::shared_ptr<wf::condition_t> condition;
 
+    /**
+     * Identifies the current condition in the views' result caches. A new id is used whenever the condition
+     * changes, so that results of the old condition are never reused. The results of the old id are dropped
+     * from the caches then, and when the matcher is destroyed.
+     */
+    uint64_t condition_id = next_condition_id();
+
+    static uint64_t next_condition_id()
+    {
+        static uint64_t last_id = 0;
+        return ++last_id;
+    }
+
+    void drop_cached_results()
+    {
+        for (auto& view : wf::get_core().get_all_views())
+        {
+            if (auto cache = view->get_data<matcher_cache_t>())
+            {
+                cache->entries.erase(condition_id);
+            }
+        }
+    }
+
     bool try_parse(const std::string& value, const std::string& opt_name)
     {
+        drop_cached_results();
+        condition_id = next_condition_id();
         lexer.reset(value);
         try {
             condition = parser.parse(lexer);
@@ -75,6 +258,7 @@ class wf::view_matcher_t::impl
     ~impl()
     {
         disconnect_updated_handler();
+        drop_cached_results();
     }
 
     impl(const impl &) = delete;
@@ -110,15 +294,53 @@ void wf::view_matcher_t::set_from_option(
 
 bool wf::view_matcher_t::matches(wayfire_view view)
 {
-    if (this->priv->condition)
+    if (!this->priv->condition)
+    {
+        return false;
+    }
+
+    if (!view)
     {
         bool ignored = false;
         wf::view_access_interface_t access_interface{view};
-
         return this->priv->condition->evaluate(access_interface, ignored);
     }
 
-    return false;
+    auto cache = view->get_data<matcher_cache_t>();
+    if (!cache)
+    {
+        view->store_data(std::make_unique<matcher_cache_t>(view));
+        cache = view->get_data<matcher_cache_t>();
+    }
+
+    auto snapshot = view_snapshot_t::of(view);
+    auto it = cache->entries.find(priv->condition_id);
+    if ((it != cache->entries.end()) &&
+        (!(it->second.dependencies & DEP_SNAPSHOT) || (it->second.snapshot == snapshot)))
+    {
+        cache_stats.hits++;
+        return it->second.result;
+    }
+
+    cache_stats.misses++;
+    bool ignored = false;
+    recording_access_interface_t access_interface{view};
+    const bool result = this->priv->condition->evaluate(access_interface, ignored);
+    if (access_interface.dependencies & DEP_UNCACHEABLE)
+    {
+        cache_stats.uncacheable++;
+        cache->entries.erase(priv->condition_id);
+    } else
+    {
+        cache->entries[priv->condition_id] = {result, access_interface.dependencies, snapshot};
+    }
+
+    return result;
+}
+
+wf::view_matcher_cache_stats_t wf::view_matcher_t::get_cache_stats()
+{
+    return cache_stats;
 }
 
 wf::view_matcher_t::~view_matcher_t() = default;
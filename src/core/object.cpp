@@ -1,5 +1,6 @@
 #include "wayfire/object.hpp"
 #include <unordered_map>
+#include <vector>
 #include <wayfire/signal-provider.hpp>
 #include <wayfire/nonstd/safe-list.hpp>
 #include <wayfire/util/log.hpp>
@@ -58,11 +59,81 @@ void wf::signal::provider_t::disconnect(connection_base_t *callback)
     }
 }
 
+namespace
+{
+struct slot_registry_t
+{
+    std::unordered_map<std::string, uint32_t> slot_by_name;
+    std::vector<std::string> names;
+};
+
+slot_registry_t& get_slot_registry()
+{
+    static slot_registry_t registry;
+    return registry;
+}
+}
+
+uint32_t wf::custom_data_slots::register_slot(const std::string& name)
+{
+    auto& registry = get_slot_registry();
+    auto it = registry.slot_by_name.find(name);
+    if (it != registry.slot_by_name.end())
+    {
+        return it->second;
+    }
+
+    const uint32_t slot = registry.names.size();
+    registry.names.push_back(name);
+    registry.slot_by_name[name] = slot;
+    return slot;
+}
+
+std::optional<uint32_t> wf::custom_data_slots::find_slot(const std::string& name)
+{
+    auto& registry = get_slot_registry();
+    auto it = registry.slot_by_name.find(name);
+    if (it == registry.slot_by_name.end())
+    {
+        return {};
+    }
+
+    return it->second;
+}
+
+const std::string& wf::custom_data_slots::get_slot_name(uint32_t slot)
+{
+    return get_slot_registry().names.at(slot);
+}
+
 class wf::object_base_t::obase_impl
 {
   public:
-    std::unordered_map<std::string, std::unique_ptr<custom_data_t>> data;
+    struct entry_t
+    {
+        uint32_t slot;
+        // The type the data was stored as, see object_base_t::_cast_data()
+        const std::type_info *type;
+        std::unique_ptr<custom_data_t> data;
+    };
+
+    // Objects usually carry only a handful of entries, so a linear scan over a contiguous array is
+    // faster than any map.
+    std::vector<entry_t> data;
     uint32_t object_id;
+
+    entry_t *find(uint32_t slot)
+    {
+        for (auto& entry : data)
+        {
+            if (entry.slot == slot)
+            {
+                return &entry;
+            }
+        }
+
+        return nullptr;
+    }
 };
 
 wf::object_base_t::object_base_t()
@@ -87,62 +158,94 @@ uint32_t wf::object_base_t::get_id() const
 
 bool wf::object_base_t::has_data(std::string name)
 {
-    return _fetch_data(name) != nullptr;
+    auto slot = custom_data_slots::find_slot(name);
+    return slot && _fetch_data(*slot);
 }
 
 void wf::object_base_t::erase_data(std::string name)
 {
-    if (!has_data(name))
+    if (auto slot = custom_data_slots::find_slot(name))
+    {
+        _erase_data(*slot);
+    }
+}
+
+void wf::object_base_t::_erase_data(uint32_t slot)
+{
+    auto entry = obase_priv->find(slot);
+    if (!entry)
     {
         return;
     }
 
-    auto data = std::move(obase_priv->data[name]);
-    obase_priv->data.erase(name);
+    // Remove the entry before destroying the data, its destructor may access the object's data.
+    auto data = std::move(entry->data);
+    obase_priv->data.erase(obase_priv->data.begin() + (entry - obase_priv->data.data()));
     data.reset();
 }
 
-wf::custom_data_t*wf::object_base_t::_fetch_data(std::string name)
+wf::custom_data_t*wf::object_base_t::_fetch_data(uint32_t slot, const std::type_info **stored_type)
 {
-    auto it = obase_priv->data.find(name);
-    if (it == obase_priv->data.end())
+    auto entry = obase_priv->find(slot);
+    if (!entry)
     {
         return nullptr;
     }
 
-    return it->second.get();
+    if (stored_type)
+    {
+        *stored_type = entry->type;
+    }
+
+    return entry->data.get();
 }
 
-wf::custom_data_t*wf::object_base_t::_fetch_erase(std::string name)
+wf::custom_data_t*wf::object_base_t::_fetch_erase(uint32_t slot)
 {
-    auto data = obase_priv->data[name].release();
-    erase_data(name);
+    auto entry = obase_priv->find(slot);
+    if (!entry)
+    {
+        return nullptr;
+    }
 
+    auto data = entry->data.release();
+    _erase_data(slot);
     return data;
 }
 
-void wf::object_base_t::_store_data(std::unique_ptr<wf::custom_data_t> data,
-    std::string name)
+void wf::object_base_t::_store_data(std::unique_ptr<wf::custom_data_t> data, uint32_t slot,
+    const std::type_info& type)
 {
-    obase_priv->data[name] = std::move(data);
+    if (auto entry = obase_priv->find(slot))
+    {
+        // Replace the old data only after the entry is updated, in case its destructor accesses the object.
+        auto old = std::move(entry->data);
+        entry->data = std::move(data);
+        entry->type = &type;
+        old.reset();
+        return;
+    }
+
+    obase_priv->data.push_back({slot, &type, std::move(data)});
 }
 
 void wf::object_base_t::_clear_data()
 {
-    std::vector<std::string> keys;
-    for (auto const& [key, val] : obase_priv->data)
+    std::vector<uint32_t> slots;
+    for (auto const& entry : obase_priv->data)
     {
-        keys.push_back(key);
+        slots.push_back(entry.slot);
     }
 
-    for (const auto& key : keys)
+    for (const auto& slot : slots)
     {
-        erase_data(key);
+        _erase_data(slot);
     }
 }
 
 void wf::object_base_t::_warn_wrong_type(std::string name)
 {
+    auto slot = custom_data_slots::find_slot(name);
     LOGW("Tried to access data with name '", name, "' using the wrong type. Actual type: ",
-        typeid(_fetch_data(name)).name());
+        typeid(slot ? _fetch_data(*slot) : nullptr).name());
 }
@@ -3,17 +3,23 @@
 #include <memory>
 #include <filesystem>
 #include <dlfcn.h>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <thread>
 
 #include "config.h"
 #include "plugin-loader.hpp"
 #include "../core/wm.hpp"
 #include "wayfire/plugin.hpp"
+#include "wayfire/debug.hpp"
 #include <wayfire/util/log.hpp>
 
 wf::plugin_manager_t::plugin_manager_t()
 {
     this->plugins_opt.load_option("core/plugins");
     this->enable_so_unloading.load_option("workarounds/enable_so_unloading");
+    this->parallel_loading.load_option("core/parallel_plugin_loading");
 
     reload_dynamic_plugins();
     load_static_plugins();
@@ -79,7 +85,7 @@ void wf::plugin_manager_t::destroy_plugin(wf::loaded_plugin_t& p)
     }
 }
 
-static bool check_plugin_api_version(const std::string& path, bool can_unload_so)
+static bool check_plugin_api_version(const std::string& path, bool can_unload_so, std::string& error)
 {
     // First, open everything just locally and in a lazy way.
     // We want to check just the API/ABI version.
@@ -88,7 +94,7 @@ static bool check_plugin_api_version(const std::string& path, bool can_unload_so
     void *handle = dlopen(path.c_str(), RTLD_LOCAL | RTLD_LAZY);
     if (handle == NULL)
     {
-        LOGE("error loading plugin [", path, "]: ", dlerror());
+        error = "error loading plugin [" + path + "]: " + dlerror();
         return false;
     }
 
@@ -96,7 +102,7 @@ static bool check_plugin_api_version(const std::string& path, bool can_unload_so
     auto version_func_ptr = dlsym(handle, "getWayfireVersion");
     if (version_func_ptr == NULL)
     {
-        LOGE(path, ": missing getWayfireVersion()", path.c_str());
+        error = path + ": missing getWayfireVersion()";
         dlclose(handle);
         return false;
     }
@@ -106,8 +112,9 @@ static bool check_plugin_api_version(const std::string& path, bool can_unload_so
 
     if (version_func() != WAYFIRE_API_ABI_VERSION)
     {
-        LOGE(path, ": API/ABI version mismatch: Wayfire is ",
-            WAYFIRE_API_ABI_VERSION, ",  plugin built with ", plugin_abi_version);
+        error = path + ": API/ABI version mismatch: Wayfire is " +
+            std::to_string(WAYFIRE_API_ABI_VERSION) + ",  plugin built with " +
+            std::to_string(plugin_abi_version);
         dlclose(handle);
         return false;
     }
@@ -120,9 +127,13 @@ static bool check_plugin_api_version(const std::string& path, bool can_unload_so
     return true;
 }
 
-std::pair<void*, void*> wf::get_new_instance_handle(const std::string& path, bool can_unload_so)
+/**
+ * Same as get_new_instance_handle(), but instead of logging errors, store them in @error.
+ * Safe to call from other threads than the main one.
+ */
+static std::pair<void*, void*> open_plugin(const std::string& path, bool can_unload_so, std::string& error)
 {
-    if (!check_plugin_api_version(path, can_unload_so))
+    if (!check_plugin_api_version(path, can_unload_so, error))
     {
         return {nullptr, nullptr};
     }
@@ -131,7 +142,7 @@ std::pair<void*, void*> wf::get_new_instance_handle(const std::string& path, boo
     void *handle = dlopen(path.c_str(), RTLD_NOW | RTLD_GLOBAL);
     if (handle == NULL)
     {
-        LOGE("error loading plugin [", path, "]: ", dlerror());
+        error = "error loading plugin [" + path + "]: " + dlerror();
         return {nullptr, nullptr};
     }
 
@@ -139,19 +150,32 @@ std::pair<void*, void*> wf::get_new_instance_handle(const std::string& path, boo
     auto new_instance_func_ptr = dlsym(handle, "newInstance");
     if (new_instance_func_ptr == NULL)
     {
-        LOGE(path, ": missing newInstance(). ", dlerror());
+        error = path + ": missing newInstance(). " + nonull(dlerror());
         dlclose(handle);
         return {nullptr, nullptr};
     }
 
-    LOGD("Loaded plugin ", path.c_str());
-
     return {handle, new_instance_func_ptr};
 }
 
-std::optional<wf::loaded_plugin_t> wf::plugin_manager_t::load_plugin_from_file(std::string path)
+std::pair<void*, void*> wf::get_new_instance_handle(const std::string& path, bool can_unload_so)
+{
+    std::string error;
+    auto result = open_plugin(path, can_unload_so, error);
+    if (!result.second)
+    {
+        LOGE(error);
+        return result;
+    }
+
+    LOGD("Loaded plugin ", path.c_str());
+    return result;
+}
+
+std::optional<wf::loaded_plugin_t> wf::plugin_manager_t::create_instance(const std::string& path,
+    std::pair<void*, void*> handles)
 {
-    auto [handle, new_instance_func_ptr] = wf::get_new_instance_handle(path, enable_so_unloading);
+    auto [handle, new_instance_func_ptr] = handles;
     if (new_instance_func_ptr)
     {
         auto new_instance_func = union_cast<void*, wayfire_plugin_load_func>(new_instance_func_ptr);
@@ -175,6 +199,135 @@ std::optional<wf::loaded_plugin_t> wf::plugin_manager_t::load_plugin_from_file(s
     return {};
 }
 
+std::optional<wf::loaded_plugin_t> wf::plugin_manager_t::load_plugin_from_file(std::string path)
+{
+    auto start   = std::chrono::steady_clock::now();
+    auto handles = wf::get_new_instance_handle(path, enable_so_unloading);
+    LOGD("Opened ", path, " in ", std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count() / 1000.0, "ms");
+    return create_instance(path, handles);
+}
+
+std::vector<std::pair<void*, void*>> wf::plugin_manager_t::open_plugins_parallel(
+    const std::vector<std::string>& paths)
+{
+    struct open_result_t
+    {
+        std::pair<void*, void*> handles = {nullptr, nullptr};
+        std::string error;
+        int64_t duration_us = 0;
+    };
+
+    std::vector<open_result_t> results(paths.size());
+    std::atomic<size_t> next_path{0};
+    const bool can_unload_so = enable_so_unloading;
+
+    auto worker = [&] ()
+    {
+        for (size_t i = next_path++; i < paths.size(); i = next_path++)
+        {
+            auto start = std::chrono::steady_clock::now();
+            results[i].handles     = open_plugin(paths[i], can_unload_so, results[i].error);
+            results[i].duration_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start).count();
+        }
+    };
+
+    const size_t nr_threads =
+        std::min<size_t>(paths.size(), std::max(1u, std::thread::hardware_concurrency()));
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < nr_threads; i++)
+    {
+        workers.emplace_back(worker);
+    }
+
+    // The main thread helps as well instead of waiting idly.
+    worker();
+    for (auto& thread : workers)
+    {
+        thread.join();
+    }
+
+    std::vector<std::pair<void*, void*>> handles;
+    for (size_t i = 0; i < paths.size(); i++)
+    {
+        if (!results[i].handles.second)
+        {
+            LOGE(results[i].error);
+        } else
+        {
+            LOGD("Loaded plugin ", paths[i], " in ", results[i].duration_us / 1000.0, "ms");
+        }
+
+        handles.push_back(results[i].handles);
+    }
+
+    return handles;
+}
+
+void wf::sort_by_dependencies(
+    std::vector<std::pair<std::string, wf::loaded_plugin_t>>& plugins)
+{
+    std::stable_sort(plugins.begin(), plugins.end(), [] (const auto& a, const auto& b)
+    {
+        return a.second.instance->get_order_hint() < b.second.instance->get_order_hint();
+    });
+
+    // Dependencies are given by plugin name, e.g. "ipc" for libipc.so.
+    auto plugin_name = [] (const std::string& path)
+    {
+        auto name = std::filesystem::path(path).stem().string();
+        return name.rfind("lib", 0) == 0 ? name.substr(3) : name;
+    };
+
+    std::map<std::string, size_t> index_by_name;
+    for (size_t i = 0; i < plugins.size(); i++)
+    {
+        index_by_name[plugin_name(plugins[i].first)] = i;
+    }
+
+    // Repeatedly take the first plugin (in order hint order) whose dependencies have all been initialized.
+    // Dependencies which are not being loaded right now are either already initialized or missing, and
+    // are ignored.
+    std::vector<bool> taken(plugins.size(), false);
+    std::vector<std::pair<std::string, wf::loaded_plugin_t>> sorted;
+    while (sorted.size() < plugins.size())
+    {
+        size_t next = plugins.size();
+        for (size_t i = 0; (i < plugins.size()) && (next == plugins.size()); i++)
+        {
+            if (taken[i])
+            {
+                continue;
+            }
+
+            bool ready = true;
+            for (auto& dependency : plugins[i].second.instance->get_dependencies())
+            {
+                auto it = index_by_name.find(dependency);
+                ready &= (it == index_by_name.end()) || taken[it->second];
+            }
+
+            if (ready)
+            {
+                next = i;
+            }
+        }
+
+        if (next == plugins.size())
+        {
+            // A dependency cycle, initialize the rest in the order hint order.
+            LOGE("Cyclic plugin dependencies detected, initialization order may be wrong.");
+            next = std::find(taken.begin(), taken.end(), false) - taken.begin();
+        }
+
+        taken[next] = true;
+        sorted.push_back(std::move(plugins[next]));
+    }
+
+    plugins = std::move(sorted);
+}
+
 void wf::plugin_manager_t::reload_dynamic_plugins()
 {
     is_loading = true;
@@ -240,37 +393,52 @@ void wf::plugin_manager_t::reload_dynamic_plugins()
     }
 
     /* load new plugins */
-    std::vector<std::pair<std::string, wf::loaded_plugin_t>> pending_initialize;
-
+    std::vector<std::string> new_plugins;
     for (auto plugin : next_plugins)
     {
-        if (loaded_plugins.count(plugin))
+        if (!loaded_plugins.count(plugin))
         {
-            continue;
+            new_plugins.push_back(plugin);
         }
+    }
 
-        std::optional<wf::loaded_plugin_t> ptr = load_plugin_from_file(plugin);
-        if (ptr)
+    std::vector<std::pair<std::string, wf::loaded_plugin_t>> pending_initialize;
+    if (parallel_loading)
+    {
+        auto handles = open_plugins_parallel(new_plugins);
+        for (size_t i = 0; i < new_plugins.size(); i++)
         {
-            pending_initialize.emplace_back(plugin, std::move(*ptr));
+            if (auto ptr = create_instance(new_plugins[i], handles[i]))
+            {
+                pending_initialize.emplace_back(new_plugins[i], std::move(*ptr));
+            }
+        }
+    } else
+    {
+        for (auto& plugin : new_plugins)
+        {
+            if (auto ptr = load_plugin_from_file(plugin))
+            {
+                pending_initialize.emplace_back(plugin, std::move(*ptr));
+            }
         }
     }
 
-    std::stable_sort(pending_initialize.begin(), pending_initialize.end(), [] (const auto& a, const auto& b)
-    {
-        return a.second.instance->get_order_hint() < b.second.instance->get_order_hint();
-    });
+    sort_by_dependencies(pending_initialize);
 
     for (auto& [plugin, ptr] : pending_initialize)
     {
+        auto start = std::chrono::steady_clock::now();
         try {
             ptr.instance->init();
+            LOGD("Initialized plugin ", plugin, " in ", std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start).count() / 1000.0, "ms");
             loaded_plugins[plugin] = std::move(ptr);
         } catch (...)
         {
             // this will call fini(), the destructor and optionally unload the .so
             destroy_plugin(ptr);
-            LOGE("Failed to init plugin \"", plugin_name, "\". ");
+            LOGE("Failed to init plugin \"", plugin, "\". ");
         }
     }
 
@@ -35,11 +35,20 @@ struct plugin_manager_t
   private:
     wf::option_wrapper_t<std::string> plugins_opt;
     wf::option_wrapper_t<bool> enable_so_unloading;
+    wf::option_wrapper_t<bool> parallel_loading;
     std::unordered_map<std::string, loaded_plugin_t> loaded_plugins;
 
     void deinit_plugins(bool unloadable);
 
     std::optional<loaded_plugin_t> load_plugin_from_file(std::string path);
+    std::optional<loaded_plugin_t> create_instance(const std::string& path, std::pair<void*, void*> handles);
+
+    /**
+     * Open the given plugin files on a pool of worker threads.
+     *
+     * @return The (dlopen() handle, newInstance pointer) for each path, or nullptrs on failure.
+     */
+    std::vector<std::pair<void*, void*>> open_plugins_parallel(const std::vector<std::string>& paths);
     void load_static_plugins();
     void destroy_plugin(loaded_plugin_t& plugin);
 
@@ -69,6 +78,13 @@ B union_cast(A object)
  */
 std::pair<void*, void*> get_new_instance_handle(const std::string& path, bool can_unload_so);
 
+/**
+ * Sort the plugins (given as pairs of .so path and loaded plugin) by their order hint, making sure that each
+ * plugin comes after the plugins it depends on, see plugin_interface_t::get_dependencies(). Plugins in a
+ * dependency cycle keep their order hint order.
+ */
+void sort_by_dependencies(std::vector<std::pair<std::string, loaded_plugin_t>>& plugins);
+
 /**
  * List the locations where wayfire's plugins are installed.
  * This function takes care of env variable WAYFIRE_PLUGIN_PATH,
@@ -0,0 +1,77 @@
+#include "wayfire/startup-timing.hpp"
+#include "wayfire/core.hpp"
+#include "wayfire/option-wrapper.hpp"
+#include "../view/view-impl.hpp"
+#include <wayfire/util/log.hpp>
+#include <algorithm>
+
+wf::startup_timing_t::startup_timing_t()
+{
+    origin = std::chrono::steady_clock::now();
+}
+
+int64_t wf::startup_timing_t::now_us() const
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - origin).count();
+}
+
+void wf::startup_timing_t::begin_phase(const std::string& name)
+{
+    phases.push_back({
+        .name     = name,
+        .start_us = now_us(),
+    });
+}
+
+void wf::startup_timing_t::end_phase(const std::string& name)
+{
+    auto it = std::find_if(phases.rbegin(), phases.rend(), [&] (const startup_phase_t& phase)
+    {
+        return (phase.name == name) && (phase.duration_us < 0);
+    });
+
+    if (it != phases.rend())
+    {
+        it->duration_us = now_us() - it->start_us;
+    }
+}
+
+void wf::startup_timing_t::frame_submitted()
+{
+    if ((first_frame_us >= 0) || (wf::get_core().get_current_state() != compositor_state_t::RUNNING))
+    {
+        return;
+    }
+
+    first_frame_us = now_us();
+    handle_first_frame();
+}
+
+const std::vector<wf::startup_phase_t>& wf::startup_timing_t::get_phases() const
+{
+    return phases;
+}
+
+int64_t wf::startup_timing_t::get_time_to_first_frame_us() const
+{
+    return first_frame_us;
+}
+
+void wf::startup_timing_t::handle_first_frame()
+{
+    for (auto& phase : phases)
+    {
+        LOGI("Startup phase ", phase.name, ": ", phase.duration_us / 1000.0, "ms");
+    }
+
+    LOGI("Time to first frame: ", first_frame_us / 1000.0, "ms");
+
+    wf::option_wrapper_t<std::string> xwayland_mode{"core/xwayland"};
+    wf::option_wrapper_t<bool> xwayland_prewarm{"core/xwayland_prewarm"};
+    if ((xwayland_mode.value() == "lazy") && xwayland_prewarm)
+    {
+        // Do not delay the frame itself, start Xwayland once the compositor is idle again.
+        idle_prewarm_xwayland.run_once([] () { wf::xwayland_prewarm(); });
+    }
+}
@@ -6,12 +6,14 @@
 
 static bool transactions_intersect(const wf::txn::transaction_uptr& a, const wf::txn::transaction_uptr& b)
 {
-    const auto& obj_a = a->get_objects();
-    const auto& obj_b = b->get_objects();
+    // Iterate over the smaller transaction and look up its objects in the larger one.
+    const auto& [smaller, larger] = (a->get_objects().size() <= b->get_objects().size()) ?
+        std::pair{a.get(), b.get()} : std::pair{b.get(), a.get()};
+    const auto& objects = smaller->get_objects();
 
-    return std::any_of(obj_a.begin(), obj_a.end(), [&] (const wf::txn::transaction_object_sptr& x)
+    return std::any_of(objects.begin(), objects.end(), [&] (const wf::txn::transaction_object_sptr& x)
     {
-        return std::find(obj_b.begin(), obj_b.end(), x) != obj_b.end();
+        return larger->has_object(x);
     });
 }
 
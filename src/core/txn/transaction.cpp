@@ -35,13 +35,17 @@ const std::vector<wf::txn::transaction_object_sptr>& wf::txn::transaction_t::get
     return this->objects;
 }
 
+bool wf::txn::transaction_t::has_object(const transaction_object_sptr& object) const
+{
+    return object_set.count(object.get());
+}
+
 void wf::txn::transaction_t::add_object(transaction_object_sptr object)
 {
-    auto it = std::find(objects.begin(), objects.end(), object);
-    if (it == objects.end())
+    if (object_set.insert(object.get()).second)
     {
         LOGC(TXNI, "Transaction ", this, " add object ", object->stringify());
-        objects.push_back(object);
+        objects.push_back(std::move(object));
     }
 }
 
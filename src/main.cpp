@@ -15,6 +15,7 @@
 #include "wayfire/config-backend.hpp"
 #include "core/plugin-loader.hpp"
 #include "core/core-impl.hpp"
+#include "wayfire/startup-timing.hpp"
 #include <wayfire/nonstd/wlroots.hpp>
 
 static std::string get_version_string()
@@ -419,7 +420,9 @@ int main(int argc, char *argv[])
     /** TODO: move this to core_impl constructor */
     core.display = display;
     core.ev_loop = wl_display_get_event_loop(core.display);
+    core.startup_timing->begin_phase("backend");
     core.backend = wlr_backend_autocreate(core.ev_loop, &core.session);
+    core.startup_timing->end_phase("backend");
 
     int drm_fd = -1;
     char *drm_device = getenv("WLR_RENDER_DRM_DEVICE");
@@ -446,6 +449,7 @@ int main(int argc, char *argv[])
 #endif
     }
 
+    core.startup_timing->begin_phase("renderer");
     // core.renderer = wlr_vk_renderer_create_with_drm_fd(drm_fd);
     core.renderer = wlr_renderer_autocreate(core.backend);
     // core.renderer = wlr_pixman_renderer_create();
@@ -460,6 +464,7 @@ int main(int argc, char *argv[])
 
     core.allocator = wlr_allocator_autocreate(core.backend, core.renderer);
     assert(core.allocator);
+    core.startup_timing->end_phase("renderer");
 
     if (core.is_gles2())
     {
@@ -486,8 +491,12 @@ int main(int argc, char *argv[])
 
     LOGD("Using configuration backend: ", config_backend);
     core.config_backend = std::unique_ptr<wf::config_backend_t>(backend);
+    core.startup_timing->begin_phase("config");
     core.config_backend->init(display, *core.config, config_file);
+    core.startup_timing->end_phase("config");
+    core.startup_timing->begin_phase("core");
     core.init();
+    core.startup_timing->end_phase("core");
 
     auto socket = choose_socket(core.display);
     if (!socket)
@@ -499,6 +508,7 @@ int main(int argc, char *argv[])
 
     core.wayland_display = socket.value();
     LOGI("Using socket name ", core.wayland_display);
+    core.startup_timing->begin_phase("backend-start");
     if (!wlr_backend_start(core.backend))
     {
         LOGE("Failed to initialize backend, exiting");
@@ -508,6 +518,7 @@ int main(int argc, char *argv[])
         return -1;
     }
 
+    core.startup_timing->end_phase("backend-start");
     setenv("WAYLAND_DISPLAY", core.wayland_display.c_str(), 1);
     core.post_init();
 
@@ -58,6 +58,12 @@ class output_impl_t : public output_t
     void add_activator(option_sptr_t<activatorbinding_t> activator, wf::activator_callback*) override;
     void rem_binding(void *callback) override;
 
+    /**
+     * Get the names of the currently active plugins, sorted and separated by commas, or an empty string if
+     * no plugin is active.
+     */
+    std::string get_active_plugin_set() const;
+
     /** Set the effective resolution of the output */
     void set_effective_size(const wf::dimensions_t& size);
 };
@@ -14,6 +14,7 @@
 #include "wayfire/output-layout.hpp"
 #include "wayfire/workspace-set.hpp"
 #include <memory>
+#include <set>
 #include <wayfire/config/types.hpp>
 #include <wayfire/util/log.hpp>
 #include <wayfire/nonstd/wlroots-full.hpp>
@@ -336,6 +337,26 @@ bool wf::output_impl_t::is_plugin_active(std::string name) const
     return false;
 }
 
+std::string wf::output_impl_t::get_active_plugin_set() const
+{
+    std::set<std::string> names;
+    for (auto act : active_plugins)
+    {
+        if (act)
+        {
+            names.insert(act->name);
+        }
+    }
+
+    std::string result;
+    for (auto& name : names)
+    {
+        result += (result.empty() ? "" : ",") + name;
+    }
+
+    return result;
+}
+
 void wf::output_t::set_inhibited(bool inhibited)
 {
     this->inhibited = inhibited;
@@ -13,12 +13,17 @@
 #include "wayfire/view.hpp"
 #include "wayfire/output.hpp"
 #include "wayfire/util.hpp"
+#include "wayfire/startup-timing.hpp"
 #include "../main.hpp"
+#include "output-impl.hpp"
+#include "repaint-delay.hpp"
 #include "wayfire/workspace-set.hpp" // IWYU pragma: keep
 #include <algorithm>
+#include <chrono>
 #include <filesystem>
 #include <fstream>
 #include <optional>
+#include <map>
 #include <wayfire/nonstd/reverse.hpp>
 #include <wayfire/nonstd/safe-list.hpp>
 #include <wayfire/util/log.hpp>
@@ -308,6 +313,8 @@ struct swapchain_damage_manager_t
             LOGE("Output commit failed!");
             return;
         }
+
+        wf::get_core().startup_timing->frame_submitted();
     }
 
     /**
@@ -408,6 +415,169 @@ struct effect_hook_manager_t
     }
 };
 
+/**
+ * Ticks all animations on the output once per frame, see render_manager::add_animation().
+ */
+struct animation_timeline_t
+{
+    animation_timeline_t(wf::output_t *output)
+    {
+        this->output = output;
+        on_present.set_callback([&] (void *data)
+        {
+            auto ev = static_cast<wlr_output_event_present*>(data);
+            if (ev->presented)
+            {
+                last_presentation_nsec = timespec_to_nsec(ev->when);
+                refresh_nsec = ev->refresh;
+            }
+        });
+        on_present.connect(&output->handle->events.present);
+    }
+
+    void add_animation(animation_tick_t *tick)
+    {
+        animations.push_back(tick);
+        output->render->schedule_redraw();
+    }
+
+    void rem_animation(animation_tick_t *tick)
+    {
+        animations.remove_all(tick);
+    }
+
+    /**
+     * Predict when a frame started now will be presented: at the first vblank after the current time.
+     */
+    animation_frame_t predict_frame()
+    {
+        animation_frame_t frame;
+        frame.refresh_nsec = refresh_nsec > 0 ? refresh_nsec :
+            (output->handle->refresh > 0 ? 1'000'000'000'000ll / output->handle->refresh : 0);
+
+        timespec now_ts;
+        clock_gettime(CLOCK_MONOTONIC, &now_ts);
+        const int64_t now = timespec_to_nsec(now_ts);
+        if ((last_presentation_nsec < 0) || (frame.refresh_nsec <= 0))
+        {
+            frame.presentation_time_nsec = now;
+            return frame;
+        }
+
+        // Computed in nanoseconds, as whole milliseconds would drift by a frame every few dozen frames.
+        const int64_t elapsed_frames =
+            std::max<int64_t>(0, now - last_presentation_nsec) / frame.refresh_nsec + 1;
+        frame.presentation_time_nsec = last_presentation_nsec + elapsed_frames * frame.refresh_nsec;
+        return frame;
+    }
+
+    void tick()
+    {
+        if (animations.size() == 0)
+        {
+            stats.last_frame_cost_us = 0;
+            return;
+        }
+
+        current_frame = predict_frame();
+        bool running  = false;
+        wf::regionf_t damage;
+        current_frame.damage = &damage;
+
+        auto start = std::chrono::steady_clock::now();
+        animations.for_each([&] (auto tick)
+        {
+            if ((*tick)(current_frame))
+            {
+                running = true;
+            }
+        });
+        auto cost = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count();
+
+        current_frame.damage = nullptr;
+        apply_damage(damage);
+
+        stats.last_frame_cost_us    = cost;
+        stats.max_frame_cost_us     = std::max(stats.max_frame_cost_us, (int64_t)cost);
+        stats.average_frame_cost_us = stats.average_frame_cost_us * 0.9 + cost * 0.1;
+
+        if (running)
+        {
+            output->render->schedule_redraw();
+        }
+    }
+
+    /**
+     * Damage the region collected during the tick, given in coordinates of this output. Animated views may
+     * overlap other outputs too (like wf::scene::damage_node() would damage them), so the parts of the
+     * region which lie on other outputs are damaged there as well.
+     */
+    void apply_damage(const wf::regionf_t& damage)
+    {
+        if (damage.empty())
+        {
+            return;
+        }
+
+        output->render->damage(damage);
+        const auto origin = output->get_layout_geometry();
+        for (auto wo : wf::get_core().output_layout->get_outputs())
+        {
+            if (wo == output)
+            {
+                continue;
+            }
+
+            const auto other = wo->get_layout_geometry();
+            const wf::pointf_t offset{(double)origin.x - other.x, (double)origin.y - other.y};
+            auto on_other = (damage + offset) & wo->get_relative_geometry();
+            if (!on_other.empty())
+            {
+                wo->render->damage(on_other);
+            }
+        }
+    }
+
+    animation_stats_t get_stats() const
+    {
+        auto result = stats;
+        result.animations = animations.size();
+        return result;
+    }
+
+    animation_frame_t current_frame;
+
+  private:
+    wf::output_t *output;
+    wf::safe_list_t<animation_tick_t*> animations;
+    animation_stats_t stats;
+
+    int64_t last_presentation_nsec = -1;
+    int64_t refresh_nsec = 0;
+    wf::wl_listener_wrapper on_present;
+
+    static int64_t timespec_to_nsec(const timespec& ts)
+    {
+        return ts.tv_sec * 1'000'000'000ll + ts.tv_nsec;
+    }
+};
+
+static const char *fused_post_vertex_shader =
+    R"(
+#version 100
+
+attribute highp vec2 position;
+attribute highp vec2 uvPosition;
+
+varying highp vec2 uvpos;
+
+void main() {
+    gl_Position = vec4(position.xy, 0.0, 1.0);
+    uvpos = uvPosition;
+}
+)";
+
 /**
  * A class to manage and run postprocessing effects
  */
@@ -415,10 +585,16 @@ struct postprocessing_manager_t
 {
     using post_container_t = wf::safe_list_t<post_hook_t*>;
     post_container_t post_effects;
+    std::map<post_hook_t*, post_hook_options_t> post_options;
     wf::auxilliary_buffer_t post_buffers[2];
     /* Buffer to which other operations render to */
     static constexpr uint32_t default_out_buffer = 0;
 
+    /* Programs for chains of post hooks which were fused together */
+    std::map<std::vector<post_hook_t*>, OpenGL::program_t> fused_programs;
+    /* Set when the contents of the buffers are not valid, so that all of them have to be processed */
+    bool needs_full_repaint = true;
+
     output_t *output;
     uint32_t output_width, output_height;
     postprocessing_manager_t(output_t *output)
@@ -426,6 +602,11 @@ struct postprocessing_manager_t
         this->output = output;
     }
 
+    ~postprocessing_manager_t()
+    {
+        free_fused_programs();
+    }
+
     wf::render_buffer_t final_target;
     void set_current_buffer(wlr_buffer *buffer)
     {
@@ -446,38 +627,255 @@ struct postprocessing_manager_t
         output_height = height;
         for (auto& buffer : post_buffers)
         {
-            buffer.allocate({width, height});
+            if (buffer.allocate({width, height}) != buffer_reallocation_result_t::SAME)
+            {
+                needs_full_repaint = true;
+            }
         }
     }
 
-    void add_post(post_hook_t *hook)
+    void add_post(post_hook_t *hook, post_hook_options_t options)
     {
         post_effects.push_back(hook);
-        output->render->damage_whole_idle();
+        post_options[hook] = std::move(options);
+        chain_changed();
     }
 
     void rem_post(post_hook_t *hook)
     {
         post_effects.remove_all(hook);
+        post_options.erase(hook);
+        chain_changed();
+    }
+
+    void chain_changed()
+    {
+        free_fused_programs();
+        needs_full_repaint = true;
         output->render->damage_whole_idle();
     }
 
+    void free_fused_programs()
+    {
+        if (fused_programs.empty())
+        {
+            return;
+        }
+
+        wf::gles::run_in_context_if_gles([&]
+        {
+            for (auto& [_, program] : fused_programs)
+            {
+                program.free_resources();
+            }
+        });
+        fused_programs.clear();
+    }
+
+    /**
+     * Check whether only the damaged region of the output needs to be processed by the post effects this
+     * frame. If not, the whole output has to be repainted.
+     */
+    bool can_run_partially()
+    {
+        if (needs_full_repaint)
+        {
+            return false;
+        }
+
+        bool all_partial = true;
+        post_effects.for_each([&] (auto post)
+        {
+            const auto& options = post_options[post];
+            all_partial &= (bool)options.transform_damage || (options.per_pixel && wf::get_core().is_gles2());
+        });
+
+        return all_partial;
+    }
+
+    bool is_fusable(post_hook_t *post)
+    {
+        const auto& options = post_options[post];
+        return wf::get_core().is_gles2() && options.per_pixel && !options.shader_source.empty() &&
+               !options.shader_function.empty();
+    }
+
+    /* The region of the destination buffer which the currently running hook has to update. */
+    wf::region_t current_damage;
+
     /* Run all postprocessing effects, rendering to alternating buffers and
      * finally to the screen.
      *
      * NB: 2 buffers just aren't enough. We render to the zero buffer, and then
      * we alternately render to the second and the third. The reason: We track
-     * damage. So, we need to keep the whole buffer each frame. */
-    void run_post_effects()
+     * damage. So, we need to keep the whole buffer each frame.
+     *
+     * @param damage The damaged region of the output buffer.
+     * @param partial Whether to process only the damaged region, see can_run_partially().
+     * @return The damaged region of the final buffer. */
+    wf::region_t run_post_effects(const wf::region_t& damage, bool partial)
     {
-        int cur_idx = 0;
+        // Split the chain into stages, where each stage is either a single hook or a sequence of fusable hooks
+        std::vector<std::vector<post_hook_t*>> stages;
         post_effects.for_each([&] (auto post) -> void
+        {
+            if (is_fusable(post) && !stages.empty() && is_fusable(stages.back().back()))
+            {
+                stages.back().push_back(post);
+            } else
+            {
+                stages.push_back({post});
+            }
+        });
+
+        const wf::region_t full_buffer = wlr_box{0, 0, (int)output_width, (int)output_height};
+        wf::region_t stage_damage = partial ? damage : full_buffer;
+
+        int cur_idx = 0;
+        for (size_t i = 0; i < stages.size(); i++)
         {
             int next_idx = 1 - cur_idx;
-            wf::render_buffer_t dst_buffer = (post == post_effects.back() ?
+            wf::render_buffer_t dst_buffer = (i == stages.size() - 1 ?
                 final_target : post_buffers[next_idx].get_renderbuffer());
-            (*post)(post_buffers[cur_idx], dst_buffer);
+
+            auto& transform = post_options[stages[i].front()].transform_damage;
+            if (partial && transform)
+            {
+                // The hook moves pixels around, it clips its output to the transformed damage itself.
+                stage_damage   = transform(stage_damage) & full_buffer;
+                current_damage = stage_damage;
+                (*stages[i].front())(post_buffers[cur_idx], dst_buffer);
+            } else
+            {
+                current_damage = stage_damage;
+                for_each_damage_box(dst_buffer, stage_damage, partial, [&] ()
+                {
+                    if (stages[i].size() == 1)
+                    {
+                        (*stages[i].front())(post_buffers[cur_idx], dst_buffer);
+                    } else
+                    {
+                        run_fused(stages[i], post_buffers[cur_idx], dst_buffer);
+                    }
+                });
+            }
+
             cur_idx = next_idx;
+        }
+
+        current_damage.clear();
+        needs_full_repaint = false;
+        return stages.empty() ? damage : stage_damage;
+    }
+
+    /**
+     * Call @draw once for each damaged rectangle, with the scissor box set accordingly, or once without
+     * scissoring if @partial is false.
+     */
+    template<class F>
+    void for_each_damage_box(const wf::render_buffer_t& buffer, const wf::region_t& damage, bool partial,
+        F&& draw)
+    {
+        if (!partial)
+        {
+            draw();
+            return;
+        }
+
+        // With too many rectangles, a single scissor box around them is cheaper than many draw calls.
+        static constexpr int max_boxes = 16;
+        std::vector<pixman_box32_t> boxes;
+        if (std::distance(damage.begin(), damage.end()) > max_boxes)
+        {
+            boxes.push_back(damage.get_extents());
+        } else
+        {
+            boxes.assign(damage.begin(), damage.end());
+        }
+
+        for (const auto& box : boxes)
+        {
+            wf::gles::run_in_context([&]
+            {
+                wf::gles::scissor_render_buffer(buffer,
+                    wlr_box{box.x1, box.y1, box.x2 - box.x1, box.y2 - box.y1});
+            });
+            draw();
+        }
+
+        wf::gles::run_in_context([&]
+        {
+            GL_CALL(glDisable(GL_SCISSOR_TEST));
+        });
+    }
+
+    OpenGL::program_t& get_fused_program(const std::vector<post_hook_t*>& stage)
+    {
+        auto it = fused_programs.find(stage);
+        if (it != fused_programs.end())
+        {
+            return it->second;
+        }
+
+        std::string fragment = "#version 100\n@builtin_ext@\n@builtin@\n\nvarying highp vec2 uvpos;\n\n";
+        std::string apply;
+        for (auto post : stage)
+        {
+            const auto& options = post_options[post];
+            fragment += options.shader_source + "\n";
+            apply    += "    color = " + options.shader_function + "(color);\n";
+        }
+
+        fragment += "void main()\n{\n    highp vec4 color = get_pixel(uvpos);\n" + apply +
+            "    gl_FragColor = color;\n}\n";
+
+        auto& program = fused_programs[stage];
+        program.compile(fused_post_vertex_shader, fragment);
+        return program;
+    }
+
+    void run_fused(const std::vector<post_hook_t*>& stage, wf::auxilliary_buffer_t& source,
+        const wf::render_buffer_t& destination)
+    {
+        static const float vertex_data[] = {
+            -1.0f, -1.0f,
+            1.0f, -1.0f,
+            1.0f, 1.0f,
+            -1.0f, 1.0f
+        };
+
+        static const float coord_data[] = {
+            0.0f, 0.0f,
+            1.0f, 0.0f,
+            1.0f, 1.0f,
+            0.0f, 1.0f
+        };
+
+        wf::gles::run_in_context([&]
+        {
+            auto& program = get_fused_program(stage);
+            auto texture  = wf::gles_texture_t::from_aux(source);
+            // The buffers are copied 1:1, there is no need to switch between wlroots' and our coordinates.
+            texture.invert_y = false;
+
+            wf::gles::bind_render_buffer(destination);
+            program.use(wf::TEXTURE_TYPE_RGBA);
+            program.set_active_texture(texture);
+            program.attrib_pointer("position", 2, 0, vertex_data);
+            program.attrib_pointer("uvPosition", 2, 0, coord_data);
+            for (auto post : stage)
+            {
+                if (post_options[post].set_uniforms)
+                {
+                    post_options[post].set_uniforms(program);
+                }
+            }
+
+            GL_CALL(glDisable(GL_BLEND));
+            GL_CALL(glDrawArrays(GL_TRIANGLE_FAN, 0, 4));
+            GL_CALL(glEnable(GL_BLEND));
+            GL_CALL(glBindTexture(GL_TEXTURE_2D, 0));
+            program.deactivate();
         });
     }
 
@@ -635,30 +1033,51 @@ class depth_buffer_manager_t
  * and can change depending on active plugins, number of opened windows, etc.
  *
  * Thus, we need to dynamically guess this time based on the previous frames.
- * Currently, the following algorithm is implemented:
- *
- * Initially, the repaint delay is zero.
+ * The render time of each frame is measured and recorded together with the set
+ * of plugins which were active at the time (see repaint_delay_model_t), and the
+ * delay leaves room for a high percentile of the recent render times of the
+ * currently active plugins, plus a safety margin.
  *
- * If at some point Wayfire skips a frame, the delay is assumed too big and
- * reduced by `2^i`, where `i` is the amount of consecutive skipped frames.
- *
- * If Wayfire renders in time for `increase_window` milliseconds, then the
- * delay is increased by one. If the next frame is delayed, then
- * `increase_window` is doubled, otherwise, it is halved
- * (but it must stay between `MIN_INCREASE_WINDOW` and `MAX_INCREASE_WINDOW`).
+ * Until enough frames have been measured for a set of plugins, the delay is
+ * zero. Missed frames increase the margin of the plugin set they happened with.
  */
 struct repaint_delay_manager_t
 {
-    repaint_delay_manager_t(wf::output_t *output)
+    repaint_delay_manager_t(wf::output_t *output) : output(output)
     {
         on_present.set_callback([&] (void *data)
         {
             auto ev = static_cast<wlr_output_event_present*>(data);
             this->refresh_nsec = ev->refresh;
+            // The frame is on screen, so the GPU has finished with it and the timer query is ready.
+            record_render_time();
         });
         on_present.connect(&output->handle->events.present);
     }
 
+    ~repaint_delay_manager_t()
+    {
+        if (render_timer)
+        {
+            wlr_render_timer_destroy(render_timer);
+        }
+    }
+
+    /**
+     * Get the timer which measures the GPU time of the output's main render pass, or NULL if the renderer
+     * does not support timer queries.
+     */
+    wlr_render_timer *get_render_timer()
+    {
+        if (!render_timer && !render_timer_unsupported)
+        {
+            render_timer = wlr_render_timer_create(output->handle->renderer);
+            render_timer_unsupported = !render_timer;
+        }
+
+        return render_timer;
+    }
+
     /**
      * The next frame will be skipped.
      */
@@ -674,53 +1093,42 @@ struct repaint_delay_manager_t
      */
     void start_frame()
     {
-        if (last_pageflip == -1)
-        {
-            last_pageflip = get_current_time();
-            return;
-        }
+        // Normally done when the previous frame is presented, but the timer is about to be reused.
+        record_render_time();
 
         const int64_t refresh = this->refresh_nsec / 1e6;
-        const int64_t on_time_thresh = refresh * 1.5;
-        const int64_t last_frame_len = get_current_time() - last_pageflip;
-        if (last_frame_len <= on_time_thresh)
+        if ((last_pageflip != -1) && (refresh > 0))
         {
-            // We rendered last frame on time
-            if (get_current_time() - last_increase >= increase_window)
-            {
-                increase_window = clamp(int64_t(increase_window * 0.75),
-                    MIN_INCREASE_WINDOW, MAX_INCREASE_WINDOW);
-                update_delay(+1);
-                reset_increase_timer();
-
-                // If we manage the next few frames, then we have reached a new
-                // stable state
-                expand_inc_window_on_miss = 20;
-            } else
-            {
-                --expand_inc_window_on_miss;
-            }
+            const int64_t last_frame_len = get_current_time() - last_pageflip;
+            model.frame_presented(last_frame_len <= refresh * 1.5, refresh_nsec / 1000);
+        }
+
+        last_pageflip = get_current_time();
 
-            // Stop exponential decrease
-            consecutive_decrease = 1;
+        auto active_plugins = get_active_plugins();
+        const int config_delay = std::max(0, (int)refresh - max_render_time);
+        if (max_render_time == -1)
+        {
+            model.start_fixed_frame(active_plugins, repaint_delay_mode_t::DISABLED, 0);
+            delay = 0;
+        } else if (!dynamic_delay)
+        {
+            model.start_fixed_frame(active_plugins, repaint_delay_mode_t::FIXED, config_delay);
+            delay = config_delay;
         } else
         {
-            // We missed last frame.
-            update_delay(-consecutive_decrease);
-            // Next decrease should be faster
-            consecutive_decrease = clamp(consecutive_decrease * 2, 1, 32);
-
-            // Next increase should be tried after a longer interval
-            if (expand_inc_window_on_miss >= 0)
-            {
-                increase_window = clamp(increase_window * 2,
-                    MIN_INCREASE_WINDOW, MAX_INCREASE_WINDOW);
-            }
-
-            reset_increase_timer();
+            delay = model.start_frame(active_plugins, refresh_nsec / 1000, config_delay,
+                percentile, (int64_t)margin * 1000);
         }
+    }
 
-        last_pageflip = get_current_time();
+    /**
+     * The current frame has been rendered and submitted, which took @cpu_render_us of CPU time.
+     * The render time is recorded once the GPU time is known, see record_render_time().
+     */
+    void frame_rendered(int64_t cpu_render_us)
+    {
+        pending_cpu_render_us = cpu_render_us;
     }
 
     /**
@@ -731,50 +1139,63 @@ struct repaint_delay_manager_t
         return delay;
     }
 
+    repaint_stats_t get_stats() const
+    {
+        auto stats = model.get_stats(percentile);
+        stats.refresh_nsec = refresh_nsec;
+        return stats;
+    }
+
   private:
+    wf::output_t *output;
     int delay = 0;
+    repaint_delay_model_t model;
 
-    void update_delay(int delta)
+    std::string get_active_plugins() const
     {
-        int config_delay = std::max(0,
-            (int)(this->refresh_nsec / 1e6) - max_render_time);
-
-        int min = 0;
-        int max = config_delay;
-        if (max_render_time == -1)
-        {
-            max = 0;
-        } else if (!dynamic_delay)
-        {
-            min = config_delay;
-            max = config_delay;
-        }
-
-        delay = clamp(delay + delta, min, max);
+        auto impl = dynamic_cast<wf::output_impl_t*>(output);
+        return impl ? impl->get_active_plugin_set() : "";
     }
 
-    void reset_increase_timer()
-    {
-        last_increase = get_current_time();
-    }
+    // Time of last frame
+    int64_t last_pageflip = -1; // -1 is invalid
 
-    static constexpr int64_t MIN_INCREASE_WINDOW = 200; // 200 ms
-    static constexpr int64_t MAX_INCREASE_WINDOW = 30'000; // 30s
-    int64_t increase_window = MIN_INCREASE_WINDOW;
-    int64_t last_increase   = 0;
+    int64_t refresh_nsec = 0;
 
-    // > 0 => Increase increase_window
-    int64_t expand_inc_window_on_miss = 0;
+    wlr_render_timer *render_timer = NULL;
+    bool render_timer_unsupported  = false;
+    // CPU time of the last submitted frame whose render time has not been recorded yet, or -1.
+    int64_t pending_cpu_render_us = -1;
+
+    /**
+     * Record the render time of the last submitted frame: the GPU time of its render pass if the renderer
+     * supports timer queries, and the CPU time it took to submit otherwise.
+     */
+    void record_render_time()
+    {
+        if (pending_cpu_render_us < 0)
+        {
+            return;
+        }
 
-    // Expontential decrease in case of missed frames
-    int32_t consecutive_decrease = 1;
+        int64_t render_us = pending_cpu_render_us;
+        if (render_timer)
+        {
+            const int gpu_ns = wlr_render_timer_get_duration_ns(render_timer);
+            if (gpu_ns >= 0)
+            {
+                render_us = gpu_ns / 1000;
+            }
+        }
 
-    // Time of last frame
-    int64_t last_pageflip = -1; // -1 is invalid
+        model.frame_rendered(render_us);
+        pending_cpu_render_us = -1;
+    }
 
-    int64_t refresh_nsec;
     wf::option_wrapper_t<int> max_render_time{"core/max_render_time"};
     wf::option_wrapper_t<bool> dynamic_delay{"workarounds/dynamic_repaint_delay"};
+    wf::option_wrapper_t<int> percentile{"workarounds/repaint_delay_percentile"};
+    wf::option_wrapper_t<int> margin{"workarounds/repaint_delay_margin"};
 
     wf::wl_listener_wrapper on_present;
 };
@@ -813,9 +1234,11 @@ class wf::render_manager::impl
     std::unique_ptr<postprocessing_manager_t> postprocessing;
     std::unique_ptr<depth_buffer_manager_t> depth_buffer_manager;
     std::unique_ptr<repaint_delay_manager_t> delay_manager;
+    std::unique_ptr<animation_timeline_t> animation_timeline;
 
     wf::option_wrapper_t<wf::color_t> background_color_opt;
     std::unique_ptr<wf::render_pass_t> current_pass;
+    occlusion_stats_t occlusion_stats;
     wf::option_wrapper_t<std::string> icc_profile;
     wf::option_wrapper_t<bool> hdr;
 
@@ -932,6 +1355,7 @@ class wf::render_manager::impl
         postprocessing = std::make_unique<postprocessing_manager_t>(o);
         depth_buffer_manager = std::make_unique<depth_buffer_manager_t>();
         delay_manager = std::make_unique<repaint_delay_manager_t>(o);
+        animation_timeline = std::make_unique<animation_timeline_t>(o);
 
         on_frame.set_callback([&] (void*)
         {
@@ -1130,12 +1554,15 @@ class wf::render_manager::impl
         params.renderer = output->handle->renderer;
         params.flags    = RPASS_CLEAR_BACKGROUND | RPASS_EMIT_SIGNALS;
 
-        pass_opts.timer = NULL; // TODO: do we care about this? could be useful for dynamic frame
-                                // scheduling
+        // Measures the GPU time of the frame for the dynamic repaint delay.
+        pass_opts.timer = delay_manager->get_render_timer();
         params.pass_opts   = std::move(pass_opts);
         this->current_pass = std::make_unique<render_pass_t>(params);
 
         auto total_damage = current_pass->run_partial();
+        occlusion_stats.last_frame_culled = current_pass->get_culled_instructions();
+        occlusion_stats.total_culled += occlusion_stats.last_frame_culled;
+        occlusion_stats.frames++;
         if (runtime_config.damage_debug)
         {
             /* Clear the screen to yellow, so that the repainted parts are visible */
@@ -1178,8 +1605,11 @@ class wf::render_manager::impl
      */
     void paint()
     {
+        const auto paint_start = std::chrono::steady_clock::now();
+
         /* Part 1: frame setup: query damage, etc. */
         effects->run_effects(OUTPUT_EFFECT_PRE);
+        animation_timeline->tick();
         effects->run_effects(OUTPUT_EFFECT_DAMAGE);
 
         if (do_direct_scanout())
@@ -1222,12 +1652,13 @@ class wf::render_manager::impl
         effects->run_effects(OUTPUT_EFFECT_PASS_DONE);
 
         /* Part 5: finalize the scene: postprocessing effects */
-        if (postprocessing->post_effects.size())
+        const bool partial_post = postprocessing->can_run_partially();
+        if (postprocessing->post_effects.size() && !partial_post)
         {
             swap_damage |= damage_manager->get_buffer_extents();
         }
 
-        postprocessing->run_post_effects();
+        swap_damage = postprocessing->run_post_effects(swap_damage, partial_post);
 
         /* Part 6: render sw cursors We render software cursors after everything else
          * for consistency with hardware cursor planes */
@@ -1235,6 +1666,8 @@ class wf::render_manager::impl
 
         /* Part 7: finalize frame: swap buffers, send frame_done, etc */
         damage_manager->swap_buffers(std::move(next_frame), swap_damage);
+        delay_manager->frame_rendered(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - paint_start).count());
 
         unset_bound_output();
         swap_damage.clear();
@@ -1398,9 +1831,44 @@ void render_manager::rem_effect(effect_hook_t *hook)
     pimpl->effects->rem_effect(hook);
 }
 
-void render_manager::add_post(post_hook_t *hook)
+void render_manager::add_post(post_hook_t *hook, post_hook_options_t options)
+{
+    pimpl->postprocessing->add_post(hook, std::move(options));
+}
+
+void render_manager::add_animation(animation_tick_t *tick)
+{
+    pimpl->animation_timeline->add_animation(tick);
+}
+
+void render_manager::rem_animation(animation_tick_t *tick)
+{
+    pimpl->animation_timeline->rem_animation(tick);
+}
+
+animation_frame_t render_manager::get_animation_frame() const
+{
+    return pimpl->animation_timeline->current_frame;
+}
+
+animation_stats_t render_manager::get_animation_stats() const
+{
+    return pimpl->animation_timeline->get_stats();
+}
+
+repaint_stats_t render_manager::get_repaint_stats() const
+{
+    return pimpl->delay_manager->get_stats();
+}
+
+occlusion_stats_t render_manager::get_occlusion_stats() const
+{
+    return pimpl->occlusion_stats;
+}
+
+const wf::region_t& render_manager::get_post_damage() const
 {
-    pimpl->postprocessing->add_post(hook);
+    return pimpl->postprocessing->current_damage;
 }
 
 void render_manager::rem_post(post_hook_t *hook)
@@ -0,0 +1,217 @@
+#pragma once
+
+#include <wayfire/render-manager.hpp>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <map>
+#include <string>
+
+namespace wf
+{
+/**
+ * A ring buffer with the render times of the most recent frames.
+ */
+class render_time_history_t
+{
+  public:
+    static constexpr size_t MAX_SAMPLES = 120;
+
+    void add(int64_t render_us)
+    {
+        samples[next] = render_us;
+        next  = (next + 1) % MAX_SAMPLES;
+        count = std::min(count + 1, MAX_SAMPLES);
+        last  = render_us;
+    }
+
+    size_t size() const
+    {
+        return count;
+    }
+
+    int64_t get_last() const
+    {
+        return last;
+    }
+
+    int64_t get_max() const
+    {
+        return count ? *std::max_element(samples.begin(), samples.begin() + count) : 0;
+    }
+
+    /**
+     * @return The @p-th percentile (0..100) of the recorded render times, or 0 if there are none.
+     */
+    int64_t percentile(int p) const
+    {
+        if (count == 0)
+        {
+            return 0;
+        }
+
+        // Nearest-rank percentile.
+        auto sorted = samples;
+        const size_t rank = (count * std::clamp(p, 0, 100) + 99) / 100;
+        const size_t idx  = std::max<size_t>(rank, 1) - 1;
+        std::nth_element(sorted.begin(), sorted.begin() + idx, sorted.begin() + count);
+        return sorted[idx];
+    }
+
+  private:
+    std::array<int64_t, MAX_SAMPLES> samples{};
+    size_t count = 0;
+    size_t next  = 0;
+    int64_t last = 0;
+};
+
+/**
+ * Chooses the repaint delay of an output from the render times measured for the currently active plugins.
+ *
+ * Render times are kept separately for each set of active plugins, so that when e.g. expo is activated, the
+ * delay immediately follows what expo frames cost instead of having to miss frames first, and drops back
+ * once the desktop is idle again. The delay leaves room for a high percentile of the recent render times
+ * plus a safety margin. Each missed frame adds a penalty to the margin, which decays while frames are on
+ * time.
+ */
+class repaint_delay_model_t
+{
+  public:
+    /** Frames which must be measured for a set of plugins before the delay is based on them. */
+    static constexpr size_t MIN_SAMPLES = 10;
+    static constexpr int64_t MISS_PENALTY_STEP_US = 1000;
+    /** Profiles kept at most, the least recently used one is dropped when a new set of plugins appears. */
+    static constexpr size_t MAX_PROFILES = 32;
+
+    /**
+     * Start a new frame, rendered while the given plugins are active.
+     *
+     * @param refresh_us The refresh interval of the output.
+     * @param max_delay_ms The largest delay allowed by the configuration.
+     * @param percentile Which percentile of the render times to leave room for.
+     * @param margin_us Additional safety margin.
+     * @return The delay for the frame in milliseconds.
+     */
+    int start_frame(const std::string& active_plugins, int64_t refresh_us, int max_delay_ms,
+        int percentile, int64_t margin_us)
+    {
+        current = &get_profile(active_plugins);
+        stats.active_plugins = active_plugins;
+        stats.predicted_render_us = 0;
+        if (current->history.size() < MIN_SAMPLES)
+        {
+            stats.mode     = repaint_delay_mode_t::LEARNING;
+            stats.delay_ms = 0;
+            return 0;
+        }
+
+        stats.mode = repaint_delay_mode_t::LEARNED;
+        stats.predicted_render_us = current->history.percentile(percentile) + margin_us +
+            current->miss_penalty_us;
+        const int64_t slack_us = refresh_us - stats.predicted_render_us;
+        stats.delay_ms = std::clamp<int64_t>(slack_us / 1000, 0, max_delay_ms);
+        return stats.delay_ms;
+    }
+
+    /**
+     * Use a delay which does not depend on the measurements, e.g. because the dynamic delay is disabled.
+     * Render times are still recorded.
+     */
+    void start_fixed_frame(const std::string& active_plugins, repaint_delay_mode_t mode, int delay_ms)
+    {
+        current = &get_profile(active_plugins);
+        stats.active_plugins = active_plugins;
+        stats.mode     = mode;
+        stats.delay_ms = delay_ms;
+        stats.predicted_render_us = 0;
+    }
+
+    /** The frame which was last started took @render_us to render. */
+    void frame_rendered(int64_t render_us)
+    {
+        if (current)
+        {
+            current->history.add(render_us);
+            current->frames++;
+        }
+    }
+
+    /**
+     * Report whether the previous frame made it to the screen in time.
+     */
+    void frame_presented(bool on_time, int64_t refresh_us)
+    {
+        if (!current)
+        {
+            return;
+        }
+
+        if (on_time)
+        {
+            current->miss_penalty_us -= (current->miss_penalty_us + 63) / 64;
+        } else
+        {
+            current->missed_frames++;
+            current->miss_penalty_us = std::min(current->miss_penalty_us + MISS_PENALTY_STEP_US, refresh_us);
+        }
+    }
+
+    repaint_stats_t get_stats(int percentile) const
+    {
+        auto result = stats;
+        result.profiles.clear();
+        for (auto& [name, profile] : profiles)
+        {
+            repaint_profile_stats_t entry;
+            entry.active_plugins  = name;
+            entry.samples         = profile.history.size();
+            entry.last_render_us  = profile.history.get_last();
+            entry.max_render_us   = profile.history.get_max();
+            entry.percentile_render_us = profile.history.percentile(percentile);
+            entry.miss_penalty_us = profile.miss_penalty_us;
+            entry.frames = profile.frames;
+            entry.missed_frames = profile.missed_frames;
+            result.profiles.push_back(entry);
+        }
+
+        return result;
+    }
+
+  private:
+    struct profile_t
+    {
+        render_time_history_t history;
+        int64_t miss_penalty_us = 0;
+        uint64_t frames = 0;
+        uint64_t missed_frames = 0;
+        uint64_t last_use = 0;
+    };
+
+    std::map<std::string, profile_t> profiles;
+    profile_t *current = nullptr;
+    repaint_stats_t stats;
+    uint64_t use_counter = 0;
+
+    profile_t& get_profile(const std::string& active_plugins)
+    {
+        auto it = profiles.find(active_plugins);
+        if ((it == profiles.end()) && (profiles.size() >= MAX_PROFILES))
+        {
+            auto oldest = std::min_element(profiles.begin(), profiles.end(), [] (auto& a, auto& b)
+            {
+                return a.second.last_use < b.second.last_use;
+            });
+            if (&oldest->second == current)
+            {
+                current = nullptr;
+            }
+
+            profiles.erase(oldest);
+        }
+
+        auto& profile = (it == profiles.end()) ? profiles[active_plugins] : it->second;
+        profile.last_use = ++use_counter;
+        return profile;
+    }
+};
+}
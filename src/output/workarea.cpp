@@ -4,6 +4,7 @@
 #include <wayfire/output.hpp>
 #include <wayfire/signal-definitions.hpp>
 #include <wayfire/output-layout.hpp>
+#include <wayfire/util.hpp>
 
 struct wf::output_workarea_manager_t::impl
 {
@@ -11,6 +12,24 @@ struct wf::output_workarea_manager_t::impl
     std::vector<anchored_area*> anchors;
     output_t *output;
     wf::signal::connection_t<output_configuration_changed_signal> on_configuration_changed;
+
+    // Reflows in the current and in the previous second, see get_reflows_per_second().
+    int64_t current_second = 0;
+    int reflows_current_second  = 0;
+    int reflows_previous_second = 0;
+
+    void update_reflow_counter(int new_reflows)
+    {
+        const int64_t now = wf::get_current_time() / 1000;
+        if (now != current_second)
+        {
+            reflows_previous_second = (now == current_second + 1) ? reflows_current_second : 0;
+            reflows_current_second  = 0;
+            current_second = now;
+        }
+
+        reflows_current_second += new_reflows;
+    }
 };
 
 wf::output_workarea_manager_t::output_workarea_manager_t(output_t *output)
@@ -43,8 +62,15 @@ void wf::output_workarea_manager_t::remove_reserved_area(anchored_area *area)
     priv->anchors.erase(it, priv->anchors.end());
 }
 
+int wf::output_workarea_manager_t::get_reflows_per_second()
+{
+    priv->update_reflow_counter(0);
+    return priv->reflows_previous_second;
+}
+
 void wf::output_workarea_manager_t::reflow_reserved_areas()
 {
+    priv->update_reflow_counter(1);
     auto old_workarea = priv->current_workarea;
 
     priv->current_workarea = priv->output->get_relative_geometry();
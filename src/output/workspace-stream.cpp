@@ -110,6 +110,7 @@ class workspace_stream_node_t::workspace_stream_instance_t : public scene::
                     .instance = this,
                     .target   = target,
                     .damage   = our_damage,
+                    .opaque_region = bbox,
                 });
         }
     }
@@ -136,6 +137,10 @@ class workspace_stream_node_t::workspace_stream_instance_t : public scene::
     {
         scene::compute_visibility_from_list(instances, output, visible,
             -get_offset());
+
+        // Like in schedule_instructions(), the workspace is filled with the background color, so nothing
+        // below it is visible.
+        visible ^= self->get_bounding_box();
     }
 };
 
@@ -334,7 +334,6 @@ static wf::dimensions_t sanitize_buffer_size(wf::dimensions_t size, float max_al
 {
     if ((size.width > max_allowed_size) || (size.height > max_allowed_size))
     {
-        LOGW("Attempting to allocate a buffer which is too large ", size, "!");
         float scale = std::min(max_allowed_size / size.width, max_allowed_size / size.height);
         size.width  = std::ceil(size.width * scale);
         size.height = std::ceil(size.height * scale);
@@ -343,17 +342,27 @@ static wf::dimensions_t sanitize_buffer_size(wf::dimensions_t size, float max_al
     return size;
 }
 
-wf::buffer_reallocation_result_t wf::auxilliary_buffer_t::allocate(wf::dimensions_t size, float scale,
-    buffer_allocation_hints_t hints)
+wf::dimensions_t wf::auxilliary_buffer_t::get_allocation_size(wf::dimensions_t size, float scale)
 {
     // From 16k x 16k upwards, we very often hit various limits so there is no point in allocating larger
     // buffers. Plus, we never really need buffers that big in practice, so these usually indicate bugs in
     // the code.
     static wf::option_wrapper_t<int> max_buffer_size{"workarounds/max_buffer_size"};
-    const int FALLBACK_MAX_BUFFER_SIZE = 4096;
     size.width  = std::max(1, (int)std::ceil(size.width * scale));
     size.height = std::max(1, (int)std::ceil(size.height * scale));
-    size = sanitize_buffer_size(size, max_buffer_size);
+    return sanitize_buffer_size(size, max_buffer_size);
+}
+
+wf::buffer_reallocation_result_t wf::auxilliary_buffer_t::allocate(wf::dimensions_t size, float scale,
+    buffer_allocation_hints_t hints)
+{
+    const int FALLBACK_MAX_BUFFER_SIZE = 4096;
+    const wf::dimensions_t requested{(int)std::ceil(size.width * scale), (int)std::ceil(size.height * scale)};
+    size = get_allocation_size(size, scale);
+    if ((size.width < requested.width) || (size.height < requested.height))
+    {
+        LOGW("Attempting to allocate a buffer which is too large ", requested, "!");
+    }
 
     if (buffer.get_size() == size)
     {
@@ -437,7 +446,7 @@ wf::render_buffer_t wf::auxilliary_buffer_t::get_renderbuffer() const
 }
 
 void wf::render_buffer_t::do_blit(wlr_texture *src_wlr_tex, wf::geometry_t src_box,
-    wf::geometry_t dst_box, wlr_scale_filter_mode filter_mode) const
+    wf::geometry_t dst_box, wlr_scale_filter_mode filter_mode, const wf::region_t *clip) const
 {
     auto renderer = wf::get_core().renderer;
     auto target_buffer = this->get_buffer();
@@ -461,7 +470,7 @@ void wf::render_buffer_t::do_blit(wlr_texture *src_wlr_tex, wf::geometry_t src_b
     opts.blend_mode  = WLR_RENDER_BLEND_MODE_NONE;
     opts.filter_mode = filter_mode;
     opts.transform   = WL_OUTPUT_TRANSFORM_NORMAL;
-    opts.clip    = NULL;
+    opts.clip    = clip ? clip->to_pixman() : NULL;
     opts.src_box = {
         .x     = (float)src_box.x,
         .y     = (float)src_box.y,
@@ -477,11 +486,11 @@ void wf::render_buffer_t::do_blit(wlr_texture *src_wlr_tex, wf::geometry_t src_b
 }
 
 void wf::render_buffer_t::blit(wf::auxilliary_buffer_t& source, wf::geometry_t src_box,
-    wf::geometry_t dst_box, wlr_scale_filter_mode filter_mode) const
+    wf::geometry_t dst_box, wlr_scale_filter_mode filter_mode, const wf::region_t *clip) const
 {
     if (wlr_texture *src_wlr_tex = source.get_texture())
     {
-        do_blit(src_wlr_tex, src_box, dst_box, filter_mode);
+        do_blit(src_wlr_tex, src_box, dst_box, filter_mode, clip);
     } else
     {
         LOGE("Failed to get source texture for auxilliary_buffer_t copy!");
@@ -489,11 +498,11 @@ void wf::render_buffer_t::blit(wf::auxilliary_buffer_t& source, wf::geometry_t s
 }
 
 void wf::render_buffer_t::blit(const wf::render_buffer_t& source, wf::geometry_t src_box,
-    wf::geometry_t dst_box, wlr_scale_filter_mode filter_mode) const
+    wf::geometry_t dst_box, wlr_scale_filter_mode filter_mode, const wf::region_t *clip) const
 {
     if (wlr_texture *src_wlr_tex = wlr_texture_from_buffer(wf::get_core().renderer, source.get_buffer()))
     {
-        do_blit(src_wlr_tex, src_box, dst_box, filter_mode);
+        do_blit(src_wlr_tex, src_box, dst_box, filter_mode, clip);
         wlr_texture_destroy(src_wlr_tex);
     } else
     {
@@ -714,6 +723,85 @@ wf::regionf_t wf::render_pass_t::run(const wf::render_pass_params_t& params)
     return damage;
 }
 
+/**
+ * Project @region onto the framebuffer of @target, keeping only the pixels which are entirely inside it.
+ * This is the opposite of framebuffer_region_from_geometry_region(), which keeps every touched pixel.
+ */
+static wf::region_t framebuffer_region_inside(const wf::render_target_t& target,
+    const wf::regionf_t& region)
+{
+    wf::region_t result;
+    for (const auto& rect : region)
+    {
+        auto box = target.framebuffer_geometry_from_geometry_box({
+            rect.x1,
+            rect.y1,
+            rect.x2 - rect.x1,
+            rect.y2 - rect.y1,
+        });
+
+        const int x1 = std::ceil(box.x);
+        const int y1 = std::ceil(box.y);
+        const int x2 = std::floor(box.x + box.width);
+        const int y2 = std::floor(box.y + box.height);
+        if ((x2 > x1) && (y2 > y1))
+        {
+            result |= wlr_box{x1, y1, x2 - x1, y2 - y1};
+        }
+    }
+
+    return result;
+}
+
+/**
+ * Remove the instructions for @buffer which are entirely covered by the opaque regions of instructions
+ * above them. Instructions are ordered front-to-back, so the occluded region is built up while iterating.
+ *
+ * Instructions without an opaque region may be translucent, or even sample the pixels below them (for
+ * example blur), so their damage is removed from the occluded region again. Instructions for other buffers
+ * are never culled.
+ *
+ * @return The number of removed instructions.
+ */
+static uint64_t cull_occluded_instructions(std::vector<wf::scene::render_instruction_t>& instructions,
+    wlr_buffer *buffer)
+{
+    uint64_t culled = 0;
+    size_t kept = 0;
+    wf::region_t occluded;
+    for (size_t i = 0; i < instructions.size(); i++)
+    {
+        auto& instr = instructions[i];
+        if (instr.target.get_buffer() == buffer)
+        {
+            auto damage = instr.target.framebuffer_region_from_geometry_region(instr.damage);
+            if (!damage.empty() && (damage ^ occluded).empty())
+            {
+                ++culled;
+                continue;
+            }
+
+            if (instr.opaque_region.empty())
+            {
+                occluded ^= damage;
+            } else
+            {
+                occluded |= framebuffer_region_inside(instr.target, instr.opaque_region & instr.damage);
+            }
+        }
+
+        if (kept != i)
+        {
+            instructions[kept] = std::move(instr);
+        }
+
+        ++kept;
+    }
+
+    instructions.erase(instructions.begin() + kept, instructions.end());
+    return culled;
+}
+
 wf::regionf_t wf::render_pass_t::run_partial()
 {
     auto accumulated_damage = params.damage;
@@ -737,6 +825,8 @@ wf::regionf_t wf::render_pass_t::run_partial()
         }
     }
 
+    culled_instructions = cull_occluded_instructions(instructions, params.target.get_buffer());
+
     // When we need the wlr pass, start rendering.
     this->needs_restart = true;
 
@@ -771,6 +861,11 @@ wf::render_target_t wf::render_pass_t::get_target() const
     return params.target;
 }
 
+uint64_t wf::render_pass_t::get_culled_instructions() const
+{
+    return culled_instructions;
+}
+
 wlr_renderer*wf::render_pass_t::get_wlr_renderer() const
 {
     return params.renderer;
@@ -914,6 +1009,7 @@ wf::render_pass_t& wf::render_pass_t::operator =(render_pass_t&& other)
     other._pass  = NULL;
     this->params = other.params;
     this->needs_restart = other.needs_restart;
+    this->culled_instructions = other.culled_instructions;
     return *this;
 }
 
@@ -1,6 +1,7 @@
 #include <algorithm>
 #include <cstring>
 #include <cstdlib>
+#include <optional>
 
 #include <wayfire/seat.hpp>
 #include <wayfire/workarea.hpp>
@@ -61,8 +62,13 @@ class wayfire_layer_shell_view : public wf::view_interface_t
 
     static std::shared_ptr<wayfire_layer_shell_view> create(wlr_layer_surface_v1 *lsurface);
     std::unique_ptr<wf::output_workarea_manager_t::anchored_area> anchored_area;
+    /** The workarea passed to the anchored area in the last reflow. */
+    wf::geometry_t anchored_workarea{0, 0, 0, 0};
     void remove_anchored(bool reflow);
 
+    /** The last box passed to configure(), used to avoid sending the same configure again. */
+    std::optional<wf::geometry_t> last_configured_box;
+
     virtual ~wayfire_layer_shell_view() = default;
 
     void map();
@@ -256,6 +262,7 @@ struct wf_layer_shell_manager
                 std::make_unique<wf::output_workarea_manager_t::anchored_area>();
             v->anchored_area->reflowed = [this, v] (wf::geometry_t avail_workarea)
             {
+                v->anchored_workarea = avail_workarea;
                 pin_view(v, avail_workarea);
             };
             /* Notice that the reflowed areas won't be changed until we call
@@ -381,6 +388,70 @@ struct wf_layer_shell_manager
             arrange_floating(output, layer);
         }
     }
+
+    /**
+     * Check whether the committed state of a layer surface changed in a way which affects its position or
+     * size, or the reserved areas of the output.
+     */
+    static bool layout_changed(const wlr_layer_surface_v1_state& a, const wlr_layer_surface_v1_state& b)
+    {
+        return (a.anchor != b.anchor) ||
+               (a.exclusive_zone != b.exclusive_zone) ||
+               (a.margin.top != b.margin.top) ||
+               (a.margin.bottom != b.margin.bottom) ||
+               (a.margin.left != b.margin.left) ||
+               (a.margin.right != b.margin.right) ||
+               (a.desired_width != b.desired_width) ||
+               (a.desired_height != b.desired_height);
+    }
+
+    /**
+     * Update the position of a single view after its state changed from @old_state.
+     *
+     * The reserved areas of the output are reflowed only if the view's own reservation changed. Other
+     * floating views are re-pinned only if that changes the workarea.
+     */
+    void arrange_view(wayfire_layer_shell_view *view, const wlr_layer_surface_v1_state& old_state)
+    {
+        auto output = view->get_output();
+        auto& state = view->lsurface->current;
+
+        const bool reserved_before = old_state.exclusive_zone > 0;
+        const bool reserved_now    = state.exclusive_zone > 0;
+        const bool reservation_changed = (reserved_before != reserved_now) ||
+            (reserved_now && ((old_state.anchor != state.anchor) ||
+                              (old_state.exclusive_zone != state.exclusive_zone)));
+
+        if (!reservation_changed)
+        {
+            LOGC(LSHELL, "Re-pin ", view->self(), " without reflow");
+            pin_view(view, view->anchored_area ? view->anchored_workarea : output->workarea->get_workarea());
+            return;
+        }
+
+        if (reserved_now)
+        {
+            set_exclusive_zone(view);
+        } else
+        {
+            view->remove_anchored(false);
+        }
+
+        // Pins all views with a reserved area, including this one if it has one.
+        auto old_workarea = output->workarea->get_workarea();
+        output->workarea->reflow_reserved_areas();
+
+        if (output->workarea->get_workarea() != old_workarea)
+        {
+            for (int layer = 0; layer < COUNT_LAYERS; layer++)
+            {
+                arrange_floating(output, layer);
+            }
+        } else if (!reserved_now)
+        {
+            pin_view(view, output->workarea->get_workarea());
+        }
+    }
 };
 
 wayfire_layer_shell_view::wayfire_layer_shell_view(wlr_layer_surface_v1 *lsurf) :
@@ -524,6 +595,8 @@ void wayfire_layer_shell_view::unmap()
     damage();
 
     emit_view_pre_unmap();
+    // The client has to receive a new initial configure when it maps again.
+    last_configured_box.reset();
     priv->unset_mapped_surface_contents();
     priv->set_mapped(nullptr);
     on_surface_commit.disconnect();
@@ -557,10 +630,10 @@ void wayfire_layer_shell_view::commit()
             wf::scene::readd_front(get_output()->node_for_layer(get_layer()), get_root_node());
             /* Will also trigger reflowing */
             wf_layer_shell_manager::get_instance().handle_move_layer(this);
-        } else
+        } else if (wf_layer_shell_manager::layout_changed(prev_state, *state))
         {
-            /* Reflow reserved areas and positions */
-            wf_layer_shell_manager::get_instance().arrange_layers(get_output());
+            /* Reflow reserved areas and positions, as far as they are affected */
+            wf_layer_shell_manager::get_instance().arrange_view(this, prev_state);
         }
 
         if (prev_state.keyboard_interactive != state->keyboard_interactive)
@@ -633,6 +706,13 @@ void wayfire_layer_shell_view::configure(wf::geometry_t box)
         return;
     }
 
+    if (last_configured_box == box)
+    {
+        return;
+    }
+
+    last_configured_box = box;
+
     // TODO: transactions here could make sense, since we want to change x,y,w,h together, but have to wait
     // for the client to resize.
     move(box.x, box.y);
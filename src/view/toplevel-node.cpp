@@ -144,11 +144,25 @@ std::shared_ptr<wf::texture_t> wf::toplevel_view_node_t::to_texture() const
 wf::regionf_t wf::toplevel_view_node_t::get_opaque_region() const
 {
     auto view = _view.lock();
-    if (view && view->is_mapped() && view->get_wlr_surface())
+    if (!view || !view->is_mapped())
     {
-        auto surf = view->get_wlr_surface();
-        return wf::regionf_t{&surf->opaque_region} + get_offset();
+        return {};
     }
 
-    return {};
+    wf::regionf_t region;
+    if (auto surf = view->get_wlr_surface())
+    {
+        region = wf::regionf_t{&surf->opaque_region};
+    }
+
+    // Other children, like server-side decorations, may cover more of the view.
+    for (auto& ch : get_children())
+    {
+        if (auto opaque = dynamic_cast<opaque_region_node_t*>(ch.get()))
+        {
+            region |= opaque->get_opaque_region();
+        }
+    }
+
+    return region + get_offset();
 }
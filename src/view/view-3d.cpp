@@ -9,6 +9,7 @@
 #include "wayfire/opengl.hpp"
 #include "wayfire/core.hpp"
 #include "wayfire/output.hpp"
+#include "wayfire/aux-buffer-pool.hpp"
 #include <glm/ext/matrix_transform.hpp>
 #include <string>
 #include <tuple>
@@ -237,6 +238,60 @@ wf::geometry_t view_2d_transformer_t::get_bounding_box()
     return get_bbox_for_node(this, get_children_bounding_box());
 }
 
+std::optional<glm::mat4> view_2d_transformer_t::get_linear_transform()
+{
+    auto midpoint  = get_center(view);
+    auto center_at = glm::translate(glm::mat4(1.0),
+        {-midpoint.x, -midpoint.y, 0.0});
+    auto scale = glm::scale(glm::mat4(1.0),
+        glm::vec3{get_scale_x(), get_scale_y(), 1.0});
+    auto rotate = glm::rotate<float>(glm::mat4(1.0), -get_angle(),
+        glm::vec3{0.0, 0.0, 1.0});
+    auto translate = glm::translate(glm::mat4(1.0),
+        glm::vec3{get_translation_x() + midpoint.x,
+            get_translation_y() + midpoint.y, 0.0});
+
+    return translate * rotate * scale * center_at;
+}
+
+glm::vec4 view_2d_transformer_t::get_color_multiplier()
+{
+    return glm::vec4{1.0, 1.0, 1.0, get_alpha()};
+}
+
+wf::regionf_t view_2d_transformer_t::get_opaque_region() const
+{
+    // Rotated views are not axis-aligned, so we cannot easily tell which pixels are covered.
+    if ((get_alpha() < 1.0f) || (std::abs(get_angle()) >= 1e-3) || (get_children().size() != 1))
+    {
+        return {};
+    }
+
+    auto child = dynamic_cast<opaque_region_node_t*>(get_children().front().get());
+    if (!child)
+    {
+        return {};
+    }
+
+    // The edges of the opaque boxes are blended with the translucent pixels next to them when filtering,
+    // so shrink them by (at least) a texel after scaling.
+    const double margin = 1.0 + std::ceil(std::max({1.0f, std::abs(get_scale_x()), std::abs(get_scale_y())}));
+
+    auto self = const_cast<view_2d_transformer_t*>(this);
+    wf::regionf_t result;
+    for (auto& box : child->get_opaque_region())
+    {
+        auto transformed = get_bbox_for_node(self, geometry_from_pixman_box(box));
+        if ((transformed.width > 2 * margin) && (transformed.height > 2 * margin))
+        {
+            result |= wf::geometry_t{transformed.x + margin, transformed.y + margin,
+                transformed.width - 2 * margin, transformed.height - 2 * margin};
+        }
+    }
+
+    return result;
+}
+
 static void transform_linear_damage(node_t *self, wf::regionf_t& damage)
 {
     auto copy = damage;
@@ -247,6 +302,62 @@ static void transform_linear_damage(node_t *self, wf::regionf_t& damage)
     }
 }
 
+/**
+ * Render @tex, which covers @bbox, with an arbitrary linear @transform (from @bbox's coordinate system to the
+ * logical coordinates of the render target) and color multiplier.
+ */
+static void render_linear_texture(const wf::scene::render_instruction_t& data,
+    std::shared_ptr<wf::texture_t> texture, wf::geometry_t bbox, glm::mat4 transform, glm::vec4 color)
+{
+    data.pass->custom_gles_subpass([&]
+    {
+        auto tex = wf::gles_texture_t{texture};
+        wf::gles::bind_render_buffer(data.target);
+        auto ortho = wf::gles::render_target_orthographic_projection(data.target);
+
+        for (auto& box : data.damage)
+        {
+            wf::gles::render_target_logic_scissor(data.target, box);
+            OpenGL::render_transformed_texture(tex, bbox, ortho * transform, color);
+        }
+    });
+
+#if WF_HAS_VULKANFX
+    data.pass->custom_vulkan_subpass([&] (wf::vulkan_render_state_t& state, vk::command_buffer_t& cmd_buf)
+    {
+        auto& vk_state = vk::core_ensure_vk(state);
+        auto tex_dset  = state.get_descriptor_pool()->get_descriptor_set(cmd_buf, texture);
+        wf::vk::texture_sampling_params_t sampling{texture};
+        wf::vk::pipeline_specialization_t specialization{};
+        specialization.add_specialization_for_texture(texture);
+
+        // The shader renders a hardcoded quad from (0,0) to (1,1) so scale to match view size first.
+        glm::mat4 scale     = glm::scale(glm::mat4(1.0), {1.0 * bbox.width, -1.0 * bbox.height, 1.0f});
+        glm::mat4 translate = glm::translate(glm::mat4(1.0), {bbox.x, bbox.y + bbox.height, 0});
+        auto full_transform = vk::render_target_transform(data.target) * transform * translate * scale;
+
+        auto [layout, _] = cmd_buf.bind_pipeline(vk_state.pipeline, data.target, specialization);
+        cmd_buf.set_full_viewport(data.target);
+        cmd_buf.bind_texture(texture);
+
+        vkCmdBindDescriptorSets(cmd_buf, VK_PIPELINE_BIND_POINT_GRAPHICS, layout,
+            0, 1, &tex_dset, 0, nullptr);
+
+        vk::core_vulkan_push_data_t push_constants{};
+        push_constants.transform = full_transform;
+        push_constants.uv_scale  = sampling.get_uv_scale();
+        push_constants.uv_offset = sampling.get_uv_offset();
+        vkCmdPushConstants(cmd_buf, layout, VK_SHADER_STAGE_VERTEX_BIT,
+            0, sizeof(vk::core_vulkan_push_data_t), &push_constants);
+
+        cmd_buf.for_each_scissor_rect(data.target, (data.damage & data.target.geometry), [&]
+        {
+            vkCmdDraw(cmd_buf, 4, 1, 0, 0);
+        });
+    });
+#endif
+}
+
 class view_2d_render_instance_t :
     public transformer_render_instance_t<view_2d_transformer_t>
 {
@@ -258,84 +369,31 @@ class view_2d_render_instance_t :
         transform_linear_damage(self.get(), damage);
     }
 
+    std::shared_ptr<wf::texture_t> get_fused_texture(float scale, glm::mat4& transform,
+        glm::vec4& color, wf::geometry_t& bbox) override
+    {
+        return fuse_linear_transform(scale, transform, color, bbox);
+    }
+
     void render(const wf::scene::render_instruction_t& data) override
     {
-        if (std::abs(self->get_angle()) < 1e-3)
+        glm::mat4 chain{1.0};
+        glm::vec4 color{1.0};
+        wf::geometry_t bbox;
+        bool fused;
+        auto tex = this->get_fused_children_texture(data.target.scale, chain, color, bbox, fused);
+
+        if ((std::abs(self->get_angle()) < 1e-3) && !fused)
         {
             // No rotation, we can use render-agnostic functions.
-            auto tex = this->get_texture(data.target.scale);
             tex->set_filter_mode(WLR_SCALE_FILTER_BILINEAR);
-            auto bbox = self->get_bounding_box();
-            data.pass->add_texture(tex, data.target, bbox, data.damage, self->get_alpha());
+            data.pass->add_texture(tex, data.target, self->get_bounding_box(), data.damage,
+                self->get_alpha());
             return;
         }
 
-        // Untransformed bounding box
-        auto bbox = self->get_children_bounding_box();
-
-        auto midpoint  = get_center(self->view);
-        auto center_at = glm::translate(glm::mat4(1.0),
-            {-midpoint.x, -midpoint.y, 0.0});
-        auto scale = glm::scale(glm::mat4(1.0),
-            glm::vec3{self->get_scale_x(), self->get_scale_y(), 1.0});
-        auto rotate = glm::rotate<float>(glm::mat4(1.0), -self->get_angle(),
-            glm::vec3{0.0, 0.0, 1.0});
-        auto translate = glm::translate(glm::mat4(1.0),
-            glm::vec3{self->get_translation_x() + midpoint.x,
-                self->get_translation_y() + midpoint.y, 0.0});
-
-        auto flat_transform = translate * rotate * scale * center_at;
-
-        data.pass->custom_gles_subpass([&]
-        {
-            auto tex = wf::gles_texture_t{this->get_texture(data.target.scale)};
-            wf::gles::bind_render_buffer(data.target);
-            auto ortho = wf::gles::render_target_orthographic_projection(data.target);
-
-            for (auto& box : data.damage)
-            {
-                wf::gles::render_target_logic_scissor(data.target, box);
-                // OpenGL::clear({1, 0, 0, 1});
-                OpenGL::render_transformed_texture(tex, bbox, ortho * flat_transform,
-                    glm::vec4{1.0, 1.0, 1.0, self->get_alpha()});
-            }
-        });
-
-#if WF_HAS_VULKANFX
-        data.pass->custom_vulkan_subpass([&] (wf::vulkan_render_state_t& state, vk::command_buffer_t& cmd_buf)
-        {
-            auto& vk_state = vk::core_ensure_vk(state);
-            auto texture   = get_texture(data.target.scale);
-            auto tex_dset  = state.get_descriptor_pool()->get_descriptor_set(cmd_buf, texture);
-            wf::vk::texture_sampling_params_t sampling{texture};
-            wf::vk::pipeline_specialization_t specialization{};
-            specialization.add_specialization_for_texture(texture);
-
-            // The shader renders a hardcoded quad from (0,0) to (1,1) so scale to match view size first.
-            glm::mat4 scale     = glm::scale(glm::mat4(1.0), {1.0 * bbox.width, -1.0 * bbox.height, 1.0f});
-            glm::mat4 translate = glm::translate(glm::mat4(1.0), {bbox.x, bbox.y + bbox.height, 0});
-            auto transform = vk::render_target_transform(data.target) * flat_transform * translate * scale;
-
-            auto [layout, _] = cmd_buf.bind_pipeline(vk_state.pipeline, data.target, specialization);
-            cmd_buf.set_full_viewport(data.target);
-            cmd_buf.bind_texture(texture);
-
-            vkCmdBindDescriptorSets(cmd_buf, VK_PIPELINE_BIND_POINT_GRAPHICS, layout,
-                0, 1, &tex_dset, 0, nullptr);
-
-            vk::core_vulkan_push_data_t push_constants{};
-            push_constants.transform = transform;
-            push_constants.uv_scale  = sampling.get_uv_scale();
-            push_constants.uv_offset = sampling.get_uv_offset();
-            vkCmdPushConstants(cmd_buf, layout, VK_SHADER_STAGE_VERTEX_BIT,
-                0, sizeof(vk::core_vulkan_push_data_t), &push_constants);
-
-            cmd_buf.for_each_scissor_rect(data.target, (data.damage & data.target.geometry), [&]
-            {
-                vkCmdDraw(cmd_buf, 4, 1, 0, 0);
-            });
-        });
-#endif
+        render_linear_texture(data, tex, bbox, self->get_linear_transform().value() * chain,
+            self->get_color_multiplier() * color);
     }
 };
 
@@ -481,6 +539,24 @@ wf::geometry_t view_3d_transformer_t::get_bounding_box()
     return get_bbox_for_node(this, get_children_bounding_box());
 }
 
+std::optional<glm::mat4> view_3d_transformer_t::get_linear_transform()
+{
+    // The total transform works in a coordinate system centered at the view's center, with the Y axis
+    // pointing up (see get_center_relative_coords()), so wrap it to get a transform in logical coordinates.
+    auto center = scene::get_center(get_children_bounding_box());
+    auto to_relative = glm::scale(glm::mat4(1.0), {1, -1, 1}) *
+        glm::translate(glm::mat4(1.0), {-center.x, -center.y, 0});
+    auto from_relative = glm::translate(glm::mat4(1.0), {center.x, center.y, 0}) *
+        glm::scale(glm::mat4(1.0), {1, -1, 1});
+
+    return from_relative * calculate_total_transform() * to_relative;
+}
+
+glm::vec4 view_3d_transformer_t::get_color_multiplier()
+{
+    return color;
+}
+
 struct transformable_quad
 {
     gl_geometry geometry;
@@ -523,8 +599,27 @@ class view_3d_render_instance_t :
         transform_linear_damage(self.get(), damage);
     }
 
+    std::shared_ptr<wf::texture_t> get_fused_texture(float scale, glm::mat4& transform,
+        glm::vec4& color, wf::geometry_t& bbox) override
+    {
+        return fuse_linear_transform(scale, transform, color, bbox);
+    }
+
     void render(const wf::scene::render_instruction_t& data) override
     {
+        glm::mat4 chain{1.0};
+        glm::vec4 chain_color{1.0};
+        wf::geometry_t fused_bbox;
+        bool fused;
+        auto fused_tex = this->get_fused_children_texture(data.target.scale, chain, chain_color, fused_bbox,
+            fused);
+        if (fused)
+        {
+            render_linear_texture(data, fused_tex, fused_bbox, self->get_linear_transform().value() * chain,
+                self->color * chain_color);
+            return;
+        }
+
         auto bbox = self->get_children_bounding_box();
         auto quad = center_geometry(data.target.geometry, bbox, scene::get_center(bbox));
 
@@ -541,7 +636,7 @@ class view_3d_render_instance_t :
 
         data.pass->custom_gles_subpass([&]
         {
-            auto tex = wf::gles_texture_t{get_texture(data.target.scale)};
+            auto tex = wf::gles_texture_t{fused_tex};
             wf::gles::bind_render_buffer(data.target);
             for (auto& box : data.damage)
             {
@@ -555,7 +650,7 @@ class view_3d_render_instance_t :
         data.pass->custom_vulkan_subpass([&] (wf::vulkan_render_state_t& state, vk::command_buffer_t& cmd_buf)
         {
             auto& vk_state = vk::core_ensure_vk(state);
-            auto texture   = get_texture(data.target.scale);
+            auto texture   = fused_tex;
             auto tex_dset  = state.get_descriptor_pool()->get_descriptor_set(cmd_buf, texture);
             wf::vk::texture_sampling_params_t sampling{texture};
             wf::vk::pipeline_specialization_t specialization{};
@@ -620,7 +715,8 @@ uint32_t transformer_base_node_t::optimize_update(uint32_t flags)
 std::shared_ptr<wf::texture_t> transformer_base_node_t::get_updated_contents(const wf::geometry_t& bbox,
     float scale, std::vector<scene::render_instance_uptr>& children, wf::output_t *output)
 {
-    if (inner_content.allocate(wf::dimensions(bbox), scale,
+    const float buffer_scale = scale * std::clamp(buffer_scale_hint, 0.01f, 1.0f);
+    if (wf::get_core().aux_buffer_pool->acquire(inner_content, wf::dimensions(bbox), buffer_scale,
         wf::buffer_allocation_hints_t{.hdr_linear = output && output->is_hdr()}) !=
         buffer_reallocation_result_t::SAME)
     {
@@ -628,7 +724,7 @@ std::shared_ptr<wf::texture_t> transformer_base_node_t::get_updated_contents(con
     }
 
     wf::render_target_t target{inner_content};
-    target.scale    = scale;
+    target.scale    = buffer_scale;
     target.geometry = bbox;
 
     render_pass_params_t params;
@@ -645,7 +741,18 @@ std::shared_ptr<wf::texture_t> transformer_base_node_t::get_updated_contents(con
 
 void transformer_base_node_t::release_buffers()
 {
-    inner_content.free();
+    if (!inner_content.get_buffer())
+    {
+        return;
+    }
+
+    if (auto& pool = wf::get_core().aux_buffer_pool)
+    {
+        pool->release(inner_content);
+    } else
+    {
+        inner_content.free();
+    }
 }
 
 transformer_base_node_t::~transformer_base_node_t()
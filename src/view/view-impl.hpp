@@ -70,6 +70,11 @@ void fini_xdg_shell();
 void fini_xwayland();
 void fini_layer_shell();
 
+/**
+ * Start Xwayland if it was created in lazy mode and no X11 client has connected yet.
+ */
+void xwayland_prewarm();
+
 std::string xwayland_get_display();
 void xwayland_update_default_cursor();
 
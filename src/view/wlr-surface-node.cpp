@@ -363,6 +363,7 @@ class wf::scene::wlr_surface_node_t::wlr_surface_render_instance_t : public rend
                 .instance = this,
                 .target   = target,
                 .damage   = std::move(our_damage),
+                .opaque_region = self->current_state.opaque_region,
             });
 
             damage ^= self->current_state.opaque_region;
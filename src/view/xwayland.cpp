@@ -9,12 +9,18 @@
 
 #include "wayfire/unstable/wlr-view-events.hpp"
 #include "wayfire/util.hpp"
+#include "wayfire/startup-timing.hpp"
 #include "xwayland/xwayland-helpers.hpp"
 #include "xwayland/xwayland-view-base.hpp"
 #include "xwayland/xwayland-unmanaged-view.hpp"
 #include "xwayland/xwayland-toplevel-view.hpp"
 
 #if WF_HAS_XWAYLAND
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
 
 xcb_atom_t wf::xw::_NET_WM_WINDOW_TYPE_NORMAL;
 xcb_atom_t wf::xw::_NET_WM_WINDOW_TYPE_DIALOG;
@@ -245,6 +251,7 @@ void wf::init_xwayland(bool lazy)
 
         wlr_xwayland_set_seat(xwayland_handle, wf::get_core().get_current_seat());
         xwayland_update_default_cursor();
+        wf::get_core().startup_timing->end_phase("xwayland");
 
         static wf::option_wrapper_t<std::string> xwayland_startup_script{"core/xwayland_startup_script"};
         auto script = xwayland_startup_script.value();
@@ -255,6 +262,11 @@ void wf::init_xwayland(bool lazy)
         }
     });
 
+    if (!lazy)
+    {
+        wf::get_core().startup_timing->begin_phase("xwayland");
+    }
+
     xwayland_handle = wlr_xwayland_create(wf::get_core().display,
         wf::get_core_impl().compositor, lazy);
 
@@ -267,6 +279,42 @@ void wf::init_xwayland(bool lazy)
 #endif
 }
 
+void wf::xwayland_prewarm()
+{
+#if WF_HAS_XWAYLAND
+    if (!xwayland_handle || !xwayland_handle->server || xwayland_handle->server->client)
+    {
+        // Not lazy, or already started.
+        return;
+    }
+
+    // In lazy mode, wlroots starts Xwayland on the first connection to the X11 socket. Connect to it once
+    // and hang up right away, Xwayland will simply see a client which disconnected.
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+    {
+        LOGE("Failed to create socket for Xwayland prewarm: ", strerror(errno));
+        return;
+    }
+
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    snprintf(addr.sun_path, sizeof(addr.sun_path), "/tmp/.X11-unix/X%d", xwayland_handle->server->display);
+
+    wf::get_core().startup_timing->begin_phase("xwayland");
+    if (connect(fd, (sockaddr*)&addr, sizeof(addr)) != 0)
+    {
+        LOGE("Failed to connect to ", addr.sun_path, " for Xwayland prewarm: ", strerror(errno));
+        wf::get_core().startup_timing->end_phase("xwayland");
+    } else
+    {
+        LOGD("Prewarming Xwayland on ", xwayland_handle->display_name);
+    }
+
+    close(fd);
+#endif
+}
+
 void wf::fini_xwayland()
 {
 #if WF_HAS_XWAYLAND
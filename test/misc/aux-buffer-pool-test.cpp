@@ -0,0 +1,82 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <wayfire/aux-buffer-pool.hpp>
+#include <wayfire/core.hpp>
+
+#include <csignal>
+#include <sys/resource.h>
+
+#include "../support/headless-core-harness.hpp"
+
+TEST_CASE("Buffers of the same size are reused")
+{
+    wf::test::headless_core_harness_t harness;
+    auto& pool = *wf::get_core().aux_buffer_pool;
+    const auto before = pool.get_stats();
+
+    wf::auxilliary_buffer_t buffer;
+    REQUIRE(pool.acquire(buffer, {100, 100}) == wf::buffer_reallocation_result_t::REALLOCATED);
+    auto *allocated = buffer.get_buffer();
+    REQUIRE(allocated != nullptr);
+
+    // Asking for the same size again keeps the buffer.
+    CHECK(pool.acquire(buffer, {100, 100}) == wf::buffer_reallocation_result_t::SAME);
+    CHECK(buffer.get_buffer() == allocated);
+
+    // A released buffer is handed out again for the next request of the same size.
+    pool.release(buffer);
+    CHECK(buffer.get_buffer() == nullptr);
+    CHECK(pool.acquire(buffer, {100, 100}) == wf::buffer_reallocation_result_t::REALLOCATED);
+    CHECK(buffer.get_buffer() == allocated);
+
+    const auto after = pool.get_stats();
+    CHECK(after.misses == before.misses + 1);
+    CHECK(after.hits == before.hits + 1);
+    pool.release(buffer);
+}
+
+TEST_CASE("Buffers which fell back to a smaller size are reused")
+{
+    wf::test::headless_core_harness_t harness;
+    auto& pool = *wf::get_core().aux_buffer_pool;
+
+    // The headless backend allocates shared memory files, which cannot grow beyond RLIMIT_FSIZE. Limit it so
+    // that a 8192x8192 buffer (256 MiB) fails, while the 4096x4096 fallback (64 MiB) fits.
+    rlimit old_limit;
+    REQUIRE(getrlimit(RLIMIT_FSIZE, &old_limit) == 0);
+    rlimit limit = old_limit;
+    limit.rlim_cur = 128 * 1024 * 1024;
+    REQUIRE(setrlimit(RLIMIT_FSIZE, &limit) == 0);
+    auto old_handler = std::signal(SIGXFSZ, SIG_IGN);
+
+    const wf::dimensions_t size = {8192, 8192};
+    const auto before = pool.get_stats();
+    wf::auxilliary_buffer_t buffer;
+    const auto result = pool.acquire(buffer, size);
+
+    if ((result == wf::buffer_reallocation_result_t::FAILED) || (buffer.get_size().width == size.width))
+    {
+        MESSAGE("Skipped: the allocation did not fall back to a smaller buffer");
+    } else
+    {
+        auto *allocated = buffer.get_buffer();
+        CHECK(buffer.get_size().width < size.width);
+
+        // The fallback buffer satisfies further requests of the size it was allocated for.
+        CHECK(pool.acquire(buffer, size) == wf::buffer_reallocation_result_t::SAME);
+        CHECK(buffer.get_buffer() == allocated);
+
+        pool.release(buffer);
+        CHECK(pool.acquire(buffer, size) == wf::buffer_reallocation_result_t::REALLOCATED);
+        CHECK(buffer.get_buffer() == allocated);
+
+        const auto after = pool.get_stats();
+        CHECK(after.misses == before.misses + 1);
+        CHECK(after.hits == before.hits + 1);
+    }
+
+    pool.release(buffer);
+    std::signal(SIGXFSZ, old_handler);
+    setrlimit(RLIMIT_FSIZE, &old_limit);
+}
@@ -0,0 +1,77 @@
+#include <wayfire/object.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+/**
+ * Compares the cost of custom data lookups by name and by type on an object which carries a typical number
+ * of entries. Run with `meson test --benchmark`.
+ */
+namespace
+{
+class bench_object_t : public wf::object_base_t
+{};
+
+template<int N>
+struct bench_data_t : public wf::custom_data_t
+{
+    int value = N;
+};
+
+template<class F>
+void measure(const char *what, int iterations, F&& func)
+{
+    auto start = std::chrono::steady_clock::now();
+    long sum   = 0;
+    for (int i = 0; i < iterations; i++)
+    {
+        sum += func();
+    }
+
+    auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+    std::printf("%-40s %8.2f ns/op (checksum %ld)\n", what, elapsed.count() / iterations, sum);
+}
+}
+
+int main()
+{
+    constexpr int iterations = 5'000'000;
+
+    bench_object_t object;
+    object.store_data(std::make_unique<bench_data_t<0>>());
+    object.store_data(std::make_unique<bench_data_t<1>>());
+    object.store_data(std::make_unique<bench_data_t<2>>());
+    object.store_data(std::make_unique<bench_data_t<3>>());
+    object.store_data(std::make_unique<bench_data_t<4>>(), "named-data");
+    object.set_property("property", 5);
+
+    const std::string type_name = typeid(bench_data_t<3>).name();
+    measure("get_data<T>() (typed slot)", iterations, [&] ()
+    {
+        return object.get_data<bench_data_t<3>>()->value;
+    });
+
+    measure("get_data<T>(typeid(T).name())", iterations, [&] ()
+    {
+        return object.get_data<bench_data_t<3>>(typeid(bench_data_t<3>).name())->value;
+    });
+
+    measure("get_data<T>(name)", iterations, [&] ()
+    {
+        return object.get_data<bench_data_t<4>>("named-data")->value;
+    });
+
+    measure("has_data<T>() (missing)", iterations, [&] ()
+    {
+        return (int)object.has_data<bench_data_t<9>>();
+    });
+
+    measure("get_property<int>(name)", iterations, [&] ()
+    {
+        return object.get_property<int>("property").value_or(0);
+    });
+
+    return 0;
+}
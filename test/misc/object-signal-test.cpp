@@ -54,6 +54,59 @@ TEST_CASE("object base stores and releases custom data")
     REQUIRE_FALSE(object.has_data<test_data_t>());
 }
 
+TEST_CASE("typed and named custom data accessors share storage")
+{
+    test_object_t object;
+
+    auto stored = std::make_unique<test_data_t>();
+    stored->value = 5;
+    object.store_data(std::move(stored));
+
+    // Data stored by type is visible under the type's name and vice versa
+    REQUIRE(object.has_data(typeid(test_data_t).name()));
+    REQUIRE(object.get_data<test_data_t>(typeid(test_data_t).name())->value == 5);
+
+    object.store_data(std::make_unique<test_data_t>(), typeid(test_data_t).name());
+    REQUIRE(object.get_data<test_data_t>()->value == 0);
+
+    // A different type stored under the type's name is rejected by the typed accessor
+    object.store_data(std::make_unique<wf::custom_data_t>(), typeid(test_data_t).name());
+    REQUIRE(object.has_data<test_data_t>());
+    REQUIRE_FALSE(object.get_data<test_data_t>());
+
+    object.erase_data(typeid(test_data_t).name());
+    REQUIRE_FALSE(object.has_data<test_data_t>());
+
+    // Looking up names which were never used does not fail
+    REQUIRE_FALSE(object.has_data("never-stored"));
+    REQUIRE_FALSE(object.get_data<test_data_t>("never-stored"));
+    REQUIRE_FALSE(object.release_data<test_data_t>("never-stored"));
+    object.erase_data("never-stored");
+}
+
+TEST_CASE("custom data can be accessed from the destructor of other data")
+{
+    struct self_erasing_data_t : public wf::custom_data_t
+    {
+        test_object_t *object;
+        ~self_erasing_data_t()
+        {
+            object->erase_data<test_data_t>();
+            object->store_data(std::make_unique<wf::custom_data_t>(), "stored-from-destructor");
+        }
+    };
+
+    test_object_t object;
+    object.store_data(std::make_unique<test_data_t>());
+    auto data = std::make_unique<self_erasing_data_t>();
+    data->object = &object;
+    object.store_data(std::move(data));
+
+    object.erase_data<self_erasing_data_t>();
+    REQUIRE_FALSE(object.has_data<test_data_t>());
+    REQUIRE(object.has_data("stored-from-destructor"));
+}
+
 TEST_CASE("object base typed properties behave predictably")
 {
     test_object_t object;
@@ -0,0 +1,97 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "../../src/core/plugin-loader.hpp"
+
+namespace
+{
+class test_plugin_t : public wf::plugin_interface_t
+{
+  public:
+    test_plugin_t(int order_hint, std::vector<std::string> dependencies) :
+        order_hint(order_hint), dependencies(std::move(dependencies))
+    {}
+
+    void init() override
+    {}
+
+    int get_order_hint() const override
+    {
+        return order_hint;
+    }
+
+    std::vector<std::string> get_dependencies() const override
+    {
+        return dependencies;
+    }
+
+  private:
+    int order_hint;
+    std::vector<std::string> dependencies;
+};
+
+using plugin_list_t = std::vector<std::pair<std::string, wf::loaded_plugin_t>>;
+
+void add_plugin(plugin_list_t& plugins, const std::string& name, int order_hint = 0,
+    std::vector<std::string> dependencies = {})
+{
+    wf::loaded_plugin_t plugin;
+    plugin.instance  = std::make_unique<test_plugin_t>(order_hint, std::move(dependencies));
+    plugin.so_handle = nullptr;
+    plugin.so_path   = "/usr/lib/wayfire/lib" + name + ".so";
+    plugins.emplace_back(plugin.so_path, std::move(plugin));
+}
+
+std::vector<std::string> sorted_names(plugin_list_t& plugins)
+{
+    wf::sort_by_dependencies(plugins);
+    std::vector<std::string> names;
+    for (auto& [path, plugin] : plugins)
+    {
+        // lib<name>.so
+        auto file = path.substr(path.rfind('/') + 1);
+        names.push_back(file.substr(3, file.size() - 6));
+    }
+
+    return names;
+}
+}
+
+TEST_CASE("Plugins are sorted by order hint, keeping the config order otherwise")
+{
+    plugin_list_t plugins;
+    add_plugin(plugins, "expo");
+    add_plugin(plugins, "ipc", -1000);
+    add_plugin(plugins, "scale");
+
+    const std::vector<std::string> expected = {"ipc", "expo", "scale"};
+    REQUIRE(sorted_names(plugins) == expected);
+}
+
+TEST_CASE("Plugins are initialized after their dependencies")
+{
+    plugin_list_t plugins;
+    add_plugin(plugins, "scale-title-filter", 0, {"scale"});
+    add_plugin(plugins, "scale", 0, {"ipc", "not-loaded"});
+    add_plugin(plugins, "ipc", 0);
+    add_plugin(plugins, "expo");
+
+    // Dependencies take precedence over the order hint.
+    add_plugin(plugins, "early", -1000, {"expo"});
+
+    const std::vector<std::string> expected = {"ipc", "scale", "scale-title-filter", "expo", "early"};
+    REQUIRE(sorted_names(plugins) == expected);
+}
+
+TEST_CASE("Plugins in a dependency cycle are still initialized")
+{
+    plugin_list_t plugins;
+    add_plugin(plugins, "a", 0, {"b"});
+    add_plugin(plugins, "b", 0, {"a"});
+    add_plugin(plugins, "c", 0, {"a"});
+    add_plugin(plugins, "d", 0);
+
+    // d has no dependencies and goes first, then the cycle is broken in order hint order.
+    const std::vector<std::string> expected = {"d", "a", "b", "c"};
+    REQUIRE(sorted_names(plugins) == expected);
+}
@@ -0,0 +1,123 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "../../src/output/repaint-delay.hpp"
+
+namespace
+{
+constexpr int64_t REFRESH_US = 16'666;
+
+void render_frames(wf::repaint_delay_model_t& model, const std::string& plugins, int count,
+    int64_t render_us)
+{
+    for (int i = 0; i < count; i++)
+    {
+        model.start_frame(plugins, REFRESH_US, 16, 99, 1000);
+        model.frame_rendered(render_us);
+        model.frame_presented(true, REFRESH_US);
+    }
+}
+}
+
+TEST_CASE("Render time percentiles")
+{
+    wf::render_time_history_t history;
+    REQUIRE(history.percentile(99) == 0);
+
+    for (int i = 1; i <= 100; i++)
+    {
+        history.add(i);
+    }
+
+    REQUIRE(history.size() == 100);
+    REQUIRE(history.get_last() == 100);
+    REQUIRE(history.get_max() == 100);
+    REQUIRE(history.percentile(50) == 50);
+    REQUIRE(history.percentile(99) == 99);
+    REQUIRE(history.percentile(100) == 100);
+
+    // Old samples are dropped once the history is full.
+    for (size_t i = 0; i < wf::render_time_history_t::MAX_SAMPLES; i++)
+    {
+        history.add(7);
+    }
+
+    REQUIRE(history.size() == wf::render_time_history_t::MAX_SAMPLES);
+    REQUIRE(history.get_max() == 7);
+}
+
+TEST_CASE("Repaint delay is learned per set of active plugins")
+{
+    wf::repaint_delay_model_t model;
+
+    // No delay until enough frames have been measured.
+    REQUIRE(model.start_frame("", REFRESH_US, 16, 99, 1000) == 0);
+    REQUIRE(model.get_stats(99).mode == wf::repaint_delay_mode_t::LEARNING);
+    model.frame_rendered(2000);
+
+    render_frames(model, "", wf::repaint_delay_model_t::MIN_SAMPLES, 2000);
+    // 16.6ms - (2ms render + 1ms margin)
+    REQUIRE(model.start_frame("", REFRESH_US, 16, 99, 1000) == 13);
+    REQUIRE(model.get_stats(99).mode == wf::repaint_delay_mode_t::LEARNED);
+    REQUIRE(model.get_stats(99).predicted_render_us == 3000);
+    model.frame_rendered(2000);
+
+    // A plugin with expensive frames starts learning from scratch ...
+    REQUIRE(model.start_frame("expo", REFRESH_US, 16, 99, 1000) == 0);
+    model.frame_rendered(9000);
+    render_frames(model, "expo", wf::repaint_delay_model_t::MIN_SAMPLES, 9000);
+    REQUIRE(model.start_frame("expo", REFRESH_US, 16, 99, 1000) == 6);
+    model.frame_rendered(9000);
+
+    // ... and does not affect the delay of the idle desktop.
+    REQUIRE(model.start_frame("", REFRESH_US, 16, 99, 1000) == 13);
+
+    // The delay never exceeds the configured maximum.
+    REQUIRE(model.start_frame("", REFRESH_US, 5, 99, 1000) == 5);
+
+    auto stats = model.get_stats(99);
+    REQUIRE(stats.profiles.size() == 2);
+    REQUIRE(stats.profiles[0].active_plugins == "");
+    REQUIRE(stats.profiles[0].percentile_render_us == 2000);
+    REQUIRE(stats.profiles[1].active_plugins == "expo");
+    REQUIRE(stats.profiles[1].max_render_us == 9000);
+}
+
+TEST_CASE("Missed frames increase the margin")
+{
+    wf::repaint_delay_model_t model;
+    render_frames(model, "", wf::repaint_delay_model_t::MIN_SAMPLES, 2000);
+    REQUIRE(model.start_frame("", REFRESH_US, 16, 99, 1000) == 13);
+
+    for (int i = 0; i < 3; i++)
+    {
+        model.frame_presented(false, REFRESH_US);
+    }
+
+    REQUIRE(model.start_frame("", REFRESH_US, 16, 99, 1000) == 10);
+    REQUIRE(model.get_stats(99).profiles[0].missed_frames == 3);
+
+    // The penalty decays again while frames are on time.
+    render_frames(model, "", 500, 2000);
+    REQUIRE(model.start_frame("", REFRESH_US, 16, 99, 1000) == 13);
+}
+
+TEST_CASE("Least recently used profiles are dropped")
+{
+    wf::repaint_delay_model_t model;
+    render_frames(model, "", wf::repaint_delay_model_t::MIN_SAMPLES, 2000);
+    for (size_t i = 0; i < 2 * wf::repaint_delay_model_t::MAX_PROFILES; i++)
+    {
+        render_frames(model, "plugin-" + std::to_string(i), 1, 5000);
+        // The idle desktop keeps being used in between.
+        render_frames(model, "", 1, 2000);
+    }
+
+    auto stats = model.get_stats(99);
+    REQUIRE(stats.profiles.size() == wf::repaint_delay_model_t::MAX_PROFILES);
+    REQUIRE(stats.profiles[0].active_plugins == "");
+    REQUIRE(model.start_frame("", REFRESH_US, 16, 99, 1000) == 13);
+
+    // Evicted profiles start learning again.
+    REQUIRE(model.start_frame("plugin-0", REFRESH_US, 16, 99, 1000) == 0);
+}
@@ -0,0 +1,67 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <wayfire/plugins/common/workspace-wall.hpp>
+
+#include <cmath>
+
+using wall_t = wf::workspace_wall_t;
+
+namespace
+{
+const wf::dimensions_t screen = {1920, 1080};
+const wf::dimensions_t grid   = {3, 3};
+// The memory needed to keep all workspaces of the grid at full resolution, with 8-bit buffers.
+const size_t full_bytes = 4ul * 1920 * 1080 * 3 * 3;
+}
+
+TEST_CASE("background caching is disabled without a budget")
+{
+    CHECK(wall_t::compute_background_cache_scale(0, screen, 1.0, grid, 4) == 0.0);
+    CHECK(wall_t::compute_background_cache_scale(full_bytes, {0, 0}, 1.0, grid, 4) == 0.0);
+}
+
+TEST_CASE("the snapshots fit in the budget")
+{
+    // A quarter of the area of the full resolution: half the resolution in each direction.
+    CHECK(wall_t::compute_background_cache_scale(full_bytes / 4, screen, 1.0, grid, 4) ==
+        doctest::Approx(0.5));
+    CHECK(wall_t::compute_background_cache_scale(full_bytes / 16, screen, 1.0, grid, 4) ==
+        doctest::Approx(0.25));
+
+    // The budget covers physical pixels, so a scaled output gets smaller snapshots.
+    CHECK(wall_t::compute_background_cache_scale(full_bytes / 16, screen, 2.0, grid, 4) ==
+        doctest::Approx(0.125));
+}
+
+TEST_CASE("HDR snapshots use twice the memory per pixel")
+{
+    const wf::buffer_allocation_hints_t sdr_hints{.needs_alpha = false};
+    const wf::buffer_allocation_hints_t hdr_hints{.needs_alpha = false, .hdr_linear = true};
+    REQUIRE(sdr_hints.get_bytes_per_pixel() == 4);
+    REQUIRE(hdr_hints.get_bytes_per_pixel() == 8);
+
+    const size_t budget = full_bytes / 16;
+    const float sdr = wall_t::compute_background_cache_scale(budget, screen, 1.0, grid,
+        sdr_hints.get_bytes_per_pixel());
+    const float hdr = wall_t::compute_background_cache_scale(budget, screen, 1.0, grid,
+        hdr_hints.get_bytes_per_pixel());
+    CHECK(hdr == doctest::Approx(sdr / std::sqrt(2.0)));
+
+    // The HDR snapshots take as much memory as the SDR ones: the budget.
+    const double hdr_bytes = 8.0 * screen.width * screen.height * grid.width * grid.height * hdr * hdr;
+    CHECK(hdr_bytes == doctest::Approx(budget));
+}
+
+TEST_CASE("the scale of the snapshots is limited")
+{
+    // A large budget does not make snapshots sharper than they are displayed in the wall.
+    CHECK(wall_t::compute_background_cache_scale(full_bytes, screen, 1.0, grid, 4) == doctest::Approx(0.5));
+    CHECK(wall_t::compute_background_cache_scale(full_bytes * 100, screen, 1.0, grid, 4) ==
+        doctest::Approx(0.5));
+
+    // Snapshots which would be too blurry are not kept at all.
+    CHECK(wall_t::compute_background_cache_scale(full_bytes / 64, screen, 1.0, grid, 4) ==
+        doctest::Approx(0.125));
+    CHECK(wall_t::compute_background_cache_scale(full_bytes / 200, screen, 1.0, grid, 4) == 0.0);
+}
@@ -0,0 +1,285 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <wayfire/core.hpp>
+#include <wayfire/nonstd/json.hpp>
+#include <wayfire/output.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "../../support/headless-core-harness.hpp"
+#include "../../support/ipc-client.hpp"
+#include "../../support/wayland-xdg-client.hpp"
+#include "ipc-state-snapshot-format.hpp"
+
+namespace
+{
+class scoped_env_t
+{
+    std::string name;
+    std::string old_value;
+    bool had_old_value = false;
+
+  public:
+    scoped_env_t(std::string name, std::string value) : name(std::move(name))
+    {
+        if (const char *old = getenv(this->name.c_str()))
+        {
+            had_old_value = true;
+            old_value     = old;
+        }
+
+        setenv(this->name.c_str(), value.c_str(), 1);
+    }
+
+    ~scoped_env_t()
+    {
+        if (had_old_value)
+        {
+            setenv(name.c_str(), old_value.c_str(), 1);
+        } else
+        {
+            unsetenv(name.c_str());
+        }
+    }
+};
+
+struct snapshot_t
+{
+    uint64_t generation = 0;
+    wf::json_t state;
+};
+
+/**
+ * A client of the state snapshot, reading it as documented in ipc-state-snapshot-format.hpp.
+ */
+class snapshot_reader_t
+{
+    int fd;
+    void *memory = MAP_FAILED;
+    size_t mapped_size = 0;
+
+    const wf::ipc_state_snapshot_header_t *header() const
+    {
+        return static_cast<const wf::ipc_state_snapshot_header_t*>(memory);
+    }
+
+    bool map(size_t size)
+    {
+        if (memory != MAP_FAILED)
+        {
+            munmap(memory, mapped_size);
+        }
+
+        memory = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        mapped_size = (memory == MAP_FAILED) ? 0 : size;
+        return memory != MAP_FAILED;
+    }
+
+  public:
+    explicit snapshot_reader_t(int fd) : fd(fd)
+    {
+        REQUIRE(map(sizeof(wf::ipc_state_snapshot_header_t)));
+        REQUIRE(header()->magic == wf::ipc_state_snapshot_header_t::MAGIC);
+        REQUIRE(header()->format_version == wf::ipc_state_snapshot_header_t::FORMAT_VERSION);
+    }
+
+    ~snapshot_reader_t()
+    {
+        if (memory != MAP_FAILED)
+        {
+            munmap(memory, mapped_size);
+        }
+    }
+
+    snapshot_reader_t(const snapshot_reader_t&) = delete;
+    snapshot_reader_t& operator =(const snapshot_reader_t&) = delete;
+
+    /**
+     * Try to read a consistent snapshot, returns std::nullopt if the snapshot was being updated.
+     * The payload is only parsed after the sequence has been validated, so a parse error means that a torn
+     * snapshot was read.
+     */
+    std::optional<snapshot_t> try_read(bool& torn)
+    {
+        const uint32_t sequence = header()->sequence.load(std::memory_order_acquire);
+        if (sequence & 1)
+        {
+            return std::nullopt;
+        }
+
+        const size_t file_size = header()->header_size + header()->capacity;
+        if ((file_size > mapped_size) && !map(file_size))
+        {
+            return std::nullopt;
+        }
+
+        snapshot_t snapshot;
+        snapshot.generation = header()->generation;
+        const size_t payload_size = std::min<size_t>(header()->payload_size, header()->capacity);
+        std::string payload(static_cast<const char*>(memory) + header()->header_size, payload_size);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (header()->sequence.load(std::memory_order_relaxed) != sequence)
+        {
+            return std::nullopt;
+        }
+
+        torn = wf::json_t::parse_string(payload, snapshot.state).has_value();
+        return snapshot;
+    }
+
+    snapshot_t read()
+    {
+        for (int i = 0; i < 1000; i++)
+        {
+            bool torn = false;
+            if (auto snapshot = try_read(torn))
+            {
+                REQUIRE_FALSE(torn);
+                return std::move(*snapshot);
+            }
+        }
+
+        FAIL("The state snapshot was never consistent");
+        return {};
+    }
+};
+
+std::optional<std::string> find_view_title(const wf::json_t& state, uint64_t id)
+{
+    for (size_t i = 0; i < state["views"].size(); i++)
+    {
+        if (state["views"][i]["id"].as_uint64() == id)
+        {
+            return state["views"][i]["title"].as_string();
+        }
+    }
+
+    return std::nullopt;
+}
+}
+
+TEST_CASE("the IPC state snapshot can be mapped and read without round-trips")
+{
+    const auto ipc_path = (std::filesystem::temp_directory_path() /
+        ("wayfire-state-snapshot-test-" + std::to_string(getpid()) + ".socket")).string();
+    unlink(ipc_path.c_str());
+
+    scoped_env_t plugin_path{"WAYFIRE_PLUGIN_PATH", TEST_PLUGIN_PATH};
+    scoped_env_t ipc_socket{"_WAYFIRE_SOCKET", ipc_path};
+
+    wf::test::headless_core_harness_t harness{
+        "[core]\n"
+        "plugins = ipc ipc-rules\n",
+        true};
+
+    REQUIRE(harness.run_until([&] { return std::filesystem::exists(ipc_path); }));
+    wf::test::ipc_client_t ipc{ipc_path};
+
+    auto response = wf::test::call_method(harness, ipc, "window-rules/get-state-snapshot");
+    REQUIRE(response["result"].as_string() == "ok");
+    CHECK(response["format-version"].as_uint64() == wf::ipc_state_snapshot_header_t::FORMAT_VERSION);
+    CHECK(response["header-size"].as_uint64() == 64);
+    const int fd = ipc.take_received_fd();
+    REQUIRE(fd >= 0);
+
+    SUBCASE("the descriptor is sealed and read-only")
+    {
+        const int seals = fcntl(fd, F_GET_SEALS);
+        CHECK((seals & F_SEAL_SHRINK) == F_SEAL_SHRINK);
+        CHECK((seals & F_SEAL_SEAL) == F_SEAL_SEAL);
+
+        void *writable = mmap(nullptr, 4096, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        const int error = errno;
+        CHECK(writable == MAP_FAILED);
+        CHECK(error == EACCES);
+    }
+
+    SUBCASE("the snapshot follows the compositor state")
+    {
+        snapshot_reader_t reader{fd};
+        auto snapshot = reader.read();
+        CHECK(snapshot.state["views"].size() == 0);
+        REQUIRE(snapshot.state["outputs"].size() == 1);
+        CHECK(snapshot.state["outputs"][0]["id"].as_uint64() == harness.output()->get_id());
+
+        wf::test::wayland_xdg_client_t client{harness.socket_name()};
+        REQUIRE(harness.run_until([&]
+        {
+            client.dispatch_once();
+            return client.has_required_globals();
+        }));
+
+        client.create_toplevel("one", "org.wayfire.One");
+        REQUIRE(harness.run_until([&]
+        {
+            client.dispatch_once();
+            return client.has_pending_configure();
+        }));
+
+        client.attach_and_commit(100, 80);
+        REQUIRE(harness.run_until([&] { return reader.read().state["views"].size() == 1; }));
+        snapshot = reader.read();
+        const uint64_t id = snapshot.state["views"][0]["id"].as_uint64();
+        CHECK(find_view_title(snapshot.state, id) == "one");
+
+        // Read the snapshot from another thread while the compositor keeps updating it, so that the reader
+        // races with the writer. Every snapshot which passes the sequence check must be complete.
+        std::atomic<bool> done = false;
+        std::atomic<int> torn_reads = 0;
+        std::atomic<int> reads = 0;
+        std::thread racing_reader([&]
+        {
+            snapshot_reader_t concurrent{fd};
+            while (!done)
+            {
+                bool torn = false;
+                if (concurrent.try_read(torn))
+                {
+                    reads++;
+                    torn_reads += torn;
+                }
+            }
+        });
+
+        std::string title;
+        for (int i = 0; i < 50; i++)
+        {
+            // Vary the payload size, so that a torn read cannot go unnoticed.
+            title = "title-" + std::string(i * 7, 'x');
+            client.set_title(title);
+            const uint64_t generation = reader.read().generation;
+            REQUIRE(harness.run_until([&]
+            {
+                client.dispatch_once();
+                return reader.read().generation > generation;
+            }));
+        }
+
+        REQUIRE(harness.run_until([&] { return find_view_title(reader.read().state, id) == title; }));
+        done = true;
+        racing_reader.join();
+        CHECK(reads > 0);
+        CHECK(torn_reads == 0);
+
+        client.destroy_toplevel();
+        REQUIRE(harness.run_until([&]
+        {
+            client.dispatch_once();
+            return reader.read().state["views"].size() == 0;
+        }));
+    }
+
+    close(fd);
+}
@@ -0,0 +1,96 @@
+#include <wayfire/plugins/ipc/ipc-msgpack.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+/**
+ * Compares encoding and decoding IPC messages as JSON and as MessagePack. The message resembles the reply of
+ * window-rules/list-views with 300 views. Run with `meson test --benchmark`.
+ */
+namespace
+{
+template<class F>
+void measure(const char *what, int iterations, size_t message_size, F&& func)
+{
+    auto start = std::chrono::steady_clock::now();
+    size_t sum = 0;
+    for (int i = 0; i < iterations; i++)
+    {
+        sum += func();
+    }
+
+    auto elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start);
+    std::printf("%-30s %10.2f us/op %8.1f MiB/s (message %zu bytes, checksum %zu)\n", what,
+        elapsed.count() / iterations, message_size * iterations / elapsed.count() / 1.048576,
+        message_size, sum);
+}
+
+std::string make_view_list(int nr_views)
+{
+    std::string text = "[";
+    for (int i = 0; i < nr_views; i++)
+    {
+        auto id = std::to_string(i);
+        text += std::string(i ? "," : "") + R"({"id": )" + id + R"(, "pid": )" + std::to_string(1000 + i) +
+            R"(, "title": "Window )" + id + R"( - Editor", "app-id": "org.example.app)" + id + R"(",)" +
+            R"("geometry": {"x": 10, "y": 20, "width": 800, "height": 600},)" +
+            R"("bbox": {"x": 0, "y": 0, "width": 820, "height": 640},)" +
+            R"("output-id": 1, "output-name": "DP-1", "last-focus-timestamp": 123456789012,)" +
+            R"("role": "toplevel", "mapped": true, "layer": "workspace", "tiled-edges": 0,)" +
+            R"("fullscreen": false, "minimized": false, "activated": false, "sticky": false,)" +
+            R"("wset-index": 1, "min-size": {"width": 0, "height": 0}, "focusable": true,)" +
+            R"("type": "toplevel", "always-on-top": false, "opacity": 0.95})";
+    }
+
+    return text + "]";
+}
+}
+
+int main()
+{
+    constexpr int iterations = 200;
+
+    wf::json_t message;
+    if (auto err = wf::json_t::parse_string(make_view_list(300), message))
+    {
+        std::printf("Failed to parse benchmark message: %s\n", err->c_str());
+        return 1;
+    }
+
+    std::string json_text;
+    message.map_serialized([&] (const char *buffer, size_t size) { json_text.assign(buffer, size); });
+    std::string msgpack_data;
+    wf::ipc::msgpack::encode(message, msgpack_data);
+
+    measure("json serialize", iterations, json_text.size(), [&] ()
+    {
+        size_t size = 0;
+        message.map_serialized([&] (const char*, size_t len) { size = len; });
+        return size;
+    });
+
+    measure("msgpack encode", iterations, msgpack_data.size(), [&] ()
+    {
+        std::string encoded;
+        encoded.reserve(msgpack_data.size());
+        wf::ipc::msgpack::encode(message, encoded);
+        return encoded.size();
+    });
+
+    measure("json parse", iterations, json_text.size(), [&] ()
+    {
+        wf::json_t decoded;
+        wf::json_t::parse_string(json_text, decoded);
+        return decoded.size();
+    });
+
+    measure("msgpack decode", iterations, msgpack_data.size(), [&] ()
+    {
+        wf::json_t decoded;
+        wf::ipc::msgpack::decode(msgpack_data, decoded);
+        return decoded.size();
+    });
+
+    return 0;
+}
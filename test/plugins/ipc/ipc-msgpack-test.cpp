@@ -0,0 +1,97 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <wayfire/plugins/ipc/ipc-msgpack.hpp>
+
+#include <string>
+
+namespace
+{
+std::string serialize(wf::json_t json)
+{
+    std::string result;
+    json.map_serialized([&] (const char *buffer, size_t size)
+    {
+        result.assign(buffer, size);
+    });
+    return result;
+}
+
+wf::json_t parse(const std::string& text)
+{
+    wf::json_t result;
+    REQUIRE_FALSE(wf::json_t::parse_string(text, result).has_value());
+    return result;
+}
+
+std::string encode(const wf::json_t& json)
+{
+    std::string encoded;
+    wf::ipc::msgpack::encode(json, encoded);
+    return encoded;
+}
+
+void check_round_trip(const std::string& text)
+{
+    auto original = parse(text);
+    auto encoded  = encode(original);
+
+    wf::json_t decoded;
+    auto err = wf::ipc::msgpack::decode(encoded, decoded);
+    REQUIRE_FALSE(err.has_value());
+    CHECK(serialize(decoded) == serialize(original));
+}
+}
+
+TEST_CASE("MessagePack round-trips JSON values")
+{
+    check_round_trip(R"({})");
+    check_round_trip(R"([])");
+    check_round_trip(R"({"method": "window-rules/list-views", "data": {"fields": ["id", "title"]}})");
+    check_round_trip(R"({"a": null, "b": true, "c": false, "d": 1.5, "e": -0.25, "f": "text"})");
+    check_round_trip(R"([0, 127, 128, 255, 256, 65535, 65536, 4294967295, 4294967296,
+        18446744073709551615])");
+    check_round_trip(R"([-1, -32, -33, -128, -129, -32768, -32769, -2147483648, -2147483649,
+        -9223372036854775808])");
+    check_round_trip(R"({"nested": {"deeper": {"list": [[1, 2], {"x": "y"}, []]}}})");
+
+    // Strings and containers which need the wider length encodings.
+    check_round_trip("[\"" + std::string(31, 'a') + "\", \"" + std::string(32, 'b') + "\", \"" +
+        std::string(300, 'c') + "\", \"" + std::string(70000, 'd') + "\"]");
+
+    std::string long_array = "[";
+    std::string long_object = "{";
+    for (int i = 0; i < 70000; i++)
+    {
+        long_array  += (i ? ", " : "") + std::to_string(i);
+        long_object += std::string(i ? ", " : "") + "\"k" + std::to_string(i) + "\": " + std::to_string(i);
+    }
+
+    check_round_trip(long_array + "]");
+    check_round_trip(long_object + "}");
+}
+
+TEST_CASE("MessagePack uses the compact encodings")
+{
+    CHECK(encode(parse(R"({"a": 1})")) == std::string("\x81\xa1" "a\x01", 4));
+    CHECK(encode(parse(R"([true, false, null])")) == std::string("\x93\xc3\xc2\xc0", 4));
+    CHECK(encode(parse(R"([-1, 200])")) == std::string("\x92\xff\xcc\xc8", 4));
+}
+
+TEST_CASE("MessagePack rejects invalid input")
+{
+    wf::json_t out;
+    // Truncated string and integer.
+    CHECK(wf::ipc::msgpack::decode(std::string("\xa5" "abc", 4), out).has_value());
+    CHECK(wf::ipc::msgpack::decode(std::string("\xcd\x01", 2), out).has_value());
+    // Map with a non-string key.
+    CHECK(wf::ipc::msgpack::decode(std::string("\x81\x01\x02", 3), out).has_value());
+    // Array which claims more elements than the message can hold.
+    CHECK(wf::ipc::msgpack::decode(std::string("\xdd\xff\xff\xff\xff", 5), out).has_value());
+    // Binary data has no JSON equivalent.
+    CHECK(wf::ipc::msgpack::decode(std::string("\xc4\x01\x00", 3), out).has_value());
+    // Trailing data after the value.
+    CHECK(wf::ipc::msgpack::decode(std::string("\x01\x02", 2), out).has_value());
+    // Excessive nesting.
+    CHECK(wf::ipc::msgpack::decode(std::string(1000, '\x91') + std::string("\x01", 1), out).has_value());
+}
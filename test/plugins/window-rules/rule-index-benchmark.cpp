@@ -0,0 +1,91 @@
+#include "rule-index.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/**
+ * Compares finding the window rules which may apply to a new view with the rule index against trying every
+ * rule in turn. The linear scan only compares the rule's app_id, so it is a lower bound for evaluating the
+ * parsed rules. Run with `meson test --benchmark`.
+ */
+namespace
+{
+template<class F>
+void measure(const char *what, int iterations, F&& func)
+{
+    auto start = std::chrono::steady_clock::now();
+    long sum   = 0;
+    for (int i = 0; i < iterations; i++)
+    {
+        sum += func(i);
+    }
+
+    auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+    std::printf("%-40s %10.2f ns/op (checksum %ld)\n", what, elapsed.count() / iterations, sum);
+}
+
+std::string make_app_id(int i)
+{
+    return "org.example.app" + std::to_string(i);
+}
+}
+
+int main()
+{
+    constexpr int nr_rules   = 500;
+    constexpr int iterations = 200'000;
+    const char *signals[] = {"created", "maximized", "unmaximized", "minimized", "fullscreened"};
+
+    std::vector<std::string> rules;
+    for (int i = 0; i < nr_rules; i++)
+    {
+        rules.push_back(std::string("on ") + signals[i % 5] + " if app_id is \"" + make_app_id(i / 5) +
+            "\" & title contains \"Editor\" then set alpha 0.9");
+    }
+
+    // A few rules which cannot be indexed, as in a typical config.
+    rules.push_back("on created if title contains \"Picture-in-Picture\" then set always_on_top");
+    rules.push_back("on created if app_id is \"mpv\" | app_id is \"vlc\" then set alpha 1.0");
+
+    wf::windowrules::rule_index_t index;
+    std::vector<wf::windowrules::rule_key_t> keys;
+    for (size_t i = 0; i < rules.size(); i++)
+    {
+        index.add(i, rules[i]);
+        keys.push_back(wf::windowrules::analyze_rule(rules[i]));
+    }
+
+    std::vector<std::string> app_ids;
+    for (int i = 0; i < nr_rules / 5; i++)
+    {
+        app_ids.push_back(make_app_id(i));
+    }
+
+    std::vector<size_t> candidates;
+    measure("rule index lookup", iterations, [&] (int i)
+    {
+        candidates.clear();
+        index.lookup("created", [&] (wf::windowrules::indexed_property_t property)
+        {
+            return (property == wf::windowrules::indexed_property_t::APP_ID) ?
+                   app_ids[i % app_ids.size()] : std::string("Editor");
+        }, candidates);
+        return (long)candidates.size();
+    });
+
+    measure("linear scan over all rules", iterations, [&] (int i)
+    {
+        const std::string app_id = app_ids[i % app_ids.size()];
+        long matched = 0;
+        for (auto& key : keys)
+        {
+            matched += (key.signal == "created") && (!key.property || (key.value == app_id));
+        }
+
+        return matched;
+    });
+
+    return 0;
+}
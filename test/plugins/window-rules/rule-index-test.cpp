@@ -0,0 +1,102 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "rule-index.hpp"
+
+using wf::windowrules::analyze_rule;
+using wf::windowrules::indexed_property_t;
+using wf::windowrules::tokenize_rule;
+
+TEST_CASE("Rules are split into tokens")
+{
+    std::vector<std::string> tokens;
+    const std::string rule =
+        "on created if (app_id is \"foo bar\"|title contains \"x\")&!floating then maximize";
+    REQUIRE(tokenize_rule(rule, tokens));
+    const std::vector<std::string> expected = {
+        "on", "created", "if", "(", "app_id", "is", "\"foo bar\"", "|", "title", "contains", "\"x\"", ")",
+        "&", "!", "floating", "then", "maximize"
+    };
+    REQUIRE(tokens == expected);
+
+    SUBCASE("Unterminated strings are not understood")
+    {
+        tokens.clear();
+        REQUIRE_FALSE(tokenize_rule("on created if app_id is \"foo then maximize", tokens));
+    }
+
+    SUBCASE("Escaped and single-quoted strings are not understood")
+    {
+        tokens.clear();
+        REQUIRE_FALSE(tokenize_rule("on created if title is \"a \\\" b\" then maximize", tokens));
+        tokens.clear();
+        REQUIRE_FALSE(tokenize_rule("on created if title is 'a' then maximize", tokens));
+    }
+}
+
+TEST_CASE("Equality predicates are indexed")
+{
+    auto key = analyze_rule("on created if app_id is \"firefox\" then maximize");
+    REQUIRE(key.signal == "created");
+    REQUIRE(key.property == indexed_property_t::APP_ID);
+    REQUIRE(key.value == "firefox");
+
+    key = analyze_rule("on maximized if title is \"a | b\" & (floating | app_id is \"x\") then unmaximize");
+    REQUIRE(key.signal == "maximized");
+    REQUIRE(key.property == indexed_property_t::TITLE);
+    REQUIRE(key.value == "a | b");
+
+    key = analyze_rule("on created if app_id is \"foo\" and type is \"toplevel\" then maximize");
+    REQUIRE(key.property == indexed_property_t::APP_ID);
+}
+
+TEST_CASE("Conditions which do not imply the equality are not indexed")
+{
+    // The else branch also runs for other views.
+    auto key = analyze_rule("on created if app_id is \"foo\" then maximize else minimize");
+    REQUIRE(key.signal == "created");
+    REQUIRE_FALSE(key.property.has_value());
+
+    // Top-level disjunctions.
+    REQUIRE_FALSE(analyze_rule("on created if app_id is \"foo\" | title is \"bar\" then maximize").property);
+    REQUIRE_FALSE(analyze_rule("on created if app_id is \"foo\" or floating then maximize").property);
+
+    // The equality is not the first conjunct, or is nested.
+    REQUIRE_FALSE(analyze_rule("on created if floating & app_id is \"foo\" then maximize").property);
+    REQUIRE_FALSE(analyze_rule("on created if (app_id is \"foo\") then maximize").property);
+    REQUIRE_FALSE(analyze_rule("on created if !app_id is \"foo\" then maximize").property);
+
+    // Other predicates and properties.
+    REQUIRE_FALSE(analyze_rule("on created if app_id contains \"foo\" then maximize").property);
+    REQUIRE_FALSE(analyze_rule("on created if role is \"TOPLEVEL\" then maximize").property);
+}
+
+TEST_CASE("Rules which are not understood are tried for every signal")
+{
+    auto key = analyze_rule("on created if title is \"a \\\" b\" then maximize");
+    REQUIRE(key.signal.empty());
+    REQUIRE_FALSE(key.property.has_value());
+    REQUIRE(analyze_rule("").signal.empty());
+    REQUIRE(analyze_rule("maximize").signal.empty());
+
+    wf::windowrules::rule_index_t index;
+    index.add(0, "on created if title is \"a \\\" b\" then maximize");
+    index.add(1, "on created if app_id is \"foo\" then maximize");
+    index.add(2, "on maximized if app_id is \"bar\" then minimize");
+
+    auto lookup = [&] (const std::string& signal, const std::string& app_id)
+    {
+        std::vector<size_t> rules;
+        index.lookup(signal, [&] (indexed_property_t property)
+        {
+            return (property == indexed_property_t::APP_ID) ? app_id : std::string{};
+        }, rules);
+        return rules;
+    };
+
+    using ids = std::vector<size_t>;
+    REQUIRE(lookup("created", "foo") == ids({0, 1}));
+    REQUIRE(lookup("created", "bar") == ids({0}));
+    REQUIRE(lookup("maximized", "bar") == ids({0, 2}));
+    REQUIRE(lookup("minimized", "foo") == ids({0}));
+}
@@ -0,0 +1,112 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <wayfire/core.hpp>
+#include <wayfire/output.hpp>
+#include <wayfire/region.hpp>
+#include <wayfire/render.hpp>
+#include <wayfire/render-manager.hpp>
+#include <wayfire/signal-definitions.hpp>
+#include <wayfire/toplevel-view.hpp>
+
+#include <vector>
+
+#include "../support/headless-core-harness.hpp"
+#include "../support/wayland-xdg-client.hpp"
+
+TEST_CASE("damage collected by animation ticks reaches every output the view overlaps")
+{
+    wf::test::headless_core_harness_t harness;
+    auto *left = harness.output();
+    REQUIRE(left != nullptr);
+
+    // The outputs have different sizes, so that their render passes can be told apart below.
+    auto *right = harness.add_output(640, 480);
+    const auto left_geometry  = left->get_layout_geometry();
+    const auto right_geometry = right->get_layout_geometry();
+    REQUIRE(right_geometry.x == left_geometry.x + left_geometry.width);
+    REQUIRE(right_geometry.width != left_geometry.width);
+
+    wf::regionf_t left_damage;
+    wf::regionf_t right_damage;
+    wf::signal::connection_t<wf::render_pass_begin_signal> on_render_pass =
+        [&] (wf::render_pass_begin_signal *ev)
+    {
+        const auto target = ev->pass.get_target().geometry;
+        if (target.width == left_geometry.width)
+        {
+            left_damage |= ev->damage;
+        } else if (target.width == right_geometry.width)
+        {
+            right_damage |= ev->damage;
+        }
+    };
+    wf::get_core().connect(&on_render_pass);
+
+    std::vector<wayfire_view> mapped;
+    wf::signal::connection_t<wf::view_mapped_signal> on_map = [&] (wf::view_mapped_signal *ev)
+    {
+        mapped.push_back(ev->view);
+    };
+    wf::get_core().connect(&on_map);
+
+    wf::test::wayland_xdg_client_t client{harness.socket_name()};
+    REQUIRE(harness.run_until([&]
+    {
+        client.dispatch_once();
+        return client.has_required_globals();
+    }));
+
+    client.create_toplevel("animation damage test", "org.wayfire.AnimationDamageTest");
+    REQUIRE(harness.run_until([&]
+    {
+        client.dispatch_once();
+        return client.has_pending_configure();
+    }));
+
+    client.attach_and_commit(100, 80);
+    REQUIRE(harness.run_until([&] () { return mapped.size() == 1; }));
+    auto view = wf::toplevel_cast(mapped.front());
+    REQUIRE(view != nullptr);
+    REQUIRE(view->get_output() == left);
+
+    // Put the view across the edge between the outputs: 50 pixels on each of them.
+    const int x = left_geometry.width - 50;
+    view->move(x, 100);
+    const wf::geometry_t on_left  = {x, 100, 50, 80};
+    const wf::geometry_t on_right = {0, 100 + left_geometry.y - right_geometry.y, 50, 80};
+    auto covers = [] (const wf::regionf_t& damage, const wf::geometry_t& box)
+    {
+        // regionf_t::operator^ subtracts, so this is empty only if @box lies entirely inside the damage.
+        return (wf::regionf_t{box} ^ damage).empty();
+    };
+
+    // Let both outputs repaint after the move, so that only the damage of the animation is recorded below.
+    REQUIRE(harness.run_until([&]
+    {
+        client.dispatch_once();
+        return covers(left_damage, on_left) && covers(right_damage, on_right);
+    }));
+    for (int i = 0; i < 5; i++)
+    {
+        harness.dispatch_once(20);
+    }
+
+    left_damage.clear();
+    right_damage.clear();
+
+    // Damage the view the same way as the animate plugin: through the damage collected during the tick.
+    bool ticked = false;
+    wf::animation_tick_t tick = [&] (const wf::animation_frame_t& frame)
+    {
+        REQUIRE(frame.damage != nullptr);
+        *frame.damage |= view->get_transformed_node()->get_bounding_box();
+        ticked = true;
+        return false;
+    };
+    left->render->add_animation(&tick);
+
+    REQUIRE(harness.run_until([&] { return ticked && covers(left_damage, on_left); }));
+    CHECK(harness.run_until([&] { return covers(right_damage, on_right); }));
+    left->render->rem_animation(&tick);
+}
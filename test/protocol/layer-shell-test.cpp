@@ -13,9 +13,12 @@
 
 namespace
 {
+constexpr uint32_t LAYER_TOP     = 2;
 constexpr uint32_t LAYER_OVERLAY = 3;
 constexpr uint32_t LAYER_KEYBOARD_NONE = 0;
+constexpr uint32_t LAYER_ANCHOR_TOP    = 1;
 constexpr uint32_t LAYER_ANCHOR_BOTTOM = 2;
+constexpr uint32_t LAYER_ANCHOR_LEFT   = 4;
 constexpr uint32_t LAYER_ANCHOR_RIGHT  = 8;
 }
 
@@ -97,3 +100,86 @@ TEST_CASE("layer-shell popup with keyboard none does not steal focus")
 
     CHECK(wf::get_core().seat->get_active_view() == focused_view);
 }
+
+TEST_CASE("layer-shell surfaces are configured only when their layout changes")
+{
+    wf::test::headless_core_harness_t harness;
+
+    std::vector<wayfire_view> mapped;
+    wf::signal::connection_t<wf::view_mapped_signal> on_map = [&] (wf::view_mapped_signal *ev)
+    {
+        mapped.push_back(ev->view);
+    };
+
+    wf::get_core().connect(&on_map);
+
+    wf::test::wayland_layer_shell_client_t panel{harness.socket_name()};
+    wf::test::wayland_layer_shell_client_t widget{harness.socket_name()};
+    auto dispatch = [&]
+    {
+        panel.dispatch_once();
+        widget.dispatch_once();
+    };
+
+    REQUIRE(harness.run_until([&]
+    {
+        dispatch();
+        return panel.has_required_globals() && widget.has_required_globals();
+    }));
+
+    auto map_layer = [&] (wf::test::wayland_layer_shell_client_t& client, const std::string& name,
+                          int width, int height, uint32_t anchor)
+    {
+        const size_t nr_mapped = mapped.size();
+        client.create_layer_surface(name, LAYER_TOP, LAYER_KEYBOARD_NONE, width, height, anchor);
+        REQUIRE(harness.run_until([&]
+        {
+            dispatch();
+            return client.has_pending_layer_configure();
+        }));
+
+        client.attach_layer_and_commit((width > 0) ? width : 100, height);
+        REQUIRE(harness.run_until([&]
+        {
+            dispatch();
+            return mapped.size() == nr_mapped + 1;
+        }));
+    };
+
+    // A full-width panel at the top, and a widget placed below whatever area the panel reserves.
+    map_layer(panel, "regression-layer-shell-panel", 0, 30,
+        LAYER_ANCHOR_TOP | LAYER_ANCHOR_LEFT | LAYER_ANCHOR_RIGHT);
+    map_layer(widget, "regression-layer-shell-widget", 100, 40, LAYER_ANCHOR_TOP);
+    auto widget_view = mapped.back();
+    auto settle = [&]
+    {
+        for (int i = 0; i < 10; i++)
+        {
+            harness.roundtrip();
+            dispatch();
+        }
+    };
+    settle();
+
+    const int panel_configures  = panel.layer_configure_count();
+    const int widget_configures = widget.layer_configure_count();
+    REQUIRE(widget_view->get_bounding_box().y == 0);
+
+    // Re-sending the same state does not change the layout, so nobody is configured again.
+    panel.set_layer_size(0, 30);
+    panel.commit_layer();
+    settle();
+    CHECK(panel.layer_configure_count() == panel_configures);
+    CHECK(widget.layer_configure_count() == widget_configures);
+
+    // Reserving space for the panel moves the widget down.
+    panel.set_exclusive_zone(30);
+    panel.commit_layer();
+    REQUIRE(harness.run_until([&]
+    {
+        dispatch();
+        return widget.layer_configure_count() > widget_configures;
+    }));
+
+    CHECK(widget_view->get_bounding_box().y == 30);
+}
@@ -0,0 +1,221 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <wayfire/core.hpp>
+#include <wayfire/output.hpp>
+#include <wayfire/render-manager.hpp>
+#include <wayfire/scene.hpp>
+#include <wayfire/scene-operations.hpp>
+#include <wayfire/scene-render.hpp>
+#include <wayfire/signal-definitions.hpp>
+#include <wayfire/toplevel-view.hpp>
+#include <wayfire/view-transform.hpp>
+
+#include "../support/headless-core-harness.hpp"
+#include "../support/wayland-xdg-client.hpp"
+
+namespace
+{
+/**
+ * A node which fills a rectangle with a solid color, and counts how often it was drawn.
+ */
+class rect_node_t : public wf::scene::node_t
+{
+  public:
+    rect_node_t(wf::geometry_t box, wf::color_t color, bool report_opaque) :
+        node_t(false), box(box), color(color), report_opaque(report_opaque)
+    {}
+
+    wf::geometry_t box;
+    wf::color_t color;
+    bool report_opaque;
+    int rendered = 0;
+
+    class instance_t : public wf::scene::render_instance_t
+    {
+        rect_node_t *self;
+
+      public:
+        instance_t(rect_node_t *self) : self(self)
+        {}
+
+        void schedule_instructions(std::vector<wf::scene::render_instruction_t>& instructions,
+            const wf::render_target_t& target, wf::regionf_t& damage) override
+        {
+            auto our_damage = damage & self->box;
+            if (!our_damage.empty())
+            {
+                instructions.push_back(wf::scene::render_instruction_t{
+                    .instance = this,
+                    .target   = target,
+                    .damage   = std::move(our_damage),
+                    .opaque_region = self->report_opaque ? wf::regionf_t{self->box} : wf::regionf_t{},
+                });
+            }
+        }
+
+        void render(const wf::scene::render_instruction_t& data) override
+        {
+            self->rendered++;
+            data.pass->add_rect(self->color, data.target, self->box, data.damage);
+        }
+    };
+
+    void gen_render_instances(std::vector<wf::scene::render_instance_uptr>& instances,
+        wf::scene::damage_callback push_damage, wf::output_t *output) override
+    {
+        instances.push_back(std::make_unique<instance_t>(this));
+    }
+
+    wf::geometry_t get_bounding_box() override
+    {
+        return box;
+    }
+};
+
+struct scene_t
+{
+    std::shared_ptr<rect_node_t> top;
+    std::shared_ptr<rect_node_t> bottom;
+
+    scene_t(wf::output_t *output, wf::geometry_t top_box, bool top_opaque)
+    {
+        top    = std::make_shared<rect_node_t>(top_box, wf::color_t{0, 0, 1, 1}, top_opaque);
+        bottom = std::make_shared<rect_node_t>(wf::geometry_t{100, 100, 50, 50},
+            wf::color_t{1, 0, 0, 1}, true);
+        wf::scene::add_front(output->node_for_layer(wf::scene::layer::WORKSPACE), bottom);
+        wf::scene::add_front(output->node_for_layer(wf::scene::layer::TOP), top);
+        output->render->damage_whole();
+    }
+
+    ~scene_t()
+    {
+        wf::scene::remove_child(top);
+        wf::scene::remove_child(bottom);
+    }
+};
+
+/**
+ * Map a 100x80 toplevel at (100, 100). Its buffer has no alpha channel, so the whole view is opaque.
+ */
+wayfire_toplevel_view map_opaque_view(wf::test::headless_core_harness_t& harness,
+    wf::test::wayland_xdg_client_t& client)
+{
+    std::vector<wayfire_view> mapped;
+    wf::signal::connection_t<wf::view_mapped_signal> on_map = [&] (wf::view_mapped_signal *ev)
+    {
+        mapped.push_back(ev->view);
+    };
+    wf::get_core().connect(&on_map);
+
+    REQUIRE(harness.run_until([&]
+    {
+        client.dispatch_once();
+        return client.has_required_globals();
+    }));
+
+    client.create_toplevel("occlusion test", "org.wayfire.OcclusionTest");
+    REQUIRE(harness.run_until([&]
+    {
+        client.dispatch_once();
+        return client.has_pending_configure();
+    }));
+
+    client.attach_and_commit(100, 80);
+    REQUIRE(harness.run_until([&] () { return mapped.size() == 1; }));
+
+    auto view = wf::toplevel_cast(mapped.front());
+    REQUIRE(view != nullptr);
+    view->move(100, 100);
+    REQUIRE(harness.run_until([&]
+    {
+        client.dispatch_once();
+        return view->get_geometry().x == 100 && view->get_geometry().y == 100;
+    }));
+
+    return view;
+}
+}
+
+TEST_CASE("instructions hidden below opaque instructions are culled")
+{
+    wf::test::headless_core_harness_t harness;
+    auto *output = harness.output();
+    REQUIRE(output != nullptr);
+
+    scene_t scene{output, {50, 50, 200, 200}, true};
+    harness.capture_output([&] (const wf::test::output_frame_t& frame)
+    {
+        CHECK(frame.pixel(120, 120) == 0xffff0000u);
+    });
+
+    CHECK(scene.top->rendered >= 1);
+    CHECK(scene.bottom->rendered == 0);
+    CHECK(output->render->get_occlusion_stats().last_frame_culled >= 1);
+}
+
+TEST_CASE("partially covered and translucent content is not culled")
+{
+    wf::test::headless_core_harness_t harness;
+    auto *output = harness.output();
+    REQUIRE(output != nullptr);
+
+    SUBCASE("partially covered")
+    {
+        scene_t scene{output, {120, 120, 200, 200}, true};
+        harness.capture_output([&] (const wf::test::output_frame_t& frame)
+        {
+            CHECK(frame.pixel(110, 110) == 0xff0000ffu);
+        });
+
+        CHECK(scene.bottom->rendered == 1);
+    }
+
+    SUBCASE("no opaque region")
+    {
+        scene_t scene{output, {50, 50, 200, 200}, false};
+        harness.capture_output([] (const wf::test::output_frame_t&) {});
+        CHECK(scene.bottom->rendered == 1);
+        CHECK(output->render->get_occlusion_stats().last_frame_culled == 0);
+    }
+}
+
+TEST_CASE("content below a view with a 2D transform is culled only while the view is opaque")
+{
+    wf::test::headless_core_harness_t harness;
+    auto *output = harness.output();
+    REQUIRE(output != nullptr);
+
+    wf::test::wayland_xdg_client_t client{harness.socket_name()};
+    auto view = map_opaque_view(harness, client);
+
+    // Scaled around the view's center, the view covers (90, 92) to (210, 188).
+    auto transformer = std::make_shared<wf::scene::view_2d_transformer_t>(view);
+    transformer->scale_x = 1.2f;
+    transformer->scale_y = 1.2f;
+    view->get_transformed_node()->add_transformer(transformer, wf::TRANSFORMER_2D, "occlusion-test");
+
+    auto bottom = std::make_shared<rect_node_t>(wf::geometry_t{120, 110, 60, 50},
+        wf::color_t{1, 0, 0, 1}, true);
+    wf::scene::add_front(output->node_for_layer(wf::scene::layer::BACKGROUND), bottom);
+
+    SUBCASE("opaque")
+    {
+        output->render->damage_whole();
+        harness.capture_output([] (const wf::test::output_frame_t&) {});
+        CHECK(bottom->rendered == 0);
+        CHECK(output->render->get_occlusion_stats().last_frame_culled >= 1);
+    }
+
+    SUBCASE("translucent")
+    {
+        transformer->alpha = 0.5f;
+        output->render->damage_whole();
+        harness.capture_output([] (const wf::test::output_frame_t&) {});
+        CHECK(bottom->rendered >= 1);
+        CHECK(output->render->get_occlusion_stats().last_frame_culled == 0);
+    }
+
+    wf::scene::remove_child(bottom);
+    view->get_transformed_node()->rem_transformer(transformer);
+}
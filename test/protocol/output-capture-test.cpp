@@ -0,0 +1,104 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <wayfire/core.hpp>
+#include <wayfire/output.hpp>
+#include <wayfire/region.hpp>
+#include <wayfire/signal-definitions.hpp>
+#include <wayfire/toplevel-view.hpp>
+
+#include <vector>
+
+#include "../support/headless-core-harness.hpp"
+#include "../support/wayland-xdg-client.hpp"
+
+static wf::region_t damage_of(const wf::test::output_frame_t& frame)
+{
+    wf::region_t damage;
+    for (auto& box : frame.damage)
+    {
+        damage |= box;
+    }
+
+    return damage;
+}
+
+// The renderer may damage more than the minimum (for example whole outputs on the first frame), so tests
+// only require that the reported damage covers the expected box.
+static bool damage_covers(const wf::test::output_frame_t& frame, const wlr_box& box)
+{
+    // region_t::operator^ subtracts, so this is empty only if @box lies entirely inside the damage.
+    return (wf::region_t{box} ^ damage_of(frame)).empty();
+}
+
+TEST_CASE("output capture reports damage since the previous capture")
+{
+    wf::test::headless_core_harness_t harness;
+    auto *output = harness.output();
+    REQUIRE(output != nullptr);
+
+    const wlr_box full = {0, 0, output->handle->width, output->handle->height};
+    harness.capture_output([&] (const wf::test::output_frame_t& frame)
+    {
+        CHECK(frame.width == full.width);
+        CHECK(frame.height == full.height);
+        CHECK(damage_covers(frame, full));
+        CHECK(frame.pixel(10, 10) == 0xff000000u);
+    });
+
+    harness.roundtrip();
+    harness.capture_output([&] (const wf::test::output_frame_t& frame)
+    {
+        CHECK(frame.damage.empty());
+        CHECK(frame.pixel(10, 10) == 0xff000000u);
+    });
+}
+
+TEST_CASE("output capture damage covers a newly mapped surface")
+{
+    wf::test::headless_core_harness_t harness;
+    harness.capture_output([] (const wf::test::output_frame_t&) {});
+
+    std::vector<wayfire_view> mapped;
+    wf::signal::connection_t<wf::view_mapped_signal> on_map = [&] (wf::view_mapped_signal *ev)
+    {
+        mapped.push_back(ev->view);
+    };
+    wf::get_core().connect(&on_map);
+
+    wf::test::wayland_xdg_client_t client{harness.socket_name()};
+    REQUIRE(harness.run_until([&]
+    {
+        client.dispatch_once();
+        return client.has_required_globals();
+    }));
+
+    client.create_toplevel("capture test", "org.wayfire.CaptureTest");
+    REQUIRE(harness.run_until([&]
+    {
+        client.dispatch_once();
+        return client.has_pending_configure();
+    }));
+
+    const int width  = 100;
+    const int height = 80;
+    client.attach_and_commit(width, height, std::vector<uint32_t>(width * height, 0x00ff0000u));
+    REQUIRE(harness.run_until([&] () { return mapped.size() == 1; }));
+
+    auto view = wf::toplevel_cast(mapped.front());
+    REQUIRE(view != nullptr);
+    view->move(100, 100);
+    REQUIRE(harness.run_until([&]
+    {
+        client.dispatch_once();
+        return view->get_geometry().x == 100 && view->get_geometry().y == 100;
+    }));
+
+    harness.capture_output([&] (const wf::test::output_frame_t& frame)
+    {
+        const wlr_box box = {100, 100, width, height};
+        CHECK(damage_covers(frame, box));
+        CHECK(frame.pixel(150, 140) == 0xff0000ffu);
+        CHECK(frame.pixel(10, 10) == 0xff000000u);
+    });
+}
@@ -0,0 +1,232 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <wayfire/core.hpp>
+#include <wayfire/opengl.hpp>
+#include <wayfire/output.hpp>
+#include <wayfire/render-manager.hpp>
+#include <wayfire/signal-definitions.hpp>
+#include <wayfire/toplevel-view.hpp>
+
+#include <string>
+#include <vector>
+
+#include "../support/headless-core-harness.hpp"
+#include "../support/wayland-xdg-client.hpp"
+
+namespace
+{
+const char *vertex_shader =
+    R"(
+#version 100
+
+attribute highp vec2 position;
+attribute highp vec2 uvPosition;
+
+varying highp vec2 uvpos;
+
+void main() {
+    gl_Position = vec4(position.xy, 0.0, 1.0);
+    uvpos = uvPosition;
+}
+)";
+
+/**
+ * A per-pixel post hook with a shader snippet, like invert. When it is not fused, the hook itself runs the
+ * snippet in a program of its own.
+ */
+struct snippet_hook_t
+{
+    std::string source;
+    std::string function;
+    std::function<void(OpenGL::program_t&)> set_uniforms;
+
+    OpenGL::program_t program;
+    int calls = 0;
+
+    wf::post_hook_t hook = [=] (wf::auxilliary_buffer_t& buffer, const wf::render_buffer_t& destination)
+    {
+        ++calls;
+        render(buffer, destination);
+    };
+
+    wf::post_hook_options_t options(bool fusable)
+    {
+        wf::post_hook_options_t options;
+        options.per_pixel = true;
+        if (fusable)
+        {
+            options.shader_source   = source;
+            options.shader_function = function;
+            options.set_uniforms    = set_uniforms;
+        }
+
+        return options;
+    }
+
+    void render(wf::auxilliary_buffer_t& buffer, const wf::render_buffer_t& destination)
+    {
+        static const float vertex_data[] = {
+            -1.0f, -1.0f,
+            1.0f, -1.0f,
+            1.0f, 1.0f,
+            -1.0f, 1.0f
+        };
+
+        static const float coord_data[] = {
+            0.0f, 0.0f,
+            1.0f, 0.0f,
+            1.0f, 1.0f,
+            0.0f, 1.0f
+        };
+
+        wf::gles::run_in_context([&]
+        {
+            if (program.get_program_id(wf::TEXTURE_TYPE_RGBA) == 0)
+            {
+                // The same program as the render manager builds for a fused stage, with a single snippet.
+                std::string fragment = "#version 100\n@builtin_ext@\n@builtin@\n\n";
+                fragment += "varying highp vec2 uvpos;\n\n" + source + "\n";
+                fragment += "void main()\n{\n    gl_FragColor = " + function + "(get_pixel(uvpos));\n}\n";
+                program.compile(vertex_shader, fragment);
+            }
+
+            auto texture = wf::gles_texture_t::from_aux(buffer);
+            texture.invert_y = false;
+
+            wf::gles::bind_render_buffer(destination);
+            program.use(wf::TEXTURE_TYPE_RGBA);
+            program.set_active_texture(texture);
+            program.attrib_pointer("position", 2, 0, vertex_data);
+            program.attrib_pointer("uvPosition", 2, 0, coord_data);
+            if (set_uniforms)
+            {
+                set_uniforms(program);
+            }
+
+            GL_CALL(glDisable(GL_BLEND));
+            GL_CALL(glDrawArrays(GL_TRIANGLE_FAN, 0, 4));
+            GL_CALL(glEnable(GL_BLEND));
+            GL_CALL(glBindTexture(GL_TEXTURE_2D, 0));
+            program.deactivate();
+        });
+    }
+
+    ~snippet_hook_t()
+    {
+        wf::gles::run_in_context_if_gles([&]
+        {
+            program.free_resources();
+        });
+    }
+};
+}
+
+TEST_CASE("fused post hooks give the same pixels as running them one by one")
+{
+    if (!wf::test::headless_core_harness_t::gles2_available())
+    {
+        MESSAGE("Skipped: post hooks are only fused with the GLES2 renderer, which is not available");
+        return;
+    }
+
+    wf::test::headless_core_harness_t harness{{}, false, wf::test::harness_renderer_t::GLES2};
+    auto *output = harness.output();
+    REQUIRE(output != nullptr);
+    REQUIRE(wf::get_core().is_gles2());
+
+    std::vector<wayfire_view> mapped;
+    wf::signal::connection_t<wf::view_mapped_signal> on_map = [&] (wf::view_mapped_signal *ev)
+    {
+        mapped.push_back(ev->view);
+    };
+    wf::get_core().connect(&on_map);
+
+    // A gradient, so that every channel takes many different values.
+    wf::test::wayland_xdg_client_t client{harness.socket_name()};
+    REQUIRE(harness.run_until([&]
+    {
+        client.dispatch_once();
+        return client.has_required_globals();
+    }));
+
+    client.create_toplevel("post fusion test", "org.wayfire.PostFusionTest");
+    REQUIRE(harness.run_until([&]
+    {
+        client.dispatch_once();
+        return client.has_pending_configure();
+    }));
+
+    const int width  = 256;
+    const int height = 128;
+    std::vector<uint32_t> gradient(width * height);
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            gradient[y * width + x] = (x << 16) | ((y * 2) << 8) | ((x + y) & 0xff);
+        }
+    }
+
+    client.attach_and_commit(width, height, gradient);
+    REQUIRE(harness.run_until([&] () { return mapped.size() == 1; }));
+    auto view = wf::toplevel_cast(mapped.front());
+    REQUIRE(view != nullptr);
+    view->move(10, 10);
+    REQUIRE(harness.run_until([&]
+    {
+        client.dispatch_once();
+        return view->get_geometry().x == 10;
+    }));
+
+    const auto unprocessed = harness.capture_output_pixels();
+
+    // Two effects which do not commute, and which are exact in 8 bits per channel, so that running them in
+    // separate passes loses no precision compared to one pass.
+    snippet_hook_t invert_red;
+    invert_red.source   = "uniform highp float test_red_max;\n"
+                          "highp vec4 test_invert_red(highp vec4 c)\n"
+                          "{\n    return vec4(test_red_max - c.r, c.g, c.b, c.a);\n}\n";
+    invert_red.function = "test_invert_red";
+    invert_red.set_uniforms = [] (OpenGL::program_t& program)
+    {
+        program.uniform1f("test_red_max", 1.0f);
+    };
+
+    snippet_hook_t rotate;
+    rotate.source   = "highp vec4 test_rotate(highp vec4 c)\n{\n    return c.gbra;\n}\n";
+    rotate.function = "test_rotate";
+
+    auto run_chain = [&] (bool fusable)
+    {
+        invert_red.calls = 0;
+        rotate.calls     = 0;
+        output->render->add_post(&invert_red.hook, invert_red.options(fusable));
+        output->render->add_post(&rotate.hook, rotate.options(fusable));
+        auto pixels = harness.capture_output_pixels();
+        output->render->rem_post(&invert_red.hook);
+        output->render->rem_post(&rotate.hook);
+        return pixels;
+    };
+
+    const auto separate = run_chain(false);
+    CHECK(invert_red.calls > 0);
+    CHECK(rotate.calls > 0);
+
+    const auto fused = run_chain(true);
+    // Fused hooks run as a single pass of the render manager, the hooks themselves are not called.
+    CHECK(invert_red.calls == 0);
+    CHECK(rotate.calls == 0);
+
+    REQUIRE(fused.size() == unprocessed.size());
+    REQUIRE(separate.size() == unprocessed.size());
+    CHECK(fused != unprocessed);
+
+    int mismatches = 0;
+    for (size_t i = 0; i < fused.size(); i++)
+    {
+        mismatches += (fused[i] != separate[i]);
+    }
+
+    CHECK(mismatches == 0);
+}
@@ -0,0 +1,121 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <wayfire/config/option.hpp>
+#include <wayfire/core.hpp>
+#include <wayfire/matcher.hpp>
+#include <wayfire/signal-definitions.hpp>
+#include <wayfire/toplevel-view.hpp>
+#include <wayfire/window-manager.hpp>
+
+#include <vector>
+
+#include "../support/headless-core-harness.hpp"
+#include "../support/wayland-xdg-client.hpp"
+
+namespace
+{
+std::shared_ptr<wf::config::option_t<std::string>> make_condition(const std::string& condition)
+{
+    return std::make_shared<wf::config::option_t<std::string>>("test/condition", condition);
+}
+
+wayfire_toplevel_view map_view(wf::test::headless_core_harness_t& harness,
+    wf::test::wayland_xdg_client_t& client)
+{
+    std::vector<wayfire_view> mapped;
+    wf::signal::connection_t<wf::view_mapped_signal> on_map = [&] (wf::view_mapped_signal *ev)
+    {
+        mapped.push_back(ev->view);
+    };
+    wf::get_core().connect(&on_map);
+
+    REQUIRE(harness.run_until([&]
+    {
+        client.dispatch_once();
+        return client.has_required_globals();
+    }));
+
+    client.create_toplevel("one", "org.wayfire.One");
+    REQUIRE(harness.run_until([&]
+    {
+        client.dispatch_once();
+        return client.has_pending_configure();
+    }));
+
+    client.attach_and_commit(100, 80);
+    REQUIRE(harness.run_until([&] () { return mapped.size() == 1; }));
+
+    auto view = wf::toplevel_cast(mapped.front());
+    REQUIRE(view != nullptr);
+    return view;
+}
+}
+
+TEST_CASE("cached matcher results are invalidated when the view changes")
+{
+    wf::test::headless_core_harness_t harness;
+    wf::test::wayland_xdg_client_t client{harness.socket_name()};
+    auto view = map_view(harness, client);
+
+    SUBCASE("title")
+    {
+        wf::view_matcher_t matcher{make_condition("title is \"one\"")};
+        CHECK(matcher.matches(view));
+
+        const auto before = wf::view_matcher_t::get_cache_stats();
+        CHECK(matcher.matches(view));
+        CHECK(wf::view_matcher_t::get_cache_stats().hits == before.hits + 1);
+
+        client.set_title("two");
+        REQUIRE(harness.run_until([&] () { return view->get_title() == "two"; }));
+        CHECK_FALSE(matcher.matches(view));
+        CHECK(wf::view_matcher_t::get_cache_stats().misses == before.misses + 1);
+    }
+
+    SUBCASE("app id")
+    {
+        wf::view_matcher_t matcher{make_condition("app_id is \"org.wayfire.One\"")};
+        CHECK(matcher.matches(view));
+
+        client.set_app_id("org.wayfire.Two");
+        REQUIRE(harness.run_until([&] () { return view->get_app_id() == "org.wayfire.Two"; }));
+        CHECK_FALSE(matcher.matches(view));
+    }
+
+    SUBCASE("minimized state")
+    {
+        wf::view_matcher_t matcher{make_condition("minimized")};
+        CHECK_FALSE(matcher.matches(view));
+
+        wf::get_core().default_wm->minimize_request(view, true);
+        REQUIRE(view->minimized);
+        CHECK(matcher.matches(view));
+
+        wf::get_core().default_wm->minimize_request(view, false);
+        CHECK_FALSE(matcher.matches(view));
+    }
+
+    SUBCASE("properties which are not tracked by signals")
+    {
+        wf::view_matcher_t matcher{make_condition("fullscreen")};
+        CHECK_FALSE(matcher.matches(view));
+
+        wf::get_core().default_wm->fullscreen_request(view, view->get_output(), true);
+        CHECK(matcher.matches(view));
+    }
+}
+
+TEST_CASE("cached results of a changed condition are not reused")
+{
+    wf::test::headless_core_harness_t harness;
+    wf::test::wayland_xdg_client_t client{harness.socket_name()};
+    auto view = map_view(harness, client);
+
+    auto condition = make_condition("title is \"one\"");
+    wf::view_matcher_t matcher{condition};
+    CHECK(matcher.matches(view));
+
+    condition->set_value("title is \"two\"");
+    CHECK_FALSE(matcher.matches(view));
+}
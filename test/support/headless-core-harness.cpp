@@ -9,9 +9,14 @@
 #include <stdexcept>
 #include <chrono>
 #include <array>
+#include <cstring>
 #include <vector>
 
 #include <drm_fourcc.h>
+#include <fcntl.h>
+#include <linux/dma-buf.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
@@ -121,6 +126,117 @@ static std::string ensure_test_runtime_dir()
     setenv("XDG_RUNTIME_DIR", runtime_dir.data(), 1);
     return runtime_dir.data();
 }
+
+static std::vector<uint32_t> read_buffer_pixels(wlr_renderer *renderer, wlr_buffer *buffer)
+{
+    auto *tex = wlr_texture_from_buffer(renderer, buffer);
+    if (!tex)
+    {
+        throw std::runtime_error("Failed to create texture from output buffer");
+    }
+
+    std::vector<uint32_t> pixels(tex->width * tex->height);
+    wlr_texture_read_pixels_options opts{};
+    opts.data   = pixels.data();
+    opts.format = DRM_FORMAT_ABGR8888;
+    opts.stride = tex->width * 4;
+    if (!wlr_texture_read_pixels(tex, &opts))
+    {
+        wlr_texture_destroy(tex);
+        throw std::runtime_error("Failed to read output pixels");
+    }
+
+    wlr_texture_destroy(tex);
+    return pixels;
+}
+
+/* Create a GLES2 renderer on the first DRM render node which supports it, or return nullptr. */
+static wlr_renderer *create_gles2_renderer()
+{
+#if WLR_HAS_GLES2_RENDERER
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator("/dev/dri", ec))
+    {
+        if (entry.path().filename().string().rfind("renderD", 0) != 0)
+        {
+            continue;
+        }
+
+        int fd = open(entry.path().c_str(), O_RDWR | O_CLOEXEC);
+        if (fd < 0)
+        {
+            continue;
+        }
+
+        // The renderer keeps its own duplicate of the fd.
+        auto *renderer = wlr_gles2_renderer_create_with_drm_fd(fd);
+        close(fd);
+        if (renderer)
+        {
+            return renderer;
+        }
+    }
+#endif
+
+    return nullptr;
+}
+
+/* Formats which output_frame_t::pixel() can convert without a copy. */
+static bool is_mappable_format(uint32_t format)
+{
+    return (format == DRM_FORMAT_ABGR8888) || (format == DRM_FORMAT_XBGR8888) ||
+           (format == DRM_FORMAT_ARGB8888) || (format == DRM_FORMAT_XRGB8888);
+}
+
+/**
+ * Map a linear single-plane dmabuf for reading, and call @use with the mapping.
+ * Returns false if the buffer is not such a dmabuf.
+ */
+static bool with_mapped_dmabuf(wlr_buffer *buffer,
+    const std::function<void(const uint8_t*, uint32_t, size_t)>& use)
+{
+    wlr_dmabuf_attributes attribs;
+    if (!wlr_buffer_get_dmabuf(buffer, &attribs) || (attribs.n_planes != 1) ||
+        (attribs.modifier != DRM_FORMAT_MOD_LINEAR) || !is_mappable_format(attribs.format))
+    {
+        return false;
+    }
+
+    const size_t length = attribs.offset[0] + (size_t)attribs.stride[0] * attribs.height;
+    void *map = mmap(nullptr, length, PROT_READ, MAP_SHARED, attribs.fd[0], 0);
+    if (map == MAP_FAILED)
+    {
+        return false;
+    }
+
+    dma_buf_sync sync{};
+    sync.flags = DMA_BUF_SYNC_START | DMA_BUF_SYNC_READ;
+    ioctl(attribs.fd[0], DMA_BUF_IOCTL_SYNC, &sync);
+    use((const uint8_t*)map + attribs.offset[0], attribs.format, attribs.stride[0]);
+    sync.flags = DMA_BUF_SYNC_END | DMA_BUF_SYNC_READ;
+    ioctl(attribs.fd[0], DMA_BUF_IOCTL_SYNC, &sync);
+
+    munmap(map, length);
+    return true;
+}
+}
+
+uint32_t wf::test::output_frame_t::pixel(int x, int y) const
+{
+    uint32_t value;
+    std::memcpy(&value, data + y * stride + x * 4, sizeof(value));
+    if ((format == DRM_FORMAT_ARGB8888) || (format == DRM_FORMAT_XRGB8888))
+    {
+        // Swap red and blue to get ABGR8888.
+        value = (value & 0xff00ff00u) | ((value & 0xffu) << 16) | ((value >> 16) & 0xffu);
+    }
+
+    if ((format == DRM_FORMAT_XRGB8888) || (format == DRM_FORMAT_XBGR8888))
+    {
+        value |= 0xff000000u;
+    }
+
+    return value;
 }
 
 struct wf::test::headless_core_harness_t::impl
@@ -138,33 +254,10 @@ struct wf::test::headless_core_harness_t::impl
         std::optional<std::vector<uint32_t>> captured_pixels;
         wf::post_hook_t capture_hook = [&] (wf::auxilliary_buffer_t& source, const wf::render_buffer_t&)
         {
-            auto framebuffer = source.get_renderbuffer();
-            auto *buffer     = framebuffer.get_buffer();
-            if (!buffer)
+            if (auto *buffer = source.get_buffer())
             {
-                return;
+                captured_pixels = read_buffer_pixels(core->renderer, buffer);
             }
-
-            auto *tex = wlr_texture_from_buffer(core->renderer, buffer);
-            if (!tex)
-            {
-                throw std::runtime_error("Failed to create texture from output buffer");
-            }
-
-            auto size = framebuffer.get_size();
-            std::vector<uint32_t> pixels(size.width * size.height);
-            wlr_texture_read_pixels_options opts{};
-            opts.data   = pixels.data();
-            opts.format = DRM_FORMAT_ABGR8888;
-            opts.stride = size.width * 4;
-            if (!wlr_texture_read_pixels(tex, &opts))
-            {
-                wlr_texture_destroy(tex);
-                throw std::runtime_error("Failed to read output pixels");
-            }
-
-            wlr_texture_destroy(tex);
-            captured_pixels = std::move(pixels);
         };
 
         wo->render->add_post(&capture_hook);
@@ -184,9 +277,157 @@ struct wf::test::headless_core_harness_t::impl
 
         return *captured_pixels;
     }
+
+    /* State of capture_output(), set up on first use. */
+    wf::output_t *tracked_output = nullptr;
+    wf::region_t damage_since_capture;
+    // The post-hook source buffer which holds the last complete frame, locked.
+    wlr_buffer *last_frame = nullptr;
+    uint64_t nr_paints     = 0;
+
+    // Passes the frame through unchanged and records which parts of it were repainted.
+    wf::post_hook_t track_damage = [=] (wf::auxilliary_buffer_t& source, const wf::render_buffer_t& dst)
+    {
+        const auto& damage = tracked_output->render->get_post_damage();
+        damage_since_capture |= damage;
+
+        const wf::geometry_t full = {0.0, 0.0, (double)dst.get_size().width, (double)dst.get_size().height};
+        dst.blit(source, full, full, WLR_SCALE_FILTER_NEAREST, &damage);
+
+        if (source.get_buffer() != last_frame)
+        {
+            if (last_frame)
+            {
+                wlr_buffer_unlock(last_frame);
+            }
+
+            last_frame = wlr_buffer_lock(source.get_buffer());
+        }
+    };
+
+    wf::effect_hook_t count_paints = [=] ()
+    {
+        ++nr_paints;
+    };
+
+    void start_tracking()
+    {
+        if (tracked_output)
+        {
+            return;
+        }
+
+        tracked_output = core->output_layout->get_outputs().front();
+        wf::post_hook_options_t options;
+        options.transform_damage = [] (const wf::region_t& damage) { return damage; };
+        tracked_output->render->add_post(&track_damage, options);
+        tracked_output->render->add_effect(&count_paints, wf::OUTPUT_EFFECT_PRE);
+        tracked_output->render->damage_whole();
+    }
+
+    void stop_tracking()
+    {
+        if (!tracked_output)
+        {
+            return;
+        }
+
+        tracked_output->render->rem_post(&track_damage);
+        tracked_output->render->rem_effect(&count_paints);
+        if (last_frame)
+        {
+            wlr_buffer_unlock(last_frame);
+            last_frame = nullptr;
+        }
+
+        tracked_output = nullptr;
+    }
+
+    void capture_output(const std::function<void(const output_frame_t&)>& inspect)
+    {
+        start_tracking();
+
+        // Wait for a repaint cycle, which renders a new frame only if something was damaged.
+        const uint64_t target = nr_paints + 1;
+        tracked_output->render->schedule_redraw();
+        for (int i = 0; i < 50 && nr_paints < target; ++i)
+        {
+            wl_event_loop_dispatch(core->ev_loop, 10);
+            wl_display_flush_clients(core->display);
+        }
+
+        if (!last_frame)
+        {
+            throw std::runtime_error("No output buffer available for capture");
+        }
+
+        output_frame_t frame;
+        frame.width  = last_frame->width;
+        frame.height = last_frame->height;
+        for (auto& box : damage_since_capture)
+        {
+            frame.damage.push_back(wlr_box_from_pixman_box(box));
+        }
+
+        damage_since_capture.clear();
+
+        void *data;
+        uint32_t format;
+        size_t stride;
+        if (wlr_buffer_begin_data_ptr_access(last_frame, WLR_BUFFER_DATA_PTR_ACCESS_READ,
+            &data, &format, &stride))
+        {
+            if (is_mappable_format(format))
+            {
+                frame.data      = (const uint8_t*)data;
+                frame.format    = format;
+                frame.stride    = stride;
+                frame.zero_copy = true;
+                // The buffer must be released even if a check in @inspect throws.
+                std::unique_ptr<wlr_buffer, void (*)(wlr_buffer*)> access{last_frame,
+                    wlr_buffer_end_data_ptr_access};
+                inspect(frame);
+                return;
+            }
+
+            wlr_buffer_end_data_ptr_access(last_frame);
+        }
+
+        bool mapped = with_mapped_dmabuf(last_frame, [&] (const uint8_t *map, uint32_t map_format,
+                                                          size_t map_stride)
+        {
+            frame.data      = map;
+            frame.format    = map_format;
+            frame.stride    = map_stride;
+            frame.zero_copy = true;
+            inspect(frame);
+        });
+
+        if (!mapped)
+        {
+            auto pixels = read_buffer_pixels(core->renderer, last_frame);
+            frame.data   = (const uint8_t*)pixels.data();
+            frame.format = DRM_FORMAT_ABGR8888;
+            frame.stride = frame.width * 4;
+            inspect(frame);
+        }
+    }
 };
 
-wf::test::headless_core_harness_t::headless_core_harness_t(std::string extra_config, bool start_plugins)
+bool wf::test::headless_core_harness_t::gles2_available()
+{
+    auto *renderer = create_gles2_renderer();
+    if (!renderer)
+    {
+        return false;
+    }
+
+    wlr_renderer_destroy(renderer);
+    return true;
+}
+
+wf::test::headless_core_harness_t::headless_core_harness_t(std::string extra_config, bool start_plugins,
+    harness_renderer_t renderer)
 {
     wf::log::initialize_logging(std::cout, wf::log::LOG_LEVEL_DEBUG,
         wf::log::LOG_COLOR_MODE_OFF);
@@ -224,7 +465,8 @@ wf::test::headless_core_harness_t::headless_core_harness_t(std::string extra_con
         throw std::runtime_error("Failed to create headless backend");
     }
 
-    core.renderer = wlr_pixman_renderer_create();
+    core.renderer = (renderer == harness_renderer_t::GLES2) ?
+        create_gles2_renderer() : wlr_pixman_renderer_create();
     if (!core.renderer)
     {
         throw std::runtime_error("Failed to create renderer");
@@ -274,6 +516,7 @@ wf::test::headless_core_harness_t::~headless_core_harness_t()
 {
     if (priv && priv->core)
     {
+        priv->stop_tracking();
         wf::compositor_core_impl_t::deallocate_core();
     }
 
@@ -334,6 +577,27 @@ wf::output_t*wf::test::headless_core_harness_t::output() const
     return outputs.empty() ? nullptr : outputs.front();
 }
 
+wf::output_t*wf::test::headless_core_harness_t::add_output(int width, int height)
+{
+    auto *output_handle = wlr_headless_add_output(priv->core->backend, width, height);
+    if (!output_handle)
+    {
+        throw std::runtime_error("Failed to create headless output");
+    }
+
+    wf::output_t *output = nullptr;
+    if (!run_until([&]
+    {
+        output = priv->core->output_layout->find_output(output_handle);
+        return output != nullptr;
+    }))
+    {
+        throw std::runtime_error("Headless output was not added to the layout");
+    }
+
+    return output;
+}
+
 const std::string& wf::test::headless_core_harness_t::socket_name() const
 {
     return priv->core->wayland_display;
@@ -343,3 +607,9 @@ std::vector<uint32_t> wf::test::headless_core_harness_t::capture_output_pixels()
 {
     return priv->capture_output_pixels();
 }
+
+void wf::test::headless_core_harness_t::capture_output(
+    const std::function<void(const output_frame_t&)>& inspect)
+{
+    priv->capture_output(inspect);
+}
@@ -8,10 +8,47 @@
 
 namespace wf::test
 {
+/**
+ * The contents of the test output, see headless_core_harness_t::capture_output().
+ */
+struct output_frame_t
+{
+    int width  = 0;
+    int height = 0;
+
+    /** Pixel data in @format (a DRM fourcc), rows are @stride bytes apart. */
+    const uint8_t *data = nullptr;
+    uint32_t format     = 0;
+    size_t stride = 0;
+
+    /** Whether @data points directly into the composited frame's buffer, or into a copy of it. */
+    bool zero_copy = false;
+
+    /**
+     * The parts of the output (in buffer coordinates) which may have changed since the previous capture.
+     * The first capture reports the whole output.
+     */
+    std::vector<wlr_box> damage;
+
+    /** Get the pixel at the given position, in the format used by capture_output_pixels(). */
+    uint32_t pixel(int x, int y) const;
+};
+
+/**
+ * The renderer used by the harness. The GLES2 renderer needs a DRM render node, see
+ * headless_core_harness_t::gles2_available().
+ */
+enum class harness_renderer_t
+{
+    PIXMAN,
+    GLES2,
+};
+
 class headless_core_harness_t
 {
   public:
-    explicit headless_core_harness_t(std::string extra_config = {}, bool start_plugins = false);
+    explicit headless_core_harness_t(std::string extra_config = {}, bool start_plugins = false,
+        harness_renderer_t renderer = harness_renderer_t::PIXMAN);
     ~headless_core_harness_t();
 
     headless_core_harness_t(const headless_core_harness_t&) = delete;
@@ -24,9 +61,33 @@ class headless_core_harness_t
     bool run_until(const std::function<bool()>& predicate, int max_iterations = 200);
 
     wf::output_t *output() const;
+
+    /**
+     * Add another headless output with the given size. The output layout places it next to the existing
+     * outputs.
+     */
+    wf::output_t *add_output(int width, int height);
+
+    /**
+     * Check whether a harness with the GLES2 renderer can be created on this machine. Tests which need it
+     * should be skipped otherwise.
+     */
+    static bool gles2_available();
+
     const std::string& socket_name() const;
     std::vector<uint32_t> capture_output_pixels();
 
+    /**
+     * Render a frame (if anything changed) and call @inspect with the contents of the output.
+     *
+     * The frame is read from the buffer the compositor rendered the output into, i.e. the source of the
+     * post-processing hooks, not from the swapchain buffer that is committed to the output. That buffer
+     * always holds the complete frame, whereas swapchain buffers are only partially repainted.
+     * It is mapped directly when the renderer allows it (shm or linear dmabuf buffers), and copied
+     * otherwise. In both cases, the frame data is only valid during the callback.
+     */
+    void capture_output(const std::function<void(const output_frame_t&)>& inspect);
+
   private:
     struct impl;
     std::unique_ptr<impl> priv;
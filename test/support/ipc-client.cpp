@@ -84,6 +84,17 @@ void wf::test::ipc_client_t::close_client()
         close(fd);
         fd = -1;
     }
+
+    if (received_fd >= 0)
+    {
+        close(received_fd);
+        received_fd = -1;
+    }
+}
+
+int wf::test::ipc_client_t::take_received_fd()
+{
+    return std::exchange(received_fd, -1);
 }
 
 void wf::test::ipc_client_t::send(const wf::json_t& message)
@@ -104,8 +115,17 @@ void wf::test::ipc_client_t::send(const wf::json_t& message)
 
 std::optional<wf::json_t> wf::test::ipc_client_t::try_read()
 {
+    // File descriptors arrive with the first byte of the message header.
     uint32_t size;
-    ssize_t r = read(fd, &size, sizeof(size));
+    iovec iov = {.iov_base = &size, .iov_len = sizeof(size)};
+    char control[CMSG_SPACE(sizeof(int))] = {};
+    msghdr msg = {};
+    msg.msg_iov    = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control    = control;
+    msg.msg_controllen = sizeof(control);
+
+    ssize_t r = recvmsg(fd, &msg, MSG_CMSG_CLOEXEC);
     if (r < 0)
     {
         if ((errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR))
@@ -121,6 +141,19 @@ std::optional<wf::json_t> wf::test::ipc_client_t::try_read()
         throw std::runtime_error("IPC socket closed while reading header");
     }
 
+    for (cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg))
+    {
+        if ((cmsg->cmsg_level == SOL_SOCKET) && (cmsg->cmsg_type == SCM_RIGHTS))
+        {
+            if (received_fd >= 0)
+            {
+                close(received_fd);
+            }
+
+            std::memcpy(&received_fd, CMSG_DATA(cmsg), sizeof(int));
+        }
+    }
+
     if (r != sizeof(size))
     {
         throw std::runtime_error("Short IPC header read");
@@ -11,6 +11,7 @@ class headless_core_harness_t;
 class ipc_client_t
 {
     int fd = -1;
+    int received_fd = -1;
 
   public:
     explicit ipc_client_t(const std::string& path);
@@ -24,6 +25,12 @@ class ipc_client_t
     void close_client();
     void send(const wf::json_t& message);
     std::optional<wf::json_t> try_read();
+
+    /**
+     * Take ownership of the file descriptor passed along with the last message read, or -1 if there was
+     * none.
+     */
+    int take_received_fd();
 };
 
 wf::json_t ipc_message(const std::string& method, wf::json_t data = {});
@@ -38,6 +38,12 @@ void wf_test_layer_surface_set_anchor(struct zwlr_layer_surface_v1 *layer_surfac
     zwlr_layer_surface_v1_set_anchor(layer_surface, anchor);
 }
 
+void wf_test_layer_surface_set_exclusive_zone(struct zwlr_layer_surface_v1 *layer_surface,
+    int32_t zone)
+{
+    zwlr_layer_surface_v1_set_exclusive_zone(layer_surface, zone);
+}
+
 void wf_test_layer_surface_set_keyboard_interactivity(
     struct zwlr_layer_surface_v1 *layer_surface,
     uint32_t keyboard_interactivity)
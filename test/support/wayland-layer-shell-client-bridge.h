@@ -30,6 +30,8 @@ void wf_test_layer_surface_set_size(struct zwlr_layer_surface_v1 *layer_surface,
     uint32_t width, uint32_t height);
 void wf_test_layer_surface_set_anchor(struct zwlr_layer_surface_v1 *layer_surface,
     uint32_t anchor);
+void wf_test_layer_surface_set_exclusive_zone(struct zwlr_layer_surface_v1 *layer_surface,
+    int32_t zone);
 void wf_test_layer_surface_set_keyboard_interactivity(
     struct zwlr_layer_surface_v1 *layer_surface,
     uint32_t keyboard_interactivity);
@@ -35,6 +35,7 @@ struct wf::test::wayland_layer_shell_client_t::impl
 
     bool layer_configured = false;
     uint32_t layer_configure_serial = 0;
+    int layer_configure_count = 0;
 
     bool popup_configured = false;
     uint32_t popup_configure_serial = 0;
@@ -89,6 +90,7 @@ struct wf::test::wayland_layer_shell_client_t::impl
         auto *self = static_cast<impl*>(data);
         self->layer_configured = true;
         self->layer_configure_serial = serial;
+        self->layer_configure_count++;
         wf_test_layer_surface_ack_configure(layer_surface, serial);
     }
 
@@ -228,6 +230,27 @@ uint32_t wf::test::wayland_layer_shell_client_t::last_layer_configure_serial() c
     return priv->layer_configure_serial;
 }
 
+int wf::test::wayland_layer_shell_client_t::layer_configure_count() const
+{
+    return priv->layer_configure_count;
+}
+
+void wf::test::wayland_layer_shell_client_t::set_layer_size(int width, int height)
+{
+    wf_test_layer_surface_set_size(priv->shell_layer_surface, width, height);
+}
+
+void wf::test::wayland_layer_shell_client_t::set_exclusive_zone(int zone)
+{
+    wf_test_layer_surface_set_exclusive_zone(priv->shell_layer_surface, zone);
+}
+
+void wf::test::wayland_layer_shell_client_t::commit_layer()
+{
+    wl_surface_commit(priv->layer_surface);
+    wl_display_flush(priv->display);
+}
+
 void wf::test::wayland_layer_shell_client_t::attach_layer_and_commit(int width, int height)
 {
     if (priv->layer_buffer)
@@ -37,7 +37,11 @@ class wayland_layer_shell_client_t
         uint32_t keyboard_interactivity, int width, int height, uint32_t anchor);
     bool has_pending_layer_configure() const;
     uint32_t last_layer_configure_serial() const;
+    int layer_configure_count() const;
     void attach_layer_and_commit(int width, int height);
+    void set_layer_size(int width, int height);
+    void set_exclusive_zone(int zone);
+    void commit_layer();
 
     void create_popup(int width, int height, uint32_t grab_serial = 0);
     bool has_pending_popup_configure() const;
@@ -399,6 +399,18 @@ std::pair<int, int> wf::test::wayland_xdg_client_t::last_committed_buffer_size()
     return priv->committed_buffer_size;
 }
 
+void wf::test::wayland_xdg_client_t::set_title(const std::string& title)
+{
+    xdg_toplevel_set_title(priv->shell_toplevel, title.c_str());
+    wl_display_flush(priv->display);
+}
+
+void wf::test::wayland_xdg_client_t::set_app_id(const std::string& app_id)
+{
+    xdg_toplevel_set_app_id(priv->shell_toplevel, app_id.c_str());
+    wl_display_flush(priv->display);
+}
+
 void wf::test::wayland_xdg_client_t::commit_surface()
 {
     wl_surface_commit(priv->surface);
@@ -35,6 +35,8 @@ class wayland_xdg_client_t
 
     bool has_required_globals() const;
     void create_toplevel(const std::string& title, const std::string& app_id);
+    void set_title(const std::string& title);
+    void set_app_id(const std::string& app_id);
     bool has_pending_configure() const;
     uint32_t last_configure_serial() const;
     std::optional<std::pair<int, int>> last_toplevel_size() const;
@@ -138,3 +138,28 @@ TEST_CASE("Edge cases")
     tx.commit();
     REQUIRE(applied == 1);
 }
+
+TEST_CASE("Objects are added only once and keep their order")
+{
+    setup_wayfire_debugging_state();
+    wf::txn::transaction_t tx(0, [] (uint64_t, wf::wl_timer<false>::callback_t) {});
+
+    std::vector<wf::txn::transaction_object_sptr> objects;
+    for (int i = 0; i < 200; i++)
+    {
+        objects.push_back(std::make_shared<txn_test_object_t>(false));
+    }
+
+    for (int repeat = 0; repeat < 2; repeat++)
+    {
+        for (auto& obj : objects)
+        {
+            tx.add_object(obj);
+        }
+    }
+
+    REQUIRE(tx.get_objects() == objects);
+    REQUIRE(tx.has_object(objects.front()));
+    REQUIRE(tx.has_object(objects.back()));
+    REQUIRE_FALSE(tx.has_object(std::make_shared<txn_test_object_t>(false)));
+}